@@ -56,7 +56,6 @@
 
 #define CONFIG_HOST_INTERFACE_SHI
 #define CONFIG_HOST_COMMAND_STATUS
-#define CONFIG_HOSTCMD_SECTION_SORTED
 #define CONFIG_KEYBOARD_COL2_INVERTED
 #define CONFIG_MKBP_USE_GPIO
 
@@ -33,6 +33,37 @@ static inline void crc32_hash16(uint16_t val)
 	STM32_CRC_DR16 = val;
 }
 
+static inline void crc32_hash8(uint8_t val)
+{
+	/* Byte writes need the input bit order reversed per byte. */
+	STM32_CRC_CR = STM32_CRC_CR_REV_OUT | STM32_CRC_CR_REV_IN_BYTE;
+	STM32_CRC_DR8 = val;
+	STM32_CRC_CR = STM32_CRC_CR_REV_OUT | STM32_CRC_CR_REV_IN_WORD;
+}
+
+/**
+ * Calculate CRC32 of data in arbitrary length.
+ *
+ * The unit takes a word per write, so only the unaligned head and tail of
+ * <buf> are fed byte by byte.
+ *
+ * @param buf   Data for CRC32 to be calculated for.
+ * @param size  Size of <buf> in bytes.
+ */
+static inline void crc32_hash(const void *buf, int size)
+{
+	const uint8_t *p = (const uint8_t *)buf;
+
+	for (; size > 0 && ((uintptr_t)p & 3); size--)
+		crc32_hash8(*p++);
+
+	for (; size >= 4; size -= 4, p += 4)
+		STM32_CRC_DR = *(const uint32_t *)p;
+
+	while (size-- > 0)
+		crc32_hash8(*p++);
+}
+
 static inline uint32_t crc32_result(void)
 {
 	return STM32_CRC_DR ^ 0xFFFFFFFF;
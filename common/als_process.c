@@ -0,0 +1,94 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Shared processing of color light sensor samples */
+
+#include "als_process.h"
+#include "math_util.h"
+#include "util.h"
+
+void als_crgb_update_gains(
+	struct als_crgb_gains *gains,
+	const struct als_channel_scale_t *const scale[COEFF_CHANNEL_COUNT])
+{
+	const struct als_channel_scale_t *s;
+	int i;
+
+	for (i = 0; i < COEFF_CHANNEL_COUNT; i++) {
+		s = scale[i];
+		if (gains->valid &&
+		    gains->scale[i].k_channel_scale == s->k_channel_scale &&
+		    gains->scale[i].cover_scale == s->cover_scale)
+			continue;
+		gains->scale[i] = *s;
+		gains->gain[i] =
+			s->k_channel_scale ?
+				DIV_ROUND_NEAREST((uint64_t)s->cover_scale
+							  << ALS_GAIN_SHIFT,
+						  s->k_channel_scale) :
+				0;
+	}
+	gains->valid = true;
+}
+
+uint32_t als_norm_gain(uint32_t num, uint32_t den)
+{
+	return DIV_ROUND_NEAREST((uint64_t)num << ALS_GAIN_SHIFT, den);
+}
+
+void als_crgb_scale(const struct als_crgb_gains *gains, const uint16_t *raw,
+		    int32_t *crgb)
+{
+	int i;
+
+	for (i = 0; i < COEFF_CHANNEL_COUNT; i++)
+		crgb[i] = ((uint64_t)raw[i] * gains->gain[i]) >> ALS_GAIN_SHIFT;
+}
+
+void als_crgb_normalize(int32_t *crgb, uint32_t norm, int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		crgb[i] = ((int64_t)crgb[i] * norm +
+			   BIT(ALS_GAIN_SHIFT - 1)) >>
+			  ALS_GAIN_SHIFT;
+}
+
+void als_crgb_to_xyz(const struct rgb_calibration_t *cal, uint32_t norm,
+		     int32_t *crgb, int32_t *xyz)
+{
+	const struct rgb_channel_calibration_t *p;
+	int32_t prime[COEFF_CHANNEL_COUNT];
+	int32_t ir;
+	int i;
+
+	als_crgb_normalize(crgb, norm, COEFF_CHANNEL_COUNT);
+
+	/* IR removal */
+	ir = FP_TO_INT(fp_mul(INT_TO_FP(crgb[TCS_RED_COEFF_IDX] +
+					crgb[TCS_GREEN_COEFF_IDX] +
+					crgb[TCS_BLUE_COEFF_IDX] -
+					crgb[TCS_CLEAR_COEFF_IDX]),
+			      cal->irt) /
+		       2);
+	for (i = 0; i < COEFF_CHANNEL_COUNT; i++)
+		prime[i] = MAX(crgb[i] - ir, 0);
+
+	/* if CC == 0, set BC = 0 */
+	if (prime[TCS_CLEAR_COEFF_IDX] == 0)
+		prime[TCS_BLUE_COEFF_IDX] = 0;
+
+	/* regression fit to XYZ space */
+	for (i = 0; i < 3; i++) {
+		p = &cal->rgb_cal[i];
+		xyz[i] = p->offset +
+			 FP_TO_INT((fp_inter_t)p->coeff[0] * prime[0] +
+				   (fp_inter_t)p->coeff[1] * prime[1] +
+				   (fp_inter_t)p->coeff[2] * prime[2] +
+				   (fp_inter_t)p->coeff[3] * prime[3]);
+		xyz[i] = MAX(xyz[i], 0);
+	}
+}
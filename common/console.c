@@ -117,26 +117,41 @@ static int split_words(char *input, int *argc, const char **argv)
  *
  * @return A pointer to the command structure, or NULL if no match found.
  */
-static const struct console_command *find_command(const char *name)
+test_export_static const struct console_command *
+find_command(const char *name)
 {
-	const struct console_command *cmd, *match = NULL;
+	const struct console_command *lo = __cmds, *hi = __cmds_end;
 	int match_length = strlen(name);
 
-	for (cmd = __cmds; cmd < __cmds_end; cmd++) {
-		if (!strncasecmp(name, cmd->name, match_length)) {
-			if (match)
-				return NULL;
-			/*
-			 * Check if 'cmd->name' is of the same length as
-			 * 'name'. If yes, then we have a full match.
-			 */
-			if (cmd->name[match_length] == '\0')
-				return cmd;
-			match = cmd;
-		}
+	/*
+	 * The linker sorts the command table by name, so binary search for
+	 * the first command not less than 'name'. Every command that 'name'
+	 * is a prefix of sits in a contiguous run from there.
+	 */
+	while (lo < hi) {
+		const struct console_command *mid = lo + (hi - lo) / 2;
+
+		if (strncasecmp(mid->name, name, match_length) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
 	}
 
-	return match;
+	if (lo == __cmds_end || strncasecmp(name, lo->name, match_length))
+		return NULL;
+
+	/*
+	 * Check if 'lo->name' is of the same length as 'name'. If yes, then
+	 * we have a full match; it sorts before any longer name it prefixes.
+	 */
+	if (lo->name[match_length] == '\0')
+		return lo;
+
+	/* A partial match must be unique. */
+	if (lo + 1 < __cmds_end && !strncasecmp(name, lo[1].name, match_length))
+		return NULL;
+
+	return lo;
 }
 
 static const char *const errmsgs[] = {
@@ -603,10 +618,10 @@ static int command_help(int argc, const char **argv)
 	const int rows = (ncmds + cols - 1) / cols;
 	int i, j;
 
-#ifdef CONFIG_CONSOLE_CMDHELP
 	if (argc == 2) {
 		const struct console_command *cmd;
 
+#ifdef CONFIG_CONSOLE_CMDHELP
 		if (!strcasecmp(argv[1], "list")) {
 #ifdef CONFIG_CONSOLE_COMMAND_FLAGS
 			ccputs("Command     Flags   Description\n");
@@ -626,19 +641,24 @@ static int command_help(int argc, const char **argv)
 			ccputs("HELP CMD = help on CMD.\n");
 			return EC_SUCCESS;
 		}
+#endif
+		/* Same lookup as running the command, prefixes included */
 		cmd = find_command(argv[1]);
 		if (!cmd) {
 			ccprintf("Command '%s' not found or ambiguous.\n",
 				 argv[1]);
 			return EC_ERROR_UNKNOWN;
 		}
+#ifdef CONFIG_CONSOLE_CMDHELP
 		ccprintf("Usage: %s %s\n", cmd->name,
 			 (cmd->argdesc ? cmd->argdesc : ""));
 		if (cmd->help)
 			ccprintf("%s\n", cmd->help);
+#else
+		ccprintf("%s\n", cmd->name);
+#endif
 		return EC_SUCCESS;
 	}
-#endif
 
 	ccputs("Known commands:\n");
 	for (i = 0; i < rows; i++) {
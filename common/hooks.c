@@ -9,6 +9,7 @@
 #include "console.h"
 #include "hooks.h"
 #include "link_defs.h"
+#include "task.h"
 #include "timer.h"
 #include "util.h"
 
@@ -22,6 +23,18 @@
 
 #define DEFERRED_FUNCS_COUNT (__deferred_funcs_end - __deferred_funcs)
 
+/*
+ * Pending deferred functions form a binary min-heap keyed by
+ * __deferred_until[], so the next deadline is always at the top. The first
+ * DEFERRED_FUNCS_COUNT entries of the linker-reserved __deferred_heap hold the
+ * deferred function index of each heap node, the following ones hold the heap
+ * position + 1 of each deferred function (0 when it is not pending).
+ *
+ * The heap must only be accessed with interrupts disabled.
+ */
+#define deferred_heap (__deferred_heap)
+#define deferred_heap_pos (__deferred_heap + DEFERRED_FUNCS_COUNT)
+
 struct hook_ptrs {
 	const struct hook_data *start;
 	const struct hook_data *end;
@@ -73,6 +86,12 @@ static const struct hook_ptrs hook_list[] = {
 /* Times for deferrable functions */
 static int hook_task_started;
 
+/* Whether __hooks_order has been filled in */
+static bool hooks_sorted;
+
+/* Number of pending deferred functions in the heap */
+static int deferred_heap_size;
+
 #ifdef CONFIG_HOOK_DEBUG
 /* Stats for hooks */
 static uint64_t max_hook_tick_delay;
@@ -83,15 +102,39 @@ static uint64_t avg_hook_tick_delay;
 static uint64_t avg_hook_second_delay;
 static uint64_t avg_hook_run_time[ARRAY_SIZE(hook_list)];
 
+/* Time spent with interrupts disabled to schedule deferred functions */
+static uint64_t max_deferred_irq_off_time;
+static uint64_t avg_deferred_irq_off_time;
+
 static inline void update_hook_average(uint64_t *avg, uint64_t time)
 {
 	*avg = (*avg * 7 + time) >> 3;
 }
 
+static void record_hook_run_time(const struct hook_data *hook, uint32_t time)
+{
+	struct hook_stats *stats = __hooks_stats + (hook - __hooks_init);
+
+	if (time > stats->max_run_time)
+		stats->max_run_time = time;
+	stats->avg_run_time = (stats->avg_run_time * 7 + time) >> 3;
+}
+
+static void record_irq_off_time(uint64_t start)
+{
+	uint64_t irq_off_time = get_time().val - start;
+
+	if (irq_off_time > max_deferred_irq_off_time)
+		max_deferred_irq_off_time = irq_off_time;
+	update_hook_average(&avg_deferred_irq_off_time, irq_off_time);
+}
+
 static void record_hook_delay(uint64_t now, uint64_t last, uint64_t interval,
-			      uint64_t *max_delay, uint64_t *avg_delay)
+			      int jitter, uint64_t *max_delay,
+			      uint64_t *avg_delay)
 {
 	uint64_t delayed = now - last - interval;
+	uint64_t allowed = MAX(jitter, 0);
 	/* Ignore the first call */
 	if (last == -interval)
 		return;
@@ -100,45 +143,71 @@ static void record_hook_delay(uint64_t now, uint64_t last, uint64_t interval,
 		*max_delay = delayed;
 	update_hook_average(avg_delay, delayed);
 
-	/* Warn if delayed by more than 10% */
-	if (delayed * 10 > interval)
+	/* Warn if delayed by more than 10% past the allowed jitter */
+	if (delayed > allowed && (delayed - allowed) * 10 > interval)
 		CPRINTS("Hook at interval %d us delayed by %d us",
 			(uint32_t)interval, (uint32_t)delayed);
 }
 #endif
 
+/*
+ * Hook priorities are arbitrary expressions, so the linker cannot order the
+ * hook sections by priority. Instead, sort the index of every hook within its
+ * type once, on the first notification (from main(), before tasks run), so
+ * each hook_notify() is a single pass.
+ */
+static void sort_hooks(void)
+{
+	int type, i, j;
+
+	for (type = 0; type < ARRAY_SIZE(hook_list); type++) {
+		const struct hook_data *start = hook_list[type].start;
+		uint16_t *order = __hooks_order + (start - __hooks_init);
+		int count = hook_list[type].end - start;
+
+		/* Insertion sort keeps link order for equal priorities */
+		for (i = 0; i < count; i++) {
+			for (j = i; j > 0 && start[order[j - 1]].priority >
+						     start[i].priority;
+			     j--)
+				order[j] = order[j - 1];
+			order[j] = i;
+		}
+	}
+
+	hooks_sorted = true;
+}
+
 void hook_notify(enum hook_type type)
 {
-	const struct hook_data *start, *end, *p;
-	int count, called = 0;
-	int last_prio = HOOK_PRIO_FIRST - 1, prio;
+	const struct hook_data *start, *p;
+	const uint16_t *order;
+	int count, i;
 #ifdef CONFIG_HOOK_DEBUG
 	uint64_t start_time = get_time().val;
+	uint64_t hook_start_time;
 	uint64_t run_time;
 #endif
 
 	CPRINTS("hook notify %d", type);
 
+	if (!hooks_sorted)
+		sort_hooks();
+
 	start = hook_list[type].start;
-	end = hook_list[type].end;
-	count = end - start;
+	order = __hooks_order + (start - __hooks_init);
+	count = hook_list[type].end - start;
 
 	/* Call all the hooks in priority order */
-	while (called < count) {
-		/* Find the lowest remaining priority */
-		for (p = start, prio = HOOK_PRIO_LAST + 1; p < end; p++) {
-			if (p->priority < prio && p->priority > last_prio)
-				prio = p->priority;
-		}
-		last_prio = prio;
-
-		/* Call all the hooks with that priority */
-		for (p = start; p < end; p++) {
-			if (p->priority == prio) {
-				called++;
-				p->routine();
-			}
-		}
+	for (i = 0; i < count; i++) {
+		p = start + order[i];
+#ifdef CONFIG_HOOK_DEBUG
+		hook_start_time = get_time().val;
+#endif
+		p->routine();
+#ifdef CONFIG_HOOK_DEBUG
+		record_hook_run_time(p, get_time().val - hook_start_time);
+#endif
 	}
 
 #ifdef CONFIG_HOOK_DEBUG
@@ -149,39 +218,176 @@ void hook_notify(enum hook_type type)
 #endif
 }
 
+static void deferred_heap_set(int pos, int i)
+{
+	deferred_heap[pos] = i;
+	deferred_heap_pos[i] = pos + 1;
+}
+
+static void deferred_heap_sift_up(int pos)
+{
+	int i = deferred_heap[pos];
+
+	while (pos > 0) {
+		int parent = (pos - 1) / 2;
+
+		if (__deferred_until[deferred_heap[parent]] <=
+		    __deferred_until[i])
+			break;
+		deferred_heap_set(pos, deferred_heap[parent]);
+		pos = parent;
+	}
+	deferred_heap_set(pos, i);
+}
+
+static void deferred_heap_sift_down(int pos)
+{
+	int i = deferred_heap[pos];
+
+	while (1) {
+		int child = 2 * pos + 1;
+
+		if (child >= deferred_heap_size)
+			break;
+		if (child + 1 < deferred_heap_size &&
+		    __deferred_until[deferred_heap[child + 1]] <
+			    __deferred_until[deferred_heap[child]])
+			child++;
+		if (__deferred_until[i] <= __deferred_until[deferred_heap[child]])
+			break;
+		deferred_heap_set(pos, deferred_heap[child]);
+		pos = child;
+	}
+	deferred_heap_set(pos, i);
+}
+
+/* Move deferred function <i> to its place after __deferred_until[i] changed */
+static void deferred_heap_update(int i)
+{
+	int pos = deferred_heap_pos[i] - 1;
+
+	if (pos < 0) {
+		pos = deferred_heap_size++;
+		deferred_heap_set(pos, i);
+	}
+	deferred_heap_sift_up(pos);
+	deferred_heap_sift_down(deferred_heap_pos[i] - 1);
+}
+
+static void deferred_heap_remove(int i)
+{
+	int pos = deferred_heap_pos[i] - 1;
+	int last;
+
+	if (pos < 0)
+		return;
+
+	deferred_heap_pos[i] = 0;
+	last = deferred_heap[--deferred_heap_size];
+	if (pos == deferred_heap_size)
+		return;
+
+	deferred_heap_set(pos, last);
+	deferred_heap_sift_up(pos);
+	deferred_heap_sift_down(deferred_heap_pos[last] - 1);
+}
+
 int hook_call_deferred(const struct deferred_data *data, int us)
 {
 	int i = data - __deferred_funcs;
+	uint32_t key;
+#ifdef CONFIG_HOOK_DEBUG
+	uint64_t irq_off_start;
+#endif
 
 	if (data < __deferred_funcs || data >= __deferred_funcs_end)
 		return EC_ERROR_INVAL; /* Routine not registered */
 
+	key = irq_lock();
+#ifdef CONFIG_HOOK_DEBUG
+	irq_off_start = get_time().val;
+#endif
 	if (us == -1) {
 		/* Cancel */
 		__deferred_until[i] = 0;
+		deferred_heap_remove(i);
 	} else {
 		/* Set alarm */
 		__deferred_until[i] = get_time().val + us;
-
-		/* Wake task so it can re-sleep for the proper time */
-		if (hook_task_started)
-			task_wake(TASK_ID_HOOKS);
+		deferred_heap_update(i);
 	}
+#ifdef CONFIG_HOOK_DEBUG
+	record_irq_off_time(irq_off_start);
+#endif
+	irq_unlock(key);
+
+	/* Wake task so it can re-sleep for the proper time */
+	if (us != -1 && hook_task_started)
+		task_wake(TASK_ID_HOOKS);
 
 	return EC_SUCCESS;
 }
 
+/*
+ * How late (us) the routines of a periodic hook type allow it to run, or -1 if
+ * the type has no routines and so never needs to wake up the hook task.
+ */
+static int periodic_hook_jitter(enum hook_type type)
+{
+	const struct hook_data *p;
+	int jitter = -1;
+
+	if (!IS_ENABLED(CONFIG_HOOK_TICKLESS))
+		return 0;
+
+	for (p = hook_list[type].start; p < hook_list[type].end; p++) {
+		if (jitter < 0 || p->jitter_ms * MSEC < jitter)
+			jitter = p->jitter_ms * MSEC;
+	}
+
+	return jitter;
+}
+
+/*
+ * Time (us) from <t> until a periodic hook type last run at <last> must run
+ * again, or -1 if it never needs to wake up the hook task.
+ */
+static int periodic_hook_timeout(uint64_t t, uint64_t last, uint64_t interval,
+				 int jitter)
+{
+	uint64_t deadline = last + interval + jitter;
+
+	if (jitter < 0)
+		return -1;
+
+	return deadline > t ? deadline - t : 0;
+}
+
+/* Earliest of two timeouts, where -1 means no timeout */
+static int min_timeout(int a, int b)
+{
+	if (a < 0)
+		return b;
+	if (b < 0)
+		return a;
+	return MIN(a, b);
+}
+
 void hook_task(void *u)
 {
 	/* Periodic hooks will be called first time through the loop */
 	static uint64_t last_second = -SECOND;
 	static uint64_t last_tick = -HOOK_TICK_INTERVAL;
+	int tick_jitter, second_jitter;
 
 	hook_task_started = 1;
 
 	/* Call HOOK_INIT hooks. */
 	hook_notify(HOOK_INIT);
 
+	tick_jitter = periodic_hook_jitter(HOOK_TICK);
+	second_jitter = periodic_hook_jitter(HOOK_SECOND);
+
 	/* Now, enable the rest of the tasks. */
 	task_enable_all_tasks();
 
@@ -189,29 +395,45 @@ void hook_task(void *u)
 		uint64_t t = get_time().val;
 		int next = 0;
 		int i;
+#ifdef CONFIG_HOOK_DEBUG
+		uint64_t irq_off_start;
+#endif
 
 		interrupt_disable();
-		/* Handle deferred routines */
-		for (i = 0; i < DEFERRED_FUNCS_COUNT; i++) {
-			if (__deferred_until[i] && __deferred_until[i] < t) {
-				/*
-				 * Call deferred function.  Clear timer first,
-				 * so it can request itself be called later.
-				 */
-				__deferred_until[i] = 0;
-				interrupt_enable();
-				CPRINTS("hook call deferred 0x%p",
-					__deferred_funcs[i].routine);
-				__deferred_funcs[i].routine();
-				interrupt_disable();
-			}
+#ifdef CONFIG_HOOK_DEBUG
+		irq_off_start = get_time().val;
+#endif
+		/* Handle expired deferred routines, earliest first */
+		while (deferred_heap_size &&
+		       __deferred_until[deferred_heap[0]] < t) {
+			i = deferred_heap[0];
+			/*
+			 * Call deferred function.  Clear timer first,
+			 * so it can request itself be called later.
+			 */
+			__deferred_until[i] = 0;
+			deferred_heap_remove(i);
+#ifdef CONFIG_HOOK_DEBUG
+			record_irq_off_time(irq_off_start);
+#endif
+			interrupt_enable();
+			CPRINTS("hook call deferred 0x%p",
+				__deferred_funcs[i].routine);
+			__deferred_funcs[i].routine();
+			interrupt_disable();
+#ifdef CONFIG_HOOK_DEBUG
+			irq_off_start = get_time().val;
+#endif
 		}
-
+#ifdef CONFIG_HOOK_DEBUG
+		record_irq_off_time(irq_off_start);
+#endif
 		interrupt_enable();
+
 		if (t - last_tick >= HOOK_TICK_INTERVAL) {
 #ifdef CONFIG_HOOK_DEBUG
 			record_hook_delay(t, last_tick, HOOK_TICK_INTERVAL,
-					  &max_hook_tick_delay,
+					  tick_jitter, &max_hook_tick_delay,
 					  &avg_hook_tick_delay);
 #endif
 			hook_notify(HOOK_TICK);
@@ -221,36 +443,50 @@ void hook_task(void *u)
 		if (t - last_second >= SECOND) {
 #ifdef CONFIG_HOOK_DEBUG
 			record_hook_delay(t, last_second, SECOND,
-					  &max_hook_second_delay,
+					  second_jitter, &max_hook_second_delay,
 					  &avg_hook_second_delay);
 #endif
 			hook_notify(HOOK_SECOND);
 			last_second = t;
 		}
 
-		/* Calculate when next tick needs to occur */
+		/*
+		 * Calculate when next tick needs to occur. Without
+		 * CONFIG_HOOK_TICKLESS the tick interval divides a second, so
+		 * waking up for the tick also covers HOOK_SECOND.
+		 */
 		t = get_time().val;
-		if (last_tick + HOOK_TICK_INTERVAL > t)
-			next = last_tick + HOOK_TICK_INTERVAL - t;
-
+		next = periodic_hook_timeout(t, last_tick, HOOK_TICK_INTERVAL,
+					     tick_jitter);
+		if (IS_ENABLED(CONFIG_HOOK_TICKLESS))
+			next = min_timeout(next,
+					   periodic_hook_timeout(t, last_second,
+								 SECOND,
+								 second_jitter));
+
+		/* The earliest deferred routine is at the top of the heap */
 		interrupt_disable();
-		for (i = 0; i < DEFERRED_FUNCS_COUNT && next > 0; i++) {
-			if (!__deferred_until[i])
-				continue;
+#ifdef CONFIG_HOOK_DEBUG
+		irq_off_start = get_time().val;
+#endif
+		if (deferred_heap_size && next != 0) {
+			uint64_t until = __deferred_until[deferred_heap[0]];
 
-			if (__deferred_until[i] < t)
+			if (until < t)
 				next = 0;
-			else if (__deferred_until[i] - t < next)
-				next = __deferred_until[i] - t;
+			else
+				next = min_timeout(next, until - t);
 		}
-
+#ifdef CONFIG_HOOK_DEBUG
+		record_irq_off_time(irq_off_start);
+#endif
 		interrupt_enable();
 
 		/*
 		 * If nothing is immediately pending, sleep until the next
-		 * event.
+		 * event (or until woken up, if there is no deadline).
 		 */
-		if (next > 0)
+		if (next != 0)
 			task_wait_event(next);
 	}
 }
@@ -280,12 +516,31 @@ static int command_stats(int argc, const char **argv)
 	ccprintf("HOOK_SECOND:\n");
 	print_hook_delay(SECOND, max_hook_second_delay, avg_hook_second_delay);
 
+	ccprintf("Deferred scheduling with interrupts off:\n");
+	ccprintf("  Max:     %7d us\n", (uint32_t)max_deferred_irq_off_time);
+	ccprintf("  Average: %7d us\n\n", (uint32_t)avg_deferred_irq_off_time);
+
 	ccprintf("Max run time for each hook:\n");
-	for (i = 0; i < ARRAY_SIZE(hook_list); ++i)
+	for (i = 0; i < ARRAY_SIZE(hook_list); ++i) {
+		const struct hook_data *p;
+
 		ccprintf("%3d:%6d us (Avg: %5d us)\n", i,
 			 (uint32_t)max_hook_run_time[i],
 			 (uint32_t)avg_hook_run_time[i]);
 
+		/* Break the total down per hook routine that has run */
+		for (p = hook_list[i].start; p < hook_list[i].end; p++) {
+			const struct hook_stats *stats =
+				__hooks_stats + (p - __hooks_init);
+
+			if (!stats->max_run_time)
+				continue;
+			ccprintf("    0x%p:%6d us (Avg: %5d us)\n", p->routine,
+				 stats->max_run_time, stats->avg_run_time);
+		}
+		cflush();
+	}
+
 	return EC_SUCCESS;
 }
 DECLARE_CONSOLE_COMMAND(hookstats, command_stats, NULL, "Print stats of hooks");
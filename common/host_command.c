@@ -189,6 +189,119 @@ host_command_get_features(struct host_cmd_handler_args *args)
 DECLARE_HOST_COMMAND(EC_CMD_GET_FEATURES, host_command_get_features,
 		     EC_VER_MASK(0));
 
+#ifdef CONFIG_HOSTCMD_BATCH
+/*
+ * Commands which can't run as part of a batch, because they reboot or send
+ * their response before completing (see host_send_response()).
+ */
+static const uint16_t batch_denied_cmds[] = {
+	EC_CMD_BATCH,
+	EC_CMD_FLASH_ERASE,
+	EC_CMD_REBOOT,
+	EC_CMD_REBOOT_EC,
+	EC_CMD_RESEND_RESPONSE,
+};
+
+static bool batch_cmd_denied(uint16_t command)
+{
+	for (int i = 0; i < ARRAY_SIZE(batch_denied_cmds); i++) {
+		if (batch_denied_cmds[i] == command)
+			return true;
+	}
+
+	return false;
+}
+
+/* Check that the sub-commands exactly fill the params. */
+static bool batch_params_valid(const uint8_t *params, size_t size,
+			       int num_cmds)
+{
+	size_t offset = sizeof(struct ec_params_batch);
+
+	for (int i = 0; i < num_cmds; i++) {
+		const struct ec_params_batch_cmd *cmd =
+			(const struct ec_params_batch_cmd *)(params + offset);
+
+		if (offset + sizeof(*cmd) > size)
+			return false;
+		offset += sizeof(*cmd) + EC_BATCH_ALIGN(cmd->params_size);
+		if (offset > size)
+			return false;
+	}
+
+	return offset == size;
+}
+
+static enum ec_status host_command_batch(struct host_cmd_handler_args *args)
+{
+	const struct ec_params_batch *p = args->params;
+	const uint8_t *params = args->params;
+	struct ec_response_batch *r = args->response;
+	uint8_t *response = args->response;
+	size_t in = sizeof(*p);
+	size_t out = sizeof(*r);
+	int num_done = 0;
+
+	if (args->params_size < sizeof(*p) ||
+	    args->response_max < sizeof(*r) ||
+	    !batch_params_valid(params, args->params_size, p->num_cmds))
+		return EC_RES_INVALID_PARAM;
+
+	/*
+	 * Params and response never overlap here: transports sharing a buffer
+	 * copy the request to request_temp (see host_packet_receive()).
+	 */
+	while (num_done < p->num_cmds) {
+		const struct ec_params_batch_cmd *cmd =
+			(const struct ec_params_batch_cmd *)(params + in);
+		struct ec_response_batch_cmd *resp =
+			(struct ec_response_batch_cmd *)(response + out);
+		struct host_cmd_handler_args sub = *args;
+		size_t space = args->response_max - out;
+
+		/* Stop if the worst case response may not fit. */
+		if (space < sizeof(*resp) + EC_BATCH_ALIGN(cmd->response_max))
+			break;
+
+		sub.command = cmd->command;
+		sub.version = cmd->version;
+		sub.params = params + in + sizeof(*cmd);
+		sub.params_size = cmd->params_size;
+		sub.response = response + out + sizeof(*resp);
+		sub.response_max = cmd->response_max;
+		sub.response_size = 0;
+
+		if (batch_cmd_denied(sub.command))
+			resp->result = EC_RES_INVALID_COMMAND;
+		else
+			resp->result = host_command_process(&sub);
+		resp->response_size = resp->result == EC_RES_SUCCESS ?
+					      sub.response_size :
+					      0;
+
+		/* Don't leak stale buffer contents through the padding. */
+		memset((uint8_t *)sub.response + resp->response_size, 0,
+		       EC_BATCH_ALIGN(resp->response_size) -
+			       resp->response_size);
+
+		in += sizeof(*cmd) + EC_BATCH_ALIGN(cmd->params_size);
+		out += sizeof(*resp) + EC_BATCH_ALIGN(resp->response_size);
+		num_done++;
+
+		if (resp->result != EC_RES_SUCCESS &&
+		    (p->flags & EC_BATCH_FLAG_STOP_ON_ERROR))
+			break;
+	}
+
+	memset(r, 0, sizeof(*r));
+	r->num_done = num_done;
+	args->response_size = out;
+
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(EC_CMD_BATCH, host_command_batch, EC_VER_MASK(0));
+#endif /* CONFIG_HOSTCMD_BATCH */
+
 /*****************************************************************************/
 /* Console commands */
 
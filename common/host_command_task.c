@@ -331,6 +331,28 @@ host_packet_bad:
 	host_packet_respond(&args0);
 }
 
+const struct host_command *
+host_command_find_sorted(const struct host_command *table, size_t count,
+			 int command)
+{
+	size_t l = 0;
+	size_t r = count;
+
+	/* Binary search over the half-open interval [l, r) */
+	while (l < r) {
+		size_t m = l + (r - l) / 2;
+
+		if (table[m].command < command)
+			l = m + 1;
+		else if (table[m].command > command)
+			r = m;
+		else
+			return &table[m];
+	}
+
+	return NULL;
+}
+
 const struct host_command *find_host_command(int command)
 {
 	if (IS_ENABLED(CONFIG_SYSTEM_SAFE_MODE) && system_is_in_safe_mode()) {
@@ -340,27 +362,8 @@ const struct host_command *find_host_command(int command)
 	if (IS_ENABLED(CONFIG_ZEPHYR)) {
 		return zephyr_find_host_command(command);
 	} else if (IS_ENABLED(CONFIG_HOSTCMD_SECTION_SORTED)) {
-		const struct host_command *l, *r, *m;
-		uint32_t num;
-
-		/* Use binary search to locate host command handler */
-		l = __hcmds;
-		r = __hcmds_end - 1;
-
-		while (1) {
-			if (l > r)
-				return NULL;
-
-			num = r - l;
-			m = l + (num / 2);
-
-			if (m->command < command)
-				l = m + 1;
-			else if (m->command > command)
-				r = m - 1;
-			else
-				return m;
-		}
+		return host_command_find_sorted(__hcmds, __hcmds_end - __hcmds,
+						command);
 	} else {
 		const struct host_command *cmd;
 
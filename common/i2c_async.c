@@ -0,0 +1,169 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Asynchronous I2C transfers */
+
+#include "common.h"
+#include "hooks.h"
+#include "i2c.h"
+#include "task.h"
+#include "util.h"
+
+#ifdef CONFIG_ZEPHYR
+#include "i2c/i2c.h"
+
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#endif /* CONFIG_ZEPHYR */
+
+/*
+ * Transfers queued for all the ports, in submission order. Taking the
+ * transfers of one port in list order gives that port's queue. The list is
+ * changed from any context, so it is protected by a short critical section.
+ */
+static struct i2c_xfer_desc *queue_head;
+static struct i2c_xfer_desc *queue_tail;
+
+/* Remove the oldest transfer queued for a port, or return NULL. */
+static struct i2c_xfer_desc *dequeue_port(int port)
+{
+	struct i2c_xfer_desc *desc, *prev = NULL;
+	uint32_t lock_key;
+
+	lock_key = irq_lock();
+	for (desc = queue_head; desc; prev = desc, desc = desc->next) {
+		if (desc->port != port)
+			continue;
+		if (prev)
+			prev->next = desc->next;
+		else
+			queue_head = desc->next;
+		if (queue_tail == desc)
+			queue_tail = prev;
+		desc->next = NULL;
+		break;
+	}
+	irq_unlock(lock_key);
+
+	return desc;
+}
+
+/* Run a transfer on the bus, then report that it is done. */
+static void i2c_xfer_async_one(struct i2c_xfer_desc *desc)
+{
+	const int port = desc->port;
+
+	i2c_lock(port, 1);
+	desc->state = I2C_XFER_RUNNING;
+	desc->result = i2c_xfer_unlocked(port, desc->addr_flags, desc->out,
+					 desc->out_size, desc->in,
+					 desc->in_size, I2C_XFER_SINGLE);
+	i2c_lock(port, 0);
+
+	/* The callback may submit the descriptor again. */
+	desc->state = I2C_XFER_DONE;
+	if (desc->done)
+		desc->done(desc);
+	else if (desc->event)
+		task_set_event(desc->task, desc->event);
+}
+
+#ifdef CONFIG_ZEPHYR
+/*
+ * Each port drains its queue from its own work queue thread, so the ports
+ * run their transfers in parallel, and a transfer waiting for its bus does
+ * not hold up the hooks and deferred calls.
+ */
+static K_THREAD_STACK_ARRAY_DEFINE(
+	async_stacks, I2C_PORT_COUNT,
+	CONFIG_PLATFORM_EC_I2C_XFER_ASYNC_STACK_SIZE);
+static struct k_work_q async_work_q[I2C_PORT_COUNT];
+static struct k_work async_work[I2C_PORT_COUNT];
+
+static void i2c_xfer_async_work(struct k_work *work)
+{
+	const int port = work - async_work;
+	struct i2c_xfer_desc *desc;
+
+	while ((desc = dequeue_port(port)) != NULL)
+		i2c_xfer_async_one(desc);
+}
+
+static int i2c_xfer_async_init(void)
+{
+	for (int port = 0; port < I2C_PORT_COUNT; port++) {
+		k_work_queue_start(&async_work_q[port], async_stacks[port],
+				   K_THREAD_STACK_SIZEOF(async_stacks[port]),
+				   CONFIG_SYSTEM_WORKQUEUE_PRIORITY, NULL);
+		k_work_init(&async_work[port], i2c_xfer_async_work);
+	}
+
+	return 0;
+}
+SYS_INIT(i2c_xfer_async_init, POST_KERNEL, 51);
+
+static void i2c_xfer_async_kick(int port)
+{
+	k_work_submit_to_queue(&async_work_q[port], &async_work[port]);
+}
+#else
+static void i2c_xfer_async_run(void);
+DECLARE_DEFERRED(i2c_xfer_async_run);
+
+/*
+ * Without a context per port, the hook task runs the oldest transfer of all
+ * the ports, one per deferred call, so other hooks and deferred calls run in
+ * between the transfers.
+ */
+static void i2c_xfer_async_run(void)
+{
+	struct i2c_xfer_desc *desc = queue_head;
+
+	/* Only this function removes transfers, the head stays the oldest. */
+	if (desc == NULL)
+		return;
+	i2c_xfer_async_one(dequeue_port(desc->port));
+
+	if (queue_head)
+		hook_call_deferred(&i2c_xfer_async_run_data, 0);
+}
+
+static void i2c_xfer_async_kick(int port)
+{
+	hook_call_deferred(&i2c_xfer_async_run_data, 0);
+}
+#endif /* CONFIG_ZEPHYR */
+
+int i2c_xfer_submit(struct i2c_xfer_desc *desc)
+{
+	const int port = desc->port;
+	uint32_t lock_key;
+
+#ifdef CONFIG_ZEPHYR
+	if (port < 0 || port >= I2C_PORT_COUNT)
+		return EC_ERROR_INVAL;
+#else
+	if (get_i2c_port(port) == NULL)
+		return EC_ERROR_INVAL;
+#endif
+
+	lock_key = irq_lock();
+	if (desc->state == I2C_XFER_QUEUED || desc->state == I2C_XFER_RUNNING) {
+		irq_unlock(lock_key);
+		return EC_ERROR_BUSY;
+	}
+	desc->state = I2C_XFER_QUEUED;
+	desc->next = NULL;
+	if (queue_tail)
+		queue_tail->next = desc;
+	else
+		queue_head = desc;
+	queue_tail = desc;
+	irq_unlock(lock_key);
+
+	i2c_xfer_async_kick(port);
+
+	return EC_SUCCESS;
+}
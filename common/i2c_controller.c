@@ -12,9 +12,11 @@
 #include "i2c.h"
 #include "i2c_bitbang.h"
 #include "i2c_private.h"
+#include "i2c_regcache.h"
 #include "printf.h"
 #include "system.h"
 #include "task.h"
+#include "timer.h"
 #include "util.h"
 
 #ifdef CONFIG_ZEPHYR
@@ -108,10 +110,14 @@ __maybe_unused static int chip_i2c_xfer_with_notify(const int port,
 	int ret;
 	uint16_t no_pec_af = addr_flags;
 	const struct i2c_port_t *i2c_port = get_i2c_port(port);
+	uint32_t start_us = 0;
 
 	if (i2c_port == NULL)
 		return EC_ERROR_INVAL;
 
+	if (IS_ENABLED(CONFIG_I2C_DEBUG))
+		start_us = get_time().le.lo;
+
 	if (IS_ENABLED(CONFIG_I2C_XFER_BOARD_CALLBACK))
 		i2c_start_xfer_notify(port, addr_flags);
 
@@ -134,7 +140,7 @@ __maybe_unused static int chip_i2c_xfer_with_notify(const int port,
 
 	if (IS_ENABLED(CONFIG_I2C_DEBUG)) {
 		i2c_trace_notify(port, addr_flags, out, out_size, in, in_size,
-				 ret);
+				 ret, start_us);
 	}
 
 	return ret;
@@ -185,13 +191,20 @@ static int i2c_xfer_no_retry(const int port, const uint16_t addr_flags,
 }
 #endif /* CONFIG_I2C_XFER_LARGE_TRANSFER */
 
-int i2c_xfer_unlocked(const int port, const uint16_t addr_flags,
-		      const uint8_t *out, int out_size, uint8_t *in,
-		      int in_size, int flags)
+/*
+ * Run a transfer, retrying it as needed. Count the attempts and, on Zephyr,
+ * the attempts not acknowledged by the peripheral. Legacy chip drivers
+ * report a missing acknowledge as a generic error, so their failures are
+ * only counted as errors.
+ */
+static int i2c_xfer_retry(const int port, const uint16_t addr_flags,
+			  const uint8_t *out, int out_size, uint8_t *in,
+			  int in_size, int flags, int *attempts, int *nacks)
 {
 	int i;
 	int ret = EC_SUCCESS;
 	uint16_t no_pec_af = addr_flags & ~I2C_FLAG_PEC;
+	__maybe_unused uint32_t start_us = 0;
 
 	if (!i2c_port_is_locked(port)) {
 		CPUTS("Access I2C without lock!");
@@ -199,6 +212,7 @@ int i2c_xfer_unlocked(const int port, const uint16_t addr_flags,
 	}
 
 	for (i = 0; i <= CONFIG_I2C_NACK_RETRY_COUNT; i++) {
+		(*attempts)++;
 #ifdef CONFIG_ZEPHYR
 		struct i2c_msg msg[2];
 		int num_msgs = 0;
@@ -242,18 +256,21 @@ int i2c_xfer_unlocked(const int port, const uint16_t addr_flags,
 			CPRINTF("Ignoring flags from i2c addr_flags: %04x",
 				no_pec_af);
 
+		if (IS_ENABLED(CONFIG_I2C_DEBUG))
+			start_us = get_time().le.lo;
 		ret = i2c_transfer(i2c_get_device_for_port(port), msg, num_msgs,
 				   I2C_STRIP_FLAGS(no_pec_af));
 
 		if (IS_ENABLED(CONFIG_I2C_DEBUG)) {
 			i2c_trace_notify(port, addr_flags, out, out_size, in,
-					 in_size, ret);
+					 in_size, ret, start_us);
 		}
 
 		switch (ret) {
 		case 0:
 			return EC_SUCCESS;
 		case -EIO:
+			(*nacks)++;
 			ret = EC_ERROR_INVAL;
 			continue;
 		default:
@@ -272,6 +289,27 @@ int i2c_xfer_unlocked(const int port, const uint16_t addr_flags,
 	return ret;
 }
 
+int i2c_xfer_unlocked(const int port, const uint16_t addr_flags,
+		      const uint8_t *out, int out_size, uint8_t *in,
+		      int in_size, int flags)
+{
+	int attempts = 0, nacks = 0;
+	uint32_t start_us;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_I2C_STATS))
+		return i2c_xfer_retry(port, addr_flags, out, out_size, in,
+				      in_size, flags, &attempts, &nacks);
+
+	start_us = get_time().le.lo;
+	ret = i2c_xfer_retry(port, addr_flags, out, out_size, in, in_size,
+			     flags, &attempts, &nacks);
+	i2c_stats_xfer(port, addr_flags, out_size, in_size, ret,
+		       get_time().le.lo - start_us, attempts, nacks);
+
+	return ret;
+}
+
 int i2c_xfer(const int port, const uint16_t addr_flags, const uint8_t *out,
 	     int out_size, uint8_t *in, int in_size)
 {
@@ -285,8 +323,125 @@ int i2c_xfer(const int port, const uint16_t addr_flags, const uint8_t *out,
 	return rv;
 }
 
+#ifdef CONFIG_ZEPHYR
+/* Run a scatter-gather transfer, counting the attempts as i2c_xfer_retry(). */
+static int i2c_xfer_vec_retry(const int port, const uint16_t addr_flags,
+			      const struct i2c_xfer_seg *segs, int count,
+			      int *attempts, int *nacks)
+{
+	int i;
+	int ret = EC_SUCCESS;
+	__maybe_unused uint32_t start_us = 0;
+
+	for (i = 0; i <= CONFIG_I2C_NACK_RETRY_COUNT; i++) {
+		struct i2c_msg msg[2 * I2C_XFER_VEC_MAX_SEGS];
+		int num_msgs = 0;
+		int s;
+
+		for (s = 0; s < count; s++) {
+			if (segs[s].out_size) {
+				msg[num_msgs].buf = (uint8_t *)segs[s].out;
+				msg[num_msgs].len = segs[s].out_size;
+				msg[num_msgs].flags = I2C_MSG_WRITE;
+				if (s)
+					msg[num_msgs].flags |= I2C_MSG_RESTART;
+				num_msgs++;
+			}
+			if (segs[s].in_size) {
+				msg[num_msgs].buf = segs[s].in;
+				msg[num_msgs].len = segs[s].in_size;
+				msg[num_msgs].flags = I2C_MSG_READ;
+				if (s || segs[s].out_size)
+					msg[num_msgs].flags |= I2C_MSG_RESTART;
+				num_msgs++;
+			}
+		}
+		if (!num_msgs)
+			return EC_SUCCESS;
+		msg[num_msgs - 1].flags |= I2C_MSG_STOP;
+
+		(*attempts)++;
+		if (IS_ENABLED(CONFIG_I2C_DEBUG))
+			start_us = get_time().le.lo;
+		ret = i2c_transfer(i2c_get_device_for_port(port), msg, num_msgs,
+				   I2C_STRIP_FLAGS(addr_flags));
+
+		if (IS_ENABLED(CONFIG_I2C_DEBUG))
+			i2c_trace_notify_vec(port, addr_flags, segs, count, ret,
+					     start_us);
+
+		switch (ret) {
+		case 0:
+			return EC_SUCCESS;
+		case -EIO:
+			(*nacks)++;
+			ret = EC_ERROR_INVAL;
+			continue;
+		default:
+			return EC_ERROR_UNKNOWN;
+		}
+	}
+	return ret;
+}
+#endif /* CONFIG_ZEPHYR */
+
+int i2c_xfer_vec_unlocked(const int port, const uint16_t addr_flags,
+			  const struct i2c_xfer_seg *segs, int count)
+{
+	int i;
+	int ret = EC_SUCCESS;
+	__maybe_unused int attempts = 0, nacks = 0;
+	__maybe_unused int out_size = 0, in_size = 0;
+	__maybe_unused uint32_t start_us;
+
+	if (count <= 0 || count > I2C_XFER_VEC_MAX_SEGS ||
+	    I2C_USE_PEC(addr_flags))
+		return EC_ERROR_INVAL;
+
+	if (!i2c_port_is_locked(port)) {
+		CPUTS("Access I2C without lock!");
+		return EC_ERROR_INVAL;
+	}
+
+#ifdef CONFIG_ZEPHYR
+	if (!IS_ENABLED(CONFIG_I2C_STATS))
+		return i2c_xfer_vec_retry(port, addr_flags, segs, count,
+					  &attempts, &nacks);
+
+	for (i = 0; i < count; i++) {
+		out_size += segs[i].out_size;
+		in_size += segs[i].in_size;
+	}
+	start_us = get_time().le.lo;
+	ret = i2c_xfer_vec_retry(port, addr_flags, segs, count, &attempts,
+				 &nacks);
+	i2c_stats_xfer(port, addr_flags, out_size, in_size, ret,
+		       get_time().le.lo - start_us, attempts, nacks);
+#else
+	for (i = 0; i < count && ret == EC_SUCCESS; i++)
+		ret = i2c_xfer_unlocked(port, addr_flags, segs[i].out,
+					segs[i].out_size, segs[i].in,
+					segs[i].in_size, I2C_XFER_SINGLE);
+#endif /* CONFIG_ZEPHYR */
+	return ret;
+}
+
+int i2c_xfer_vec(const int port, const uint16_t addr_flags,
+		 const struct i2c_xfer_seg *segs, int count)
+{
+	int rv;
+
+	i2c_lock(port, 1);
+	rv = i2c_xfer_vec_unlocked(port, addr_flags, segs, count);
+	i2c_lock(port, 0);
+
+	return rv;
+}
+
 void i2c_lock(int port, int lock)
 {
+	__maybe_unused int stats_port = port;
+
 #ifdef CONFIG_I2C_MULTI_PORT_CONTROLLER
 	/* Lock the controller, not the port */
 	port = i2c_port_to_controller(port);
@@ -296,8 +451,16 @@ void i2c_lock(int port, int lock)
 
 	if (lock) {
 		uint32_t irq_lock_key;
+		uint32_t start_us;
 
-		mutex_lock(port_mutex + port);
+		if (IS_ENABLED(CONFIG_I2C_STATS)) {
+			start_us = get_time().le.lo;
+			mutex_lock(port_mutex + port);
+			i2c_stats_lock_wait(stats_port,
+					    get_time().le.lo - start_us);
+		} else {
+			mutex_lock(port_mutex + port);
+		}
 
 		/* Disable interrupt during changing counter for preemption. */
 		irq_lock_key = irq_lock();
@@ -331,8 +494,8 @@ void i2c_prepare_sysjump(void)
 }
 
 /* i2c_readN with optional error checking */
-static int platform_ec_i2c_read(const int port, const uint16_t addr_flags,
-				uint8_t reg, uint8_t *in, int in_size)
+static int i2c_read_reg_bus(const int port, const uint16_t addr_flags,
+			    uint8_t reg, uint8_t *in, int in_size)
 {
 	if (!IS_ENABLED(CONFIG_SMBUS_PEC) && I2C_USE_PEC(addr_flags))
 		return EC_ERROR_UNIMPLEMENTED;
@@ -372,8 +535,8 @@ static int platform_ec_i2c_read(const int port, const uint16_t addr_flags,
 }
 
 /* i2c_writeN with optional error checking */
-static int platform_ec_i2c_write(const int port, const uint16_t addr_flags,
-				 const uint8_t *out, int out_size)
+static int i2c_write_reg_bus(const int port, const uint16_t addr_flags,
+			     const uint8_t *out, int out_size)
 {
 	if (!IS_ENABLED(CONFIG_SMBUS_PEC) && I2C_USE_PEC(addr_flags))
 		return EC_ERROR_UNIMPLEMENTED;
@@ -406,6 +569,39 @@ static int platform_ec_i2c_write(const int port, const uint16_t addr_flags,
 	return i2c_xfer(port, addr_flags, out, out_size, NULL, 0);
 }
 
+/* i2c_readN, served from the register cache when possible */
+static int platform_ec_i2c_read(const int port, const uint16_t addr_flags,
+				uint8_t reg, uint8_t *in, int in_size)
+{
+	uint32_t seq = 0;
+	int rv;
+
+	if (!IS_ENABLED(CONFIG_I2C_REGCACHE))
+		return i2c_read_reg_bus(port, addr_flags, reg, in, in_size);
+
+	if (i2c_regcache_read(port, addr_flags, reg, in, in_size, &seq))
+		return EC_SUCCESS;
+
+	rv = i2c_read_reg_bus(port, addr_flags, reg, in, in_size);
+	if (rv == EC_SUCCESS)
+		i2c_regcache_fill(port, addr_flags, reg, in, in_size, seq);
+
+	return rv;
+}
+
+/* i2c_writeN, keeping the register cache up to date */
+static int platform_ec_i2c_write(const int port, const uint16_t addr_flags,
+				 const uint8_t *out, int out_size)
+{
+	int rv;
+
+	rv = i2c_write_reg_bus(port, addr_flags, out, out_size);
+	if (IS_ENABLED(CONFIG_I2C_REGCACHE))
+		i2c_regcache_write(port, addr_flags, out, out_size, rv);
+
+	return rv;
+}
+
 int i2c_read32(const int port, const uint16_t addr_flags, int offset, int *data)
 {
 	int rv;
@@ -0,0 +1,285 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Register cache of I2C peripherals */
+
+#include "common.h"
+#include "console.h"
+#include "hooks.h"
+#include "i2c.h"
+#include "i2c_regcache.h"
+#include "task.h"
+#include "util.h"
+
+#include <string.h>
+
+#define CPRINTS(format, args...) cprints(CC_I2C, format, ##args)
+
+/*
+ * Attached caches. A cache is added at the head and unlinked under
+ * irq_lock(). An unlinked cache keeps its next pointer, so the list can be
+ * walked without the lock. The contents and counters of a cache are only
+ * changed under irq_lock().
+ */
+static struct i2c_regcache *caches;
+
+static bool test_reg(const uint32_t *bitmap, int reg)
+{
+	return bitmap[reg / 32] & BIT(reg % 32);
+}
+
+static void set_reg(uint32_t *bitmap, int reg)
+{
+	bitmap[reg / 32] |= BIT(reg % 32);
+}
+
+static void clear_reg(uint32_t *bitmap, int reg)
+{
+	bitmap[reg / 32] &= ~BIT(reg % 32);
+}
+
+static struct i2c_regcache *find_cache(int port, uint16_t addr_flags)
+{
+	struct i2c_regcache *cache;
+
+	for (cache = caches; cache; cache = cache->next) {
+		if (cache->port == port &&
+		    I2C_STRIP_FLAGS(cache->addr_flags) ==
+			    I2C_STRIP_FLAGS(addr_flags))
+			return cache;
+	}
+	return NULL;
+}
+
+/* Whether an access of size bytes to reg can use the cache. */
+static bool is_cached(const struct i2c_regcache *cache, int reg, int size)
+{
+	return size == cache->reg_bytes && reg < cache->num_regs &&
+	       !(cache->volatile_regs && test_reg(cache->volatile_regs, reg));
+}
+
+void i2c_regcache_attach(struct i2c_regcache *cache, int port,
+			 uint16_t addr_flags)
+{
+	struct i2c_regcache *c;
+	uint32_t lock_key;
+
+	lock_key = irq_lock();
+	cache->port = port;
+	cache->addr_flags = addr_flags;
+	memset(cache->valid, 0,
+	       I2C_REGCACHE_WORDS(cache->num_regs) * sizeof(uint32_t));
+	memset(cache->dirty, 0,
+	       I2C_REGCACHE_WORDS(cache->num_regs) * sizeof(uint32_t));
+	cache->seq++;
+	for (c = caches; c && c != cache; c = c->next)
+		;
+	if (!c) {
+		cache->next = caches;
+		caches = cache;
+	}
+	irq_unlock(lock_key);
+}
+
+void i2c_regcache_detach(struct i2c_regcache *cache)
+{
+	struct i2c_regcache **c;
+	uint32_t lock_key;
+
+	lock_key = irq_lock();
+	for (c = &caches; *c; c = &(*c)->next) {
+		if (*c == cache) {
+			*c = cache->next;
+			break;
+		}
+	}
+	irq_unlock(lock_key);
+}
+
+void i2c_regcache_invalidate(struct i2c_regcache *cache)
+{
+	uint32_t lock_key;
+
+	lock_key = irq_lock();
+	memset(cache->valid, 0,
+	       I2C_REGCACHE_WORDS(cache->num_regs) * sizeof(uint32_t));
+	memset(cache->dirty, 0,
+	       I2C_REGCACHE_WORDS(cache->num_regs) * sizeof(uint32_t));
+	cache->seq++;
+	irq_unlock(lock_key);
+}
+
+int i2c_regcache_sync(struct i2c_regcache *cache)
+{
+	uint8_t buf[1 + sizeof(uint32_t)];
+	uint32_t lock_key;
+	int reg, rv, ret = EC_SUCCESS;
+
+	if (cache->reg_bytes > sizeof(uint32_t))
+		return EC_ERROR_INVAL;
+
+	/* Registers not written by the EC are back to their reset value. */
+	lock_key = irq_lock();
+	memcpy(cache->valid, cache->dirty,
+	       I2C_REGCACHE_WORDS(cache->num_regs) * sizeof(uint32_t));
+	cache->seq++;
+	irq_unlock(lock_key);
+
+	for (reg = 0; reg < cache->num_regs; reg++) {
+		lock_key = irq_lock();
+		if (!test_reg(cache->dirty, reg)) {
+			irq_unlock(lock_key);
+			continue;
+		}
+		buf[0] = reg;
+		memcpy(&buf[1], &cache->vals[reg * cache->reg_bytes],
+		       cache->reg_bytes);
+		irq_unlock(lock_key);
+
+		rv = i2c_xfer(cache->port, cache->addr_flags, buf,
+			      1 + cache->reg_bytes, NULL, 0);
+		if (rv) {
+			lock_key = irq_lock();
+			clear_reg(cache->valid, reg);
+			irq_unlock(lock_key);
+			if (ret == EC_SUCCESS)
+				ret = rv;
+		}
+	}
+
+	return ret;
+}
+
+bool i2c_regcache_read(int port, uint16_t addr_flags, uint8_t reg, uint8_t *in,
+		       int in_size, uint32_t *seq)
+{
+	struct i2c_regcache *cache;
+	uint32_t lock_key;
+	bool hit = false;
+
+	lock_key = irq_lock();
+	cache = find_cache(port, addr_flags);
+	if (cache && is_cached(cache, reg, in_size)) {
+		hit = test_reg(cache->valid, reg);
+		if (hit) {
+			memcpy(in, &cache->vals[reg * cache->reg_bytes],
+			       in_size);
+			cache->hits++;
+		} else {
+			cache->misses++;
+		}
+		*seq = cache->seq;
+	}
+	irq_unlock(lock_key);
+
+	return hit;
+}
+
+void i2c_regcache_fill(int port, uint16_t addr_flags, uint8_t reg,
+		       const uint8_t *in, int in_size, uint32_t seq)
+{
+	struct i2c_regcache *cache;
+	uint32_t lock_key;
+
+	lock_key = irq_lock();
+	cache = find_cache(port, addr_flags);
+	/* Drop the value if a write could have changed it since. */
+	if (cache && is_cached(cache, reg, in_size) && cache->seq == seq) {
+		memcpy(&cache->vals[reg * cache->reg_bytes], in, in_size);
+		set_reg(cache->valid, reg);
+	}
+	irq_unlock(lock_key);
+}
+
+void i2c_regcache_write(int port, uint16_t addr_flags, const uint8_t *out,
+			int out_size, int rv)
+{
+	struct i2c_regcache *cache;
+	uint32_t lock_key;
+	int reg = out[0];
+	int size = out_size - 1;
+	int last;
+
+	lock_key = irq_lock();
+	cache = find_cache(port, addr_flags);
+	if (!cache) {
+		irq_unlock(lock_key);
+		return;
+	}
+	cache->seq++;
+	if (rv == EC_SUCCESS && is_cached(cache, reg, size)) {
+		memcpy(&cache->vals[reg * cache->reg_bytes], &out[1], size);
+		set_reg(cache->valid, reg);
+		set_reg(cache->dirty, reg);
+	} else {
+		/* The registers written are unknown now. */
+		last = MIN(reg + DIV_ROUND_UP(size, cache->reg_bytes),
+			   cache->num_regs);
+		for (; reg < last; reg++) {
+			clear_reg(cache->valid, reg);
+			clear_reg(cache->dirty, reg);
+		}
+	}
+	irq_unlock(lock_key);
+}
+
+static void i2c_regcache_resume(void)
+{
+	struct i2c_regcache *cache;
+
+	for (cache = caches; cache; cache = cache->next) {
+		if (!(cache->flags & I2C_REGCACHE_RESTORE_ON_RESUME))
+			continue;
+		if (i2c_regcache_sync(cache))
+			CPRINTS("I2C%d:%02x regcache restore failed",
+				cache->port,
+				I2C_STRIP_FLAGS(cache->addr_flags));
+	}
+}
+DECLARE_HOOK(HOOK_CHIPSET_RESUME, i2c_regcache_resume, HOOK_PRIO_DEFAULT);
+
+static int count_regs(const struct i2c_regcache *cache,
+		      const uint32_t *bitmap)
+{
+	int reg, count = 0;
+
+	for (reg = 0; reg < cache->num_regs; reg++)
+		count += test_reg(bitmap, reg);
+	return count;
+}
+
+static int command_i2c_regcache(int argc, const char **argv)
+{
+	struct i2c_regcache *cache;
+	uint32_t lock_key;
+	uint32_t total;
+
+	if (argc > 1) {
+		if (strcasecmp(argv[1], "clear"))
+			return EC_ERROR_PARAM1;
+		for (cache = caches; cache; cache = cache->next) {
+			lock_key = irq_lock();
+			cache->hits = cache->misses = 0;
+			irq_unlock(lock_key);
+		}
+		return EC_SUCCESS;
+	}
+
+	ccprintf("port addr regs valid dirty      hits    misses  hit%%\n");
+	for (cache = caches; cache; cache = cache->next) {
+		total = cache->hits + cache->misses;
+		ccprintf("%4d 0x%02x %4d %5d %5d %9u %9u  %3d\n", cache->port,
+			 I2C_STRIP_FLAGS(cache->addr_flags), cache->num_regs,
+			 count_regs(cache, cache->valid),
+			 count_regs(cache, cache->dirty), cache->hits,
+			 cache->misses,
+			 total ? (int)((uint64_t)cache->hits * 100 / total) :
+				 0);
+	}
+
+	return EC_SUCCESS;
+}
+DECLARE_CONSOLE_COMMAND(i2cregcache, command_i2c_regcache, "[clear]",
+			"Show the I2C register cache hit rate");
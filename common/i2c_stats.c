@@ -0,0 +1,155 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* I2C bus utilization and latency statistics */
+
+#include "common.h"
+#include "host_command.h"
+#include "i2c.h"
+#include "task.h"
+#include "timer.h"
+#include "util.h"
+
+#include <string.h>
+
+#define STATS_PORT_COUNT (I2C_PORT_COUNT + I2C_BITBANG_PORT_COUNT)
+BUILD_ASSERT(STATS_PORT_COUNT <= UINT8_MAX);
+BUILD_ASSERT(CONFIG_I2C_STATS_ADDRS <= UINT8_MAX);
+
+static struct ec_i2c_stats port_stats[STATS_PORT_COUNT];
+
+/*
+ * Addresses are given an entry the first time they are seen, until the table
+ * is full. Entries are updated from any task doing I2C transfers, so all the
+ * statistics are protected by a short critical section.
+ */
+static struct {
+	uint8_t port;
+	uint8_t addr;
+	struct ec_i2c_stats stats;
+} addr_stats[CONFIG_I2C_STATS_ADDRS];
+static int addr_count;
+
+/* Time of the last reset, 0 for the EC boot. */
+static uint64_t reset_time;
+
+static struct ec_i2c_stats *find_addr_stats(int port, uint16_t addr)
+{
+	int i;
+
+	for (i = 0; i < addr_count; i++)
+		if (addr_stats[i].port == port && addr_stats[i].addr == addr)
+			return &addr_stats[i].stats;
+
+	if (addr_count == ARRAY_SIZE(addr_stats))
+		return NULL;
+	addr_stats[addr_count].port = port;
+	addr_stats[addr_count].addr = addr;
+	memset(&addr_stats[addr_count].stats, 0,
+	       sizeof(addr_stats[addr_count].stats));
+	return &addr_stats[addr_count++].stats;
+}
+
+static void add_xfer(struct ec_i2c_stats *s, int out_size, int in_size,
+		     int ret, uint32_t duration_us, int attempts, int nacks)
+{
+	int bucket;
+
+	s->xfers++;
+	if (ret != EC_SUCCESS)
+		s->errors++;
+	s->nacks += nacks;
+	s->retries += attempts - 1;
+	s->bytes_out += out_size;
+	s->bytes_in += in_size;
+	s->busy_us += duration_us;
+
+	for (bucket = 0; bucket < EC_I2C_STATS_HIST_BUCKETS - 1; bucket++)
+		if (duration_us < (EC_I2C_STATS_HIST_BASE_US << bucket))
+			break;
+	s->hist[bucket]++;
+}
+
+void i2c_stats_xfer(int port, uint16_t addr_flags, int out_size, int in_size,
+		    int ret, uint32_t duration_us, int attempts, int nacks)
+{
+	struct ec_i2c_stats *s;
+	uint32_t lock_key;
+
+	if (attempts == 0 || port < 0 || port >= STATS_PORT_COUNT)
+		return;
+
+	lock_key = irq_lock();
+	add_xfer(&port_stats[port], out_size, in_size, ret, duration_us,
+		 attempts, nacks);
+	s = find_addr_stats(port, I2C_STRIP_FLAGS(addr_flags));
+	if (s)
+		add_xfer(s, out_size, in_size, ret, duration_us, attempts,
+			 nacks);
+	irq_unlock(lock_key);
+}
+
+void i2c_stats_lock_wait(int port, uint32_t wait_us)
+{
+	uint32_t lock_key;
+
+	if (port < 0 || port >= STATS_PORT_COUNT)
+		return;
+
+	lock_key = irq_lock();
+	port_stats[port].lock_wait_us += wait_us;
+	irq_unlock(lock_key);
+}
+
+static enum ec_status
+host_command_i2c_stats(struct host_cmd_handler_args *args)
+{
+	const struct ec_params_i2c_stats *p = args->params;
+	struct ec_response_i2c_stats *r = args->response;
+	uint32_t lock_key;
+
+	/* No response, the host may not provide a buffer for one. */
+	if (p->cmd == EC_I2C_STATS_RESET) {
+		lock_key = irq_lock();
+		memset(port_stats, 0, sizeof(port_stats));
+		addr_count = 0;
+		reset_time = get_time().val;
+		irq_unlock(lock_key);
+		return EC_RES_SUCCESS;
+	}
+
+	memset(r, 0, sizeof(*r));
+	r->addr = EC_I2C_STATS_NO_ADDR;
+
+	lock_key = irq_lock();
+	r->elapsed_ms = (get_time().val - reset_time) / MSEC;
+	switch (p->cmd) {
+	case EC_I2C_STATS_GET_PORT:
+		r->count = STATS_PORT_COUNT;
+		if (p->index < r->count) {
+			r->port = p->index;
+			r->stats = port_stats[p->index];
+		}
+		break;
+	case EC_I2C_STATS_GET_ADDR:
+		r->count = addr_count;
+		if (p->index < r->count) {
+			r->port = addr_stats[p->index].port;
+			r->addr = addr_stats[p->index].addr;
+			r->stats = addr_stats[p->index].stats;
+		}
+		break;
+	default:
+		irq_unlock(lock_key);
+		return EC_RES_INVALID_PARAM;
+	}
+	irq_unlock(lock_key);
+
+	args->response_size = sizeof(*r);
+
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(EC_CMD_I2C_STATS, host_command_i2c_stats,
+		     EC_VER_MASK(0));
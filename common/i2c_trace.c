@@ -5,9 +5,12 @@
 
 #include "common.h"
 #include "console.h"
+#include "host_command.h"
 #include "i2c.h"
 #include "stdbool.h"
 #include "stddef.h"
+#include "task.h"
+#include "timer.h"
 #include "util.h"
 
 #define CPUTS(outstr) cputs(CC_I2C, outstr)
@@ -23,35 +26,177 @@ struct i2c_trace_range {
 
 static struct i2c_trace_range trace_entries[8];
 
-void i2c_trace_notify(int port, uint16_t addr_flags, const uint8_t *out_data,
-		      size_t out_size, const uint8_t *in_data, size_t in_size,
-		      int ret)
+BUILD_ASSERT(POWER_OF_TWO(CONFIG_I2C_TRACE_SIZE));
+#define TRACE_MASK (CONFIG_I2C_TRACE_SIZE - 1)
+
+static struct ec_i2c_trace_record trace[CONFIG_I2C_TRACE_SIZE];
+
+/*
+ * "trace_head" is the oldest record, "trace_tail" is the next record to write.
+ * They are not wrapped until they are used, so a full buffer is told apart
+ * from an empty one. Records are written from any task doing I2C transfers,
+ * so both are protected by a short critical section.
+ */
+static uint32_t trace_head;
+static uint32_t trace_tail;
+static uint16_t trace_lost;
+
+static void trace_record(int port, uint16_t addr, const uint8_t *out_data,
+			 size_t out_size, const uint8_t *in_data,
+			 size_t in_size, int ret, uint32_t start_us)
+{
+	struct ec_i2c_trace_record *rec;
+	uint32_t duration = get_time().le.lo - start_us;
+	size_t out_count = MIN(out_size, EC_I2C_TRACE_DATA_SIZE);
+	size_t in_count = ret == EC_SUCCESS ?
+				  MIN(in_size, EC_I2C_TRACE_DATA_SIZE -
+						       out_count) :
+				  0;
+	uint32_t lock_key;
+
+	lock_key = irq_lock();
+	if (trace_tail - trace_head == CONFIG_I2C_TRACE_SIZE) {
+		trace_head++;
+		if (trace_lost < UINT16_MAX)
+			trace_lost++;
+	}
+	rec = &trace[trace_tail++ & TRACE_MASK];
+	rec->timestamp = start_us;
+	rec->duration = MIN(duration, UINT16_MAX);
+	rec->port = port;
+	rec->addr = addr;
+	rec->out_size = MIN(out_size, UINT16_MAX);
+	rec->in_size = MIN(in_size, UINT16_MAX);
+	rec->result = CLAMP(ret, INT16_MIN, INT16_MAX);
+	memcpy(rec->data, out_data, out_count);
+	memcpy(&rec->data[out_count], in_data, in_count);
+	irq_unlock(lock_key);
+}
+
+static bool trace_enabled(int port, uint16_t addr)
 {
 	size_t i;
-	uint16_t addr = I2C_STRIP_FLAGS(addr_flags);
 
 	for (i = 0; i < ARRAY_SIZE(trace_entries); i++)
 		if (trace_entries[i].enabled && trace_entries[i].port == port &&
 		    trace_entries[i].addr_lo <= addr &&
 		    trace_entries[i].addr_hi >= addr)
-			goto trace_enabled;
-	return;
-
-trace_enabled:
-	CPRINTF("i2c: %d:0x%X ", port, addr);
-	if (out_size) {
-		CPRINTF("wr ");
-		for (i = 0; i < out_size; i++)
-			CPRINTF("0x%02X ", out_data[i]);
+			return true;
+	return false;
+}
+
+void i2c_trace_notify(int port, uint16_t addr_flags, const uint8_t *out_data,
+		      size_t out_size, const uint8_t *in_data, size_t in_size,
+		      int ret, uint32_t start_us)
+{
+	uint16_t addr = I2C_STRIP_FLAGS(addr_flags);
+
+	if (trace_enabled(port, addr))
+		trace_record(port, addr, out_data, out_size, in_data, in_size,
+			     ret, start_us);
+}
+
+void i2c_trace_notify_vec(int port, uint16_t addr_flags,
+			  const struct i2c_xfer_seg *segs, int count, int ret,
+			  uint32_t start_us)
+{
+	uint16_t addr = I2C_STRIP_FLAGS(addr_flags);
+	uint8_t out_data[EC_I2C_TRACE_DATA_SIZE];
+	uint8_t in_data[EC_I2C_TRACE_DATA_SIZE];
+	size_t out_size = 0, in_size = 0;
+	size_t n;
+	int i;
+
+	if (!trace_enabled(port, addr))
+		return;
+
+	/* Concatenate the segments, keeping the bytes that fit a record. */
+	for (i = 0; i < count; i++) {
+		if (out_size < sizeof(out_data)) {
+			n = MIN((size_t)segs[i].out_size,
+				sizeof(out_data) - out_size);
+			memcpy(&out_data[out_size], segs[i].out, n);
+		}
+		if (in_size < sizeof(in_data)) {
+			n = MIN((size_t)segs[i].in_size,
+				sizeof(in_data) - in_size);
+			memcpy(&in_data[in_size], segs[i].in, n);
+		}
+		out_size += segs[i].out_size;
+		in_size += segs[i].in_size;
 	}
-	if (ret != EC_SUCCESS) {
-		CPRINTF(" error: %d", ret);
-	} else if (in_size) {
-		CPRINTF("  rd ");
-		for (i = 0; i < in_size; i++)
-			CPRINTF("0x%02X ", in_data[i]);
+	trace_record(port, addr, out_data, out_size, in_data, in_size, ret,
+		     start_us);
+}
+
+/* Remove the oldest records of the trace, return how many were copied. */
+static int i2c_trace_read(struct ec_i2c_trace_record *out, int max_count,
+			  uint16_t *lost)
+{
+	uint32_t lock_key;
+	int count, i;
+
+	lock_key = irq_lock();
+	count = MIN(max_count, (int)(trace_tail - trace_head));
+	for (i = 0; i < count; i++)
+		out[i] = trace[trace_head++ & TRACE_MASK];
+	*lost = trace_lost;
+	trace_lost = 0;
+	irq_unlock(lock_key);
+
+	return count;
+}
+
+static enum ec_status
+host_command_i2c_trace_read(struct host_cmd_handler_args *args)
+{
+	struct ec_response_i2c_trace_read *r = args->response;
+	int max_count;
+
+	max_count = (args->response_max - sizeof(*r)) / sizeof(r->records[0]);
+	r->count = i2c_trace_read(r->records, max_count, &r->lost);
+	args->response_size = sizeof(*r) + r->count * sizeof(r->records[0]);
+
+	return EC_RES_SUCCESS;
+}
+DECLARE_HOST_COMMAND(EC_CMD_I2C_TRACE_READ, host_command_i2c_trace_read,
+		     EC_VER_MASK(0));
+
+static int command_i2ctrace_dump(void)
+{
+	struct ec_i2c_trace_record rec;
+	uint16_t lost;
+	size_t out_count, i;
+
+	while (i2c_trace_read(&rec, 1, &lost)) {
+		if (lost)
+			ccprintf("(%d lost)\n", lost);
+		out_count = MIN(rec.out_size, EC_I2C_TRACE_DATA_SIZE);
+		ccprintf("%10u %5uus %d:0x%X", rec.timestamp, rec.duration,
+			 rec.port, rec.addr);
+		if (rec.out_size) {
+			ccprintf(" wr");
+			for (i = 0; i < out_count; i++)
+				ccprintf(" 0x%02X", rec.data[i]);
+			if (rec.out_size > out_count)
+				ccprintf(" ...");
+		}
+		if (rec.result != EC_SUCCESS) {
+			ccprintf("  error: %d", rec.result);
+		} else if (rec.in_size) {
+			ccprintf("  rd");
+			for (i = out_count; i < EC_I2C_TRACE_DATA_SIZE &&
+					    i < out_count + rec.in_size;
+			     i++)
+				ccprintf(" 0x%02X", rec.data[i]);
+			if (out_count + rec.in_size > EC_I2C_TRACE_DATA_SIZE)
+				ccprintf(" ...");
+		}
+		ccprintf("\n");
+		cflush();
 	}
-	CPRINTF("\n");
+
+	return EC_SUCCESS;
 }
 
 static int command_i2ctrace_list(void)
@@ -166,6 +311,9 @@ static int command_i2ctrace(int argc, const char **argv)
 	if (!strcasecmp(argv[1], "list") && argc == 2)
 		return command_i2ctrace_list();
 
+	if (!strcasecmp(argv[1], "dump") && argc == 2)
+		return command_i2ctrace_dump();
+
 	if (argc < 3)
 		return EC_ERROR_PARAM_COUNT;
 
@@ -198,6 +346,7 @@ static int command_i2ctrace(int argc, const char **argv)
 	return EC_ERROR_PARAM1;
 }
 DECLARE_CONSOLE_COMMAND(i2ctrace, command_i2ctrace,
-			"[list | disable <id> | enable <port> <address> | "
+			"[list | dump | disable <id> | "
+			"enable <port> <address> | "
 			"enable <port> <address-low> <address-high>]",
 			"Trace I2C transactions");
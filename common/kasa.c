@@ -38,6 +38,44 @@ void kasa_accumulate(struct kasa_fit *kasa, fp_t x, fp_t y, fp_t z)
 	kasa->nsamples += 1;
 }
 
+/* Convert an exact integer sum to the fixed point or float accumulators. */
+static fp_t sum_to_fp(int64_t sum)
+{
+#ifdef CONFIG_FPU
+	return (fp_t)sum;
+#else
+	/* Wrap like the scalar accumulation does. */
+	return (fp_t)(uint32_t)((uint64_t)sum << FP_BITS);
+#endif
+}
+
+void kasa_accumulate_batch(struct kasa_fit *kasa, const intv3_t *v, size_t n)
+{
+	struct intv3_moments m;
+
+	intv3_moments_reset(&m);
+	intv3_moments_add(&m, v, n);
+
+	kasa->acc_x += sum_to_fp(m.sum[X]);
+	kasa->acc_y += sum_to_fp(m.sum[Y]);
+	kasa->acc_z += sum_to_fp(m.sum[Z]);
+	kasa->acc_w += sum_to_fp(m.sum_sq[X] + m.sum_sq[Y] + m.sum_sq[Z]);
+
+	kasa->acc_xx += sum_to_fp(m.sum_sq[X]);
+	kasa->acc_xy += sum_to_fp(m.sum_cross[0]);
+	kasa->acc_xz += sum_to_fp(m.sum_cross[1]);
+	kasa->acc_xw += sum_to_fp(m.sum_w[X]);
+
+	kasa->acc_yy += sum_to_fp(m.sum_sq[Y]);
+	kasa->acc_yz += sum_to_fp(m.sum_cross[2]);
+	kasa->acc_yw += sum_to_fp(m.sum_w[Y]);
+
+	kasa->acc_zz += sum_to_fp(m.sum_sq[Z]);
+	kasa->acc_zw += sum_to_fp(m.sum_w[Z]);
+
+	kasa->nsamples += n;
+}
+
 void kasa_compute(struct kasa_fit *kasa, fpv3_t bias, fp_t *radius)
 {
 	/*    A    *   out   =    b
@@ -101,16 +101,13 @@ static int moc_eigen_test(struct mag_cal_t *moc)
 void init_mag_cal(struct mag_cal_t *moc)
 {
 	kasa_reset(&moc->kasa_fit);
+	moc->num_staged = 0;
 }
 
-int mag_cal_update(struct mag_cal_t *moc, const intv3_t v)
+static int mag_cal_batch_done(struct mag_cal_t *moc)
 {
 	int new_bias = 0;
 
-	/* 1. run accumulators */
-	kasa_accumulate(&moc->kasa_fit, INT_TO_FP(v[X]), INT_TO_FP(v[Y]),
-			INT_TO_FP(v[Z]));
-
 	/* 2. batch has enough samples? */
 	if (moc->batch_size > 0 && moc->kasa_fit.nsamples >= moc->batch_size) {
 		/* 3. eigen test */
@@ -131,8 +128,51 @@ int mag_cal_update(struct mag_cal_t *moc, const intv3_t v)
 			}
 		}
 		/* 5. reset for next batch */
-		init_mag_cal(moc);
+		kasa_reset(&moc->kasa_fit);
 	}
 
 	return new_bias;
 }
+
+int mag_cal_update(struct mag_cal_t *moc, const intv3_t v)
+{
+	/* 1. run accumulators */
+	kasa_accumulate(&moc->kasa_fit, INT_TO_FP(v[X]), INT_TO_FP(v[Y]),
+			INT_TO_FP(v[Z]));
+
+	return mag_cal_batch_done(moc);
+}
+
+int mag_cal_update_batch(struct mag_cal_t *moc, const intv3_t *v, size_t n)
+{
+	int new_bias = 0;
+
+	while (n > 0) {
+		size_t chunk = n;
+
+		/* Stop at the end of the calibration batch. */
+		if (moc->batch_size > moc->kasa_fit.nsamples)
+			chunk = MIN(n, moc->batch_size -
+					       moc->kasa_fit.nsamples);
+		else if (moc->batch_size > 0)
+			chunk = 1;
+
+		/* 1. run accumulators */
+		kasa_accumulate_batch(&moc->kasa_fit, v, chunk);
+		new_bias |= mag_cal_batch_done(moc);
+		v += chunk;
+		n -= chunk;
+	}
+
+	return new_bias;
+}
+
+int mag_cal_stage(struct mag_cal_t *moc, const intv3_t v)
+{
+	memcpy(moc->staged[moc->num_staged++], v, sizeof(intv3_t));
+	if (moc->num_staged < MAG_CAL_STAGE_SIZE)
+		return 0;
+
+	moc->num_staged = 0;
+	return mag_cal_update_batch(moc, moc->staged, MAG_CAL_STAGE_SIZE);
+}
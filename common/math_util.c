@@ -32,6 +32,24 @@ static const fp_t cos_lut[] = {
 };
 BUILD_ASSERT(ARRAY_SIZE(cos_lut) == COSINE_LUT_SIZE);
 
+/*
+ * For arctangent lookup table, the number of steps between 0 and 1. Linear
+ * interpolation between entries 1/16 apart is off by at most
+ * max|atan''| / 8 / 16^2 = 0.0183 degree.
+ */
+#define ATAN_LUT_STEPS 16
+
+/* Lookup table for the value of atan(i / ATAN_LUT_STEPS) in degrees. */
+static const fp_t atan_lut[] = {
+	FLOAT_TO_FP(0.00000), FLOAT_TO_FP(3.57633), FLOAT_TO_FP(7.12502),
+	FLOAT_TO_FP(10.61966), FLOAT_TO_FP(14.03624), FLOAT_TO_FP(17.35402),
+	FLOAT_TO_FP(20.55605), FLOAT_TO_FP(23.62938), FLOAT_TO_FP(26.56505),
+	FLOAT_TO_FP(29.35775), FLOAT_TO_FP(32.00538), FLOAT_TO_FP(34.50852),
+	FLOAT_TO_FP(36.86990), FLOAT_TO_FP(39.09386), FLOAT_TO_FP(41.18593),
+	FLOAT_TO_FP(43.15239), FLOAT_TO_FP(45.00000),
+};
+BUILD_ASSERT(ARRAY_SIZE(atan_lut) == ATAN_LUT_STEPS + 1);
+
 fp_t arc_cos(fp_t x)
 {
 	int i;
@@ -64,6 +82,39 @@ fp_t arc_cos(fp_t x)
 	__builtin_unreachable(); /* LCOV_EXCL_LINE */
 }
 
+fp_t arc_tan2(int y, int x)
+{
+	const int ax = ABS(x), ay = ABS(y);
+	fp_t ratio, pos, angle;
+	int i;
+
+	if (!ax && !ay)
+		return FLOAT_TO_FP(0);
+
+	/*
+	 * Fold the angle into [0, 45] degrees, so that the ratio of the
+	 * smallest to the largest component indexes the table.
+	 */
+	ratio = ay <= ax ? fp_div(ay, ax) : fp_div(ax, ay);
+	pos = fp_mul(ratio, INT_TO_FP(ATAN_LUT_STEPS));
+	i = FP_TO_INT(pos);
+	if (i >= ATAN_LUT_STEPS)
+		angle = atan_lut[ATAN_LUT_STEPS];
+	else
+		angle = atan_lut[i] + fp_mul(pos - INT_TO_FP(i),
+					     atan_lut[i + 1] - atan_lut[i]);
+
+	/* Unfold to the octant and quadrant of (x, y). */
+	if (ay > ax)
+		angle = FLOAT_TO_FP(90) - angle;
+	if (x < 0)
+		angle = FLOAT_TO_FP(180) - angle;
+	if (y < 0 && angle > FLOAT_TO_FP(0))
+		angle = FLOAT_TO_FP(360) - angle;
+
+	return angle;
+}
+
 /**
  * Integer square root.
  */
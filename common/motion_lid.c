@@ -95,6 +95,13 @@ static const intv3_t hinge_axis = { 1, 0, 0 };
 #define HINGE_AXIS X
 #endif
 
+/*
+ * Axes of the plane orthogonal to the hinge, so that going from HINGE_U to
+ * HINGE_V is counterclockwise around hinge_axis.
+ */
+#define HINGE_U ((HINGE_AXIS + 1) % 3)
+#define HINGE_V ((HINGE_AXIS + 2) % 3)
+
 static const struct motion_sensor_t *const accel_base =
 	&motion_sensors[CONFIG_LID_ANGLE_SENSOR_BASE];
 static const struct motion_sensor_t *const accel_lid =
@@ -279,6 +286,50 @@ static void motion_lid_set_dptf_profile(int reliable)
 
 #endif /* MOTION_LID_SET_DPTF_PROFILE */
 
+/**
+ * Clockwise angle around the hinge from base to lid, using the cosine of
+ * their angle and the sign of their cross product.
+ *
+ * @param base Base accel vector, projected on the hinge plane
+ * @param lid  Lid accel vector, projected on the hinge plane
+ *
+ * @return angle in degrees, in [0, 360].
+ */
+test_export_static fp_t hinge_angle_acos(const intv3_t base, const intv3_t lid)
+{
+	intv3_t cross;
+	fp_t angle = arc_cos(cosine_of_angle_diff(base, lid));
+
+	/*
+	 * If the dot product of this cross product is normal, it means that
+	 * the shortest angle between |base| and |lid| was counterclockwise
+	 * with respect to the surface represented by |hinge_axis| and this
+	 * angle must be reversed.
+	 */
+	cross_product(base, lid, cross);
+	if (dot_product(cross, hinge_axis) > 0)
+		angle = FLOAT_TO_FP(360) - angle;
+
+	return angle;
+}
+
+/**
+ * Same as hinge_angle_acos(), as the difference of the angles of the two
+ * vectors in the hinge plane. It needs neither the magnitudes of the vectors
+ * nor a division by them, and arc_tan2() interpolates a much finer table
+ * than arc_cos().
+ */
+test_export_static fp_t hinge_angle_atan(const intv3_t base, const intv3_t lid)
+{
+	fp_t angle = arc_tan2(base[HINGE_V], base[HINGE_U]) -
+		     arc_tan2(lid[HINGE_V], lid[HINGE_U]);
+
+	if (angle < 0)
+		angle += FLOAT_TO_FP(360);
+
+	return angle;
+}
+
 /**
  * Calculate the lid angle using two acceleration vectors, one recorded in
  * the base and one in the lid.
@@ -292,7 +343,7 @@ static void motion_lid_set_dptf_profile(int reliable)
 static int calculate_lid_angle(const intv3_t base, const intv3_t lid,
 			       int *lid_angle)
 {
-	intv3_t cross, proj_lid, proj_base, scaled_base, scaled_lid;
+	intv3_t proj_lid, proj_base, scaled_base, scaled_lid;
 	fp_t lid_to_base_fp, smoothed_ratio;
 	int base_magnitude2, lid_magnitude2, largest_hinge_accel;
 	int reliable = 1, i;
@@ -390,17 +441,10 @@ static int calculate_lid_angle(const intv3_t base, const intv3_t lid,
 	proj_lid[HINGE_AXIS] = 0;
 
 	/* Calculate the clockwise angle */
-	lid_to_base_fp = arc_cos(cosine_of_angle_diff(proj_base, proj_lid));
-	cross_product(proj_base, proj_lid, cross);
-
-	/*
-	 * If the dot product of this cross product is normal, it means that
-	 * the shortest angle between |base| and |lid| was counterclockwise
-	 * with respect to the surface represented by |hinge_axis| and this
-	 * angle must be reversed.
-	 */
-	if (dot_product(cross, hinge_axis) > 0)
-		lid_to_base_fp = FLOAT_TO_FP(360) - lid_to_base_fp;
+	if (IS_ENABLED(CONFIG_LID_ANGLE_ATAN_TABLE))
+		lid_to_base_fp = hinge_angle_atan(proj_base, proj_lid);
+	else
+		lid_to_base_fp = hinge_angle_acos(proj_base, proj_lid);
 
 	/*
 	 * Angle is between the keyboard and the front of screen: we need to
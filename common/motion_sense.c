@@ -24,6 +24,7 @@
 #include "motion_orientation.h"
 #include "motion_sense.h"
 #include "motion_sense_fifo.h"
+#include "motion_sense_trace.h"
 #include "power.h"
 #include "printf.h"
 #include "queue.h"
@@ -96,6 +97,28 @@ void update_sense_data(uint8_t *lpc_status, int *psample_id);
 /* Flags to control whether to send an ODR change event for a sensor */
 static atomic_t odr_event_required;
 
+/*
+ * Sensors the motion sense task reads on its own (forced mode), sorted by
+ * next collection time. Only the motion sense task walks the queue, other
+ * tasks mark it stale when they change what or when sensors are collected.
+ */
+static uint8_t deadline_queue[MAX_MOTION_SENSORS];
+static int deadline_queue_len;
+static atomic_t deadline_queue_stale = 1;
+
+/* Fastest collection rate of all sensors, updated with the queue. */
+static uint32_t fastest_collection_rate = UINT32_MAX;
+
+/* Statistics of the reads scheduled from the deadline queue. */
+struct motion_sense_sched_stats {
+	uint32_t reads;
+	uint32_t late_reads;
+	uint32_t missed_reads;
+	uint32_t jitter_max_us;
+	uint64_t jitter_sum_us;
+};
+static struct motion_sense_sched_stats sched_stats[MAX_MOTION_SENSORS];
+
 /* Whether or not the FIFO interrupt should be enabled (set from the AP). */
 __maybe_unused static int fifo_int_enabled;
 
@@ -174,6 +197,109 @@ motion_sensor_time_to_read(const timestamp_t *ts,
 			  sensor->next_collection - motion_min_interval);
 }
 
+static void motion_sense_deadlines_invalidate(void)
+{
+	atomic_or(&deadline_queue_stale, 1);
+}
+
+static void deadline_queue_insert(int sensor_num)
+{
+	uint32_t next = motion_sensors[sensor_num].next_collection;
+	int i;
+
+	/* Keep the insertion order of sensors due at the same time. */
+	for (i = deadline_queue_len; i > 0; i--) {
+		struct motion_sensor_t *s =
+			&motion_sensors[deadline_queue[i - 1]];
+
+		if (!time_after(s->next_collection, next))
+			break;
+		deadline_queue[i] = deadline_queue[i - 1];
+	}
+	deadline_queue[i] = sensor_num;
+	deadline_queue_len++;
+}
+
+static void deadline_queue_rebuild(void)
+{
+	struct motion_sensor_t *sensor;
+	int i;
+
+	deadline_queue_len = 0;
+	fastest_collection_rate = UINT32_MAX;
+	for (i = 0; i < motion_sensor_count; i++) {
+		sensor = &motion_sensors[i];
+		if (sensor->collection_rate == 0)
+			continue;
+		fastest_collection_rate =
+			MIN(fastest_collection_rate, sensor->collection_rate);
+		if (motion_sensor_in_forced_mode(sensor))
+			deadline_queue_insert(i);
+	}
+}
+
+/**
+ * Remove the sensors due at ts from the head of the deadline queue.
+ *
+ * @return Bitmap of the sensors removed, to be put back with
+ *	   deadline_queue_requeue() once read.
+ */
+static uint32_t deadline_queue_pop_due(const timestamp_t *ts)
+{
+	uint32_t due = 0;
+	int i;
+
+	for (i = 0; i < deadline_queue_len; i++) {
+		if (!motion_sensor_time_to_read(
+			    ts, &motion_sensors[deadline_queue[i]]))
+			break;
+		due |= BIT(deadline_queue[i]);
+	}
+	deadline_queue_len -= i;
+	memmove(deadline_queue, &deadline_queue[i], deadline_queue_len);
+
+	return due;
+}
+
+static void deadline_queue_requeue(uint32_t due)
+{
+	while (due)
+		deadline_queue_insert(get_next_bit(&due));
+}
+
+/*
+ * Outside S0, a sensor with an EC rate is read at that rate, slower than its
+ * collection rate: collections are skipped on purpose.
+ */
+static bool motion_sensor_paced_by_ec_rate(const struct motion_sensor_t *sensor)
+{
+	enum sensor_config cfg_index = motion_sense_get_ec_config();
+
+	return cfg_index != SENSOR_CONFIG_EC_S0 &&
+	       sensor->config[cfg_index].ec_rate != 0;
+}
+
+static void motion_sense_sched_account(struct motion_sensor_t *sensor,
+				       const timestamp_t *ts)
+{
+	struct motion_sense_sched_stats *stats =
+		&sched_stats[sensor - motion_sensors];
+	int lateness = time_until(sensor->next_collection, ts->le.lo);
+	uint32_t jitter = ABS(lateness);
+
+	if (motion_sensor_paced_by_ec_rate(sensor))
+		return;
+
+	/* The host command reads and resets the stats under the same lock */
+	mutex_lock(&g_sensor_mutex);
+	stats->reads++;
+	if (lateness > (int)motion_min_interval)
+		stats->late_reads++;
+	stats->jitter_sum_us += jitter;
+	stats->jitter_max_us = MAX(stats->jitter_max_us, jitter);
+	mutex_unlock(&g_sensor_mutex);
+}
+
 enum motion_sense_interrupt_mode {
 	MOTION_SENSE_INTERRUPT_MODE_UNCHANGED,
 	MOTION_SENSE_INTERRUPT_MODE_ENABLED,
@@ -293,6 +419,7 @@ int motion_sense_set_data_rate(struct motion_sensor_t *sensor)
 					     sensor->collection_rate);
 	}
 	mutex_unlock(&g_sensor_mutex);
+	motion_sense_deadlines_invalidate();
 	if (IS_ENABLED(CONFIG_BODY_DETECTION) &&
 	    (sensor - motion_sensors == CONFIG_BODY_DETECTION_SENSOR))
 		body_detect_reset();
@@ -401,6 +528,7 @@ static void motion_sense_switch_sensor_rate(void)
 			mutex_lock(&g_sensor_mutex);
 			sensor->collection_rate = 0;
 			mutex_unlock(&g_sensor_mutex);
+			motion_sense_deadlines_invalidate();
 			sensor->state = SENSOR_NOT_INITIALIZED;
 		}
 	}
@@ -490,6 +618,7 @@ static void motion_sense_shutdown(void)
 	motion_sense_print_stats("shutdown");
 
 	sensor_active = SENSOR_ACTIVE_S5;
+	motion_sense_deadlines_invalidate();
 	for (i = 0; i < motion_sensor_count; i++) {
 		sensor = &motion_sensors[i];
 		if (!SENSOR_ACTIVE(sensor)) {
@@ -525,6 +654,7 @@ static void motion_sense_suspend(void)
 		return;
 
 	sensor_active = SENSOR_ACTIVE_S3;
+	motion_sense_deadlines_invalidate();
 	/*
 	 *  Disable the sensor as soon as possible if it is going to lose power.
 	 *  It does not prevent current sensor task to run, but next iteration
@@ -558,6 +688,7 @@ static void motion_sense_resume(void)
 	motion_sense_print_stats("resume");
 
 	sensor_active = SENSOR_ACTIVE_S0;
+	motion_sense_deadlines_invalidate();
 	hook_call_deferred(&motion_sense_switch_sensor_rate_data,
 			   CONFIG_MOTION_SENSE_RESUME_DELAY_US);
 }
@@ -673,14 +804,15 @@ static inline void increment_sensor_collection(struct motion_sensor_t *sensor,
 		 * soon as possible. This should not happen and if it does it
 		 * means that the ec cannot handle the requested data rate.
 		 */
-		enum sensor_config cfg_index = motion_sense_get_ec_config();
-
-		if (cfg_index == SENSOR_CONFIG_EC_S0 ||
-		    sensor->config[cfg_index].ec_rate == 0) {
+		if (!motion_sensor_paced_by_ec_rate(sensor)) {
 			int missed_events =
 				time_until(sensor->next_collection, ts->le.lo) /
 				sensor->collection_rate;
 
+			mutex_lock(&g_sensor_mutex);
+			sched_stats[sensor - motion_sensors].missed_reads +=
+				missed_events;
+			mutex_unlock(&g_sensor_mutex);
 			CPRINTS("%s Missed %d data collections at %u"
 				" - rate: %d",
 				sensor->name, missed_events,
@@ -726,7 +858,7 @@ void motion_sense_push_raw_xyz(struct motion_sensor_t *s)
 }
 
 static int motion_sense_process(struct motion_sensor_t *sensor, uint32_t *event,
-				const timestamp_t *ts)
+				const timestamp_t *ts, bool due)
 {
 	int ret = EC_SUCCESS;
 	int is_odr_pending = 0;
@@ -774,13 +906,14 @@ static int motion_sense_process(struct motion_sensor_t *sensor, uint32_t *event,
 	}
 
 	if (motion_sensor_in_forced_mode(sensor)) {
-		if (motion_sensor_time_to_read(ts, sensor)) {
+		if (due && sensor->collection_rate != 0) {
 			/*
 			 * Since motion_sense_read can sleep, other task may be
 			 * scheduled. In particular if suspend is called by
 			 * HOOKS task, it may set colleciton_rate to 0 and we
 			 * would crash in increment_sensor_collection.
 			 */
+			motion_sense_sched_account(sensor, ts);
 			increment_sensor_collection(sensor, ts);
 			ret = motion_sense_read(sensor);
 		} else {
@@ -925,6 +1058,7 @@ void motion_sense_task(void *u)
 	timestamp_t ts_end_task;
 	int32_t time_diff;
 	uint32_t event = 0;
+	uint32_t due;
 	uint16_t ready_status = 0;
 	struct motion_sensor_t *sensor;
 	uint8_t *lpc_status;
@@ -943,18 +1077,40 @@ void motion_sense_task(void *u)
 	while (1) {
 		ts_begin_task = get_time();
 		atomic_add(&motion_sense_task_loops, 1);
+		if (atomic_clear(&deadline_queue_stale))
+			deadline_queue_rebuild();
+		due = deadline_queue_pop_due(&ts_begin_task);
 		for (i = 0; i < motion_sensor_count; ++i) {
 			sensor = &motion_sensors[i];
 
 			/* if the sensor is active in the current power state */
-			if (SENSOR_ACTIVE(sensor)) {
-				ret = motion_sense_process(sensor, &event,
-							   &ts_begin_task);
-				if (ret != EC_SUCCESS)
-					continue;
-				ready_status |= BIT(i);
+			if (!SENSOR_ACTIVE(sensor))
+				continue;
+
+			/*
+			 * Without any event, only the sensors due have work
+			 * to do. The others are ready, unless they are read
+			 * on a schedule or are not set up.
+			 */
+			if (!(event & (TASK_EVENT_MOTION_ODR_CHANGE |
+				       TASK_EVENT_MOTION_FLUSH_PENDING |
+				       TASK_EVENT_MOTION_INTERRUPT_MASK)) &&
+			    !(due & BIT(i))) {
+				if (sensor->state == SENSOR_READY &&
+				    !motion_sensor_in_forced_mode(sensor))
+					ready_status |= BIT(i);
+				continue;
 			}
+
+			motion_sense_trace(i, MOTIONSENSE_TRACE_TASK);
+			ret = motion_sense_process(sensor, &event,
+						   &ts_begin_task,
+						   due & BIT(i));
+			if (ret != EC_SUCCESS)
+				continue;
+			ready_status |= BIT(i);
 		}
+		deadline_queue_requeue(due);
 		if (IS_ENABLED(CONFIG_GESTURE_DETECTION))
 			check_and_queue_gestures(&event);
 		if (IS_ENABLED(CONFIG_LID_ANGLE)) {
@@ -1017,38 +1173,38 @@ void motion_sense_task(void *u)
 			       sensor_active == SENSOR_ACTIVE_S0) ||
 			      motion_sense_fifo_wake_up_needed()))) {
 				mkbp_send_event(EC_MKBP_EVENT_SENSOR_FIFO);
+				motion_sense_fifo_interrupt_sent();
 			}
 			motion_sense_fifo_reset_needed_flags();
+		} else if (IS_ENABLED(CONFIG_ACCEL_FIFO)) {
+			motion_sense_fifo_interrupt_deferred();
 		}
 
 		ts_end_task = get_time();
 		wait_us = -1;
-		uint32_t fastest_collection_rate = UINT32_MAX;
+		if (atomic_clear(&deadline_queue_stale))
+			deadline_queue_rebuild();
 
-		for (i = 0; i < motion_sensor_count; i++) {
-			struct motion_sensor_t *sensor = &motion_sensors[i];
+		for (i = 0; i < deadline_queue_len; i++) {
+			struct motion_sensor_t *sensor =
+				&motion_sensors[deadline_queue[i]];
 			enum sensor_config cfg_index =
 				motion_sense_get_ec_config();
 			int ec_rate = 0;
 
-			if (sensor->collection_rate > 0 &&
-			    sensor->collection_rate < fastest_collection_rate) {
-				fastest_collection_rate =
-					sensor->collection_rate;
-			}
+			time_diff = time_until(ts_end_task.le.lo,
+					       sensor->next_collection);
 
-			if (!motion_sensor_in_forced_mode(sensor) ||
-			    sensor->collection_rate == 0)
-				continue;
+			/* The queue is sorted, no later sensor wakes sooner. */
+			if (wait_us != -1 && time_diff >= wait_us)
+				break;
 
 			if (IS_ENABLED(CONFIG_SENSOR_EC_RATE_FORCE_MODE) &&
 			    cfg_index != SENSOR_CONFIG_EC_S0) {
 				ec_rate = sensor->config[cfg_index].ec_rate;
 			}
 
-			time_diff = MAX(time_until(ts_end_task.le.lo,
-						   sensor->next_collection),
-					ec_rate);
+			time_diff = MAX(time_diff, ec_rate);
 
 			/* We missed our collection time so wake soon */
 			if (time_diff <= 0) {
@@ -1432,6 +1588,68 @@ static enum ec_status host_cmd_motion_sense(struct host_cmd_handler_args *args)
 			&(args->response_size));
 		args->response_size += sizeof(out->fifo_read);
 		break;
+	case MOTIONSENSE_CMD_FIFO_READ_DELTA:
+		if (!IS_ENABLED(CONFIG_ACCEL_FIFO))
+			return EC_RES_INVALID_PARAM;
+		out->fifo_read_delta.number_data = motion_sense_fifo_read_delta(
+			args->response_max - sizeof(out->fifo_read_delta),
+			in->fifo_read.max_data_vector,
+			out->fifo_read_delta.data, &(args->response_size));
+		out->fifo_read_delta.size = args->response_size;
+		args->response_size += sizeof(out->fifo_read_delta);
+		break;
+	case MOTIONSENSE_CMD_TRACE_READ:
+		if (!IS_ENABLED(CONFIG_ACCEL_TRACE))
+			return EC_RES_INVALID_PARAM;
+		out->trace_read.count = motion_sense_trace_read(
+			out->trace_read.entries,
+			MIN(in->fifo_read.max_data_vector,
+			    (args->response_max - sizeof(out->trace_read)) /
+				    sizeof(out->trace_read.entries[0])),
+			&out->trace_read.lost);
+		args->response_size =
+			sizeof(out->trace_read) +
+			out->trace_read.count *
+				sizeof(out->trace_read.entries[0]);
+		break;
+	case MOTIONSENSE_CMD_SCHED_STATS: {
+		struct motion_sense_sched_stats *stats;
+
+		if (in->sched_stats.sensor_num >= motion_sensor_count)
+			return EC_RES_INVALID_PARAM;
+		stats = &sched_stats[in->sched_stats.sensor_num];
+
+		/* Take a consistent snapshot, without losing updates on reset */
+		mutex_lock(&g_sensor_mutex);
+		out->sched_stats.reads = stats->reads;
+		out->sched_stats.late_reads = stats->late_reads;
+		out->sched_stats.missed_reads = stats->missed_reads;
+		out->sched_stats.jitter_avg_us =
+			stats->reads ? stats->jitter_sum_us / stats->reads : 0;
+		out->sched_stats.jitter_max_us = stats->jitter_max_us;
+		if (in->sched_stats.reset)
+			memset(stats, 0, sizeof(*stats));
+		mutex_unlock(&g_sensor_mutex);
+		args->response_size = sizeof(out->sched_stats);
+		break;
+	}
+	case MOTIONSENSE_CMD_FIFO_COALESCE: {
+		const uint8_t flags = in->fifo_coalesce.flags;
+
+		if (!IS_ENABLED(CONFIG_ACCEL_FIFO) ||
+		    in->fifo_coalesce.sensor_num >= motion_sensor_count)
+			return EC_RES_INVALID_PARAM;
+		if (flags & MOTIONSENSE_FIFO_COALESCE_SET)
+			motion_sense_fifo_set_coalesce(
+				in->fifo_coalesce.sensor_num,
+				in->fifo_coalesce.max_latency_ms * MSEC,
+				in->fifo_coalesce.max_events);
+		motion_sense_fifo_get_coalesce(
+			in->fifo_coalesce.sensor_num, &out->fifo_coalesce,
+			flags & MOTIONSENSE_FIFO_COALESCE_RESET);
+		args->response_size = sizeof(out->fifo_coalesce);
+		break;
+	}
 	case MOTIONSENSE_CMD_FIFO_INT_ENABLE:
 		if (!IS_ENABLED(CONFIG_ACCEL_FIFO))
 			return EC_RES_INVALID_PARAM;
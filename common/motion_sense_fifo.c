@@ -5,10 +5,12 @@
 
 #include "accelgyro.h"
 #include "console.h"
+#include "hooks.h"
 #include "hwtimer.h"
 #include "math_util.h"
 #include "mkbp_event.h"
 #include "motion_sense_fifo.h"
+#include "motion_sense_trace.h"
 #include "stdbool.h"
 #include "tablet_mode.h"
 #include "task.h"
@@ -24,11 +26,13 @@
  *	currently staged.
  * @requires_spreading: Flag used to shortcut the commit process. This should be
  *	true iff at least one of sample_count[] > 1
+ * @sensors: Bitmap of the sensors with data staged.
  */
 struct fifo_staged {
 	uint16_t count;
 	uint8_t sample_count[MAX_MOTION_SENSORS];
 	uint8_t requires_spreading;
+	uint32_t sensors;
 };
 
 /**
@@ -72,6 +76,21 @@ static uint32_t expected_data_periods[MAX_MOTION_SENSORS];
  */
 static uint32_t next_timestamp_initialized;
 
+/**
+ * Per sensor references of MOTIONSENSE_CMD_FIFO_READ_DELTA, reset for every
+ * response.
+ * @has_timestamp / @timestamp: Last timestamp entry of the sensor.
+ * @has_data / @data: Last data entry of the sensor.
+ */
+struct fifo_delta_ref {
+	bool has_timestamp;
+	bool has_data;
+	uint32_t timestamp;
+	int16_t data[3];
+};
+
+static struct fifo_delta_ref fifo_delta_refs[MAX_MOTION_SENSORS];
+
 /** Need to bypass the FIFO for an important message. */
 static int bypass_needed;
 
@@ -87,6 +106,45 @@ static int ap_interrupt_needed;
  */
 uint32_t ts_last_int[MAX_MOTION_SENSORS];
 
+/**
+ * Interrupt coalescing policy of a sensor, see
+ * MOTIONSENSE_CMD_FIFO_COALESCE.
+ * @max_latency_us: Longest time an event may wait for an interrupt, 0 when
+ *	the sensor interrupts the AP every ec_rate.
+ * @max_events: Most events pending before an interrupt, 0 for no limit.
+ * @events: Events of the sensor since the last interrupt.
+ * @since: Time of the first of them.
+ */
+struct fifo_coalesce {
+	uint32_t max_latency_us;
+	uint16_t max_events;
+	uint16_t events;
+	uint32_t since;
+};
+
+static struct fifo_coalesce fifo_coalesce[MAX_MOTION_SENSORS];
+
+/** Bitmap of the coalesced sensors with pending events. */
+static uint32_t fifo_coalesce_pending;
+
+/**
+ * Earliest deadline of the pending events, when fifo_coalesce_armed. The
+ * motion task is woken up then, in case no new sample triggers the interrupt.
+ */
+static bool fifo_coalesce_armed;
+static uint32_t fifo_coalesce_deadline;
+
+/**
+ * Same as ap_interrupt_needed and ts_last_int, as if no sensor had a
+ * coalescing policy, to count the interrupts saved.
+ */
+static bool ec_rate_interrupt_needed;
+static uint32_t ts_ec_rate_int[MAX_MOTION_SENSORS];
+
+/** MKBP events sent to the AP, and interrupts coalesced away. */
+static uint32_t fifo_interrupts;
+static uint32_t fifo_interrupts_saved;
+
 /**
  * Check whether or not a give sensor data entry is a timestamp or not.
  *
@@ -242,23 +300,20 @@ static inline bool is_new_timestamp(uint8_t sensor_num)
  * Stage a single data unit to the motion sense fifo. Note that for the AP to
  * see this data, it must be committed.
  *
+ * WARNING: This function MUST be called from within a locked context of
+ * g_sensor_mutex.
+ *
  * @param data The data to stage.
  * @param sensor The sensor that generated the data
  * @param valid_data The number of readable data entries in the data.
- *   sensor can be NULL (for activity sensors). valid_data must be 0 then.
  */
-test_export_static void
-fifo_stage_unit(struct ec_response_motion_sensor_data *data,
-		struct motion_sensor_t *sensor, int valid_data)
+static void fifo_stage_unit_locked(struct ec_response_motion_sensor_data *data,
+				   struct motion_sensor_t *sensor,
+				   int valid_data)
 {
 	struct queue_chunk chunk;
 	int i;
 
-	if (valid_data > 0 && !sensor)
-		return;
-
-	mutex_lock(&g_sensor_mutex);
-
 	for (i = 0; i < valid_data; i++)
 		sensor->xyz[i] = data->data[i];
 
@@ -283,10 +338,8 @@ fifo_stage_unit(struct ec_response_motion_sensor_data *data,
 			removed = sensor->oversampling++;
 			sensor->oversampling %= sensor->oversampling_ratio;
 		}
-		if (removed) {
-			mutex_unlock(&g_sensor_mutex);
+		if (removed)
 			return;
-		}
 	}
 
 	/* Make sure we have room for the data */
@@ -311,7 +364,6 @@ fifo_stage_unit(struct ec_response_motion_sensor_data *data,
 		 * address 0. Just don't add any data to the queue instead.
 		 */
 		CPRINTS("Failed to get write chunk for new fifo data!");
-		mutex_unlock(&g_sensor_mutex);
 		return;
 	}
 
@@ -326,6 +378,11 @@ fifo_stage_unit(struct ec_response_motion_sensor_data *data,
 	memcpy(chunk.buffer, data, fifo.unit_bytes);
 	fifo_staged.count++;
 
+	if (is_data(data) && !(fifo_staged.sensors & BIT(data->sensor_num))) {
+		fifo_staged.sensors |= BIT(data->sensor_num);
+		motion_sense_trace(data->sensor_num, MOTIONSENSE_TRACE_STAGE);
+	}
+
 	/*
 	 * If we're using tight timestamps, and the current entry isn't a
 	 * timestamp we'll increment the sample_count for the given sensor.
@@ -335,7 +392,26 @@ fifo_stage_unit(struct ec_response_motion_sensor_data *data,
 	if (IS_ENABLED(CONFIG_SENSOR_TIGHT_TIMESTAMPS) && !is_timestamp(data) &&
 	    ++fifo_staged.sample_count[data->sensor_num] > 1)
 		fifo_staged.requires_spreading = 1;
+}
 
+/**
+ * Stage a single data unit to the motion sense fifo. Note that for the AP to
+ * see this data, it must be committed.
+ *
+ * @param data The data to stage.
+ * @param sensor The sensor that generated the data
+ * @param valid_data The number of readable data entries in the data.
+ *   sensor can be NULL (for activity sensors). valid_data must be 0 then.
+ */
+test_export_static void
+fifo_stage_unit(struct ec_response_motion_sensor_data *data,
+		struct motion_sensor_t *sensor, int valid_data)
+{
+	if (valid_data > 0 && !sensor)
+		return;
+
+	mutex_lock(&g_sensor_mutex);
+	fifo_stage_unit_locked(data, sensor, valid_data);
 	mutex_unlock(&g_sensor_mutex);
 }
 
@@ -356,6 +432,19 @@ static void fifo_stage_timestamp(uint32_t timestamp, uint8_t sensor_num)
 	fifo_stage_unit(&vector, NULL, 0);
 }
 
+/**
+ * Same as fifo_stage_timestamp(), for callers already holding g_sensor_mutex.
+ */
+static void fifo_stage_timestamp_locked(uint32_t timestamp, uint8_t sensor_num)
+{
+	struct ec_response_motion_sensor_data vector;
+
+	vector.flags = MOTIONSENSE_SENSOR_FLAG_TIMESTAMP;
+	vector.timestamp = timestamp;
+	vector.sensor_num = sensor_num;
+	fifo_stage_unit_locked(&vector, NULL, 0);
+}
+
 /**
  * Peek into the staged data at a given offset. This function performs no bound
  * checking and is purely for confinience.
@@ -375,8 +464,36 @@ void motion_sense_fifo_init(void)
 {
 }
 
+/**
+ * Flag an AP interrupt when a pending event would wait past its latency by
+ * <time>.
+ *
+ * @param time Time the next interrupt could be sent otherwise.
+ */
+static void fifo_coalesce_check(uint32_t time)
+{
+	uint32_t pending = fifo_coalesce_pending;
+	uint32_t deadline;
+	int i;
+
+	while (pending && !ap_interrupt_needed) {
+		i = __fls(pending);
+		pending &= ~BIT(i);
+		deadline = fifo_coalesce[i].since +
+			   fifo_coalesce[i].max_latency_us;
+		if (time_after(time, deadline))
+			ap_interrupt_needed = 1;
+	}
+}
+
 int motion_sense_fifo_interrupt_needed(void)
 {
+	/*
+	 * Flush the events that reached their latency without a new sample,
+	 * fifo_coalesce_expired() wakes the motion task up by then.
+	 */
+	if (!ap_interrupt_needed && fifo_coalesce_pending)
+		fifo_coalesce_check(__hw_clock_source_read() + 1);
 	return ap_interrupt_needed;
 }
 
@@ -390,6 +507,61 @@ int motion_sense_fifo_wake_up_needed(void)
 	return wake_up_needed;
 }
 
+/**
+ * Restart the ec_rate periods of the shadow interrupts, like
+ * motion_sense_fifo_reset_needed_flags() does for ts_last_int.
+ */
+static void fifo_ec_rate_interrupt_done(void)
+{
+	int i;
+
+	ec_rate_interrupt_needed = false;
+	for (i = 0; i < MAX_MOTION_SENSORS; i++)
+		if (!is_new_timestamp(i))
+			ts_ec_rate_int[i] = next_timestamp[i].prev;
+}
+
+static void fifo_coalesce_expired(void)
+{
+	/* motion_sense_fifo_interrupt_needed() flushes the late events. */
+#ifdef HAS_TASK_MOTIONSENSE
+	task_wake(TASK_ID_MOTIONSENSE);
+#endif
+}
+DECLARE_DEFERRED(fifo_coalesce_expired);
+
+/**
+ * Wake the motion task up at <deadline>, unless it is already woken up
+ * earlier for another sensor.
+ */
+static void fifo_coalesce_arm(uint32_t deadline)
+{
+	int delay;
+
+	if (fifo_coalesce_armed &&
+	    !time_after(fifo_coalesce_deadline, deadline))
+		return;
+
+	fifo_coalesce_armed = true;
+	fifo_coalesce_deadline = deadline;
+	delay = time_until(__hw_clock_source_read(), deadline);
+	hook_call_deferred(&fifo_coalesce_expired_data, MAX(delay, 0));
+}
+
+static void fifo_coalesce_disarm(void)
+{
+	if (!fifo_coalesce_armed)
+		return;
+
+	fifo_coalesce_armed = false;
+	hook_call_deferred(&fifo_coalesce_expired_data, -1);
+}
+
+void motion_sense_fifo_interrupt_sent(void)
+{
+	fifo_interrupts++;
+}
+
 void motion_sense_fifo_reset_needed_flags(void)
 {
 	int i;
@@ -404,6 +576,15 @@ void motion_sense_fifo_reset_needed_flags(void)
 			if (!is_new_timestamp(i))
 				ts_last_int[i] = next_timestamp[i].prev;
 	}
+	if (ec_rate_interrupt_needed)
+		fifo_ec_rate_interrupt_done();
+
+	/* The AP reads all the pending events. */
+	for (i = 0; i < MAX_MOTION_SENSORS; i++)
+		fifo_coalesce[i].events = 0;
+	fifo_coalesce_pending = 0;
+	fifo_coalesce_disarm();
+
 	next_timestamp_initialized = 0;
 	wake_up_needed = 0;
 	bypass_needed = 0;
@@ -428,15 +609,28 @@ inline void motion_sense_fifo_add_timestamp(uint32_t timestamp)
 	motion_sense_fifo_commit_data();
 }
 
-void motion_sense_fifo_stage_data(struct ec_response_motion_sensor_data *data,
-				  struct motion_sensor_t *sensor,
-				  int valid_data, uint32_t time)
+void motion_sense_fifo_interrupt_deferred(void)
 {
-	int id = data->sensor_num;
-
-	if (IS_ENABLED(CONFIG_SENSOR_TIGHT_TIMESTAMPS)) {
-		fifo_stage_timestamp(time, data->sensor_num);
+	/* The ec_rate of a sensor was due, the policies held it back. */
+	if (ec_rate_interrupt_needed) {
+		fifo_interrupts_saved++;
+		fifo_ec_rate_interrupt_done();
 	}
+}
+
+/**
+ * Check if the sample at <time> is close enough to the sensor EC rate since
+ * the last interrupt.
+ *
+ * @param id Sensor number of the sample.
+ * @param sensor The sensor the sample comes from, may be NULL.
+ * @param time Time the sample was taken at.
+ * @param ts_int Time of the last event sent with the last interrupt.
+ * @return true when the AP expects an interrupt.
+ */
+static bool fifo_ec_rate_due(int id, struct motion_sensor_t *sensor,
+			     uint32_t time, uint32_t ts_int)
+{
 	/*
 	 * If there is a sensor associated and the AP needs the sensor data and
 	 * the current timestamp is close to the time we need to trigger an
@@ -462,16 +656,118 @@ void motion_sense_fifo_stage_data(struct ec_response_motion_sensor_data *data,
 	 * + <-------- ec_rate (5ms) ---------->
 	 *                 <--------- time allowed for new interrupt
 	 */
-	if (sensor && sensor->config[SENSOR_CONFIG_AP].ec_rate > 0 &&
-	    BASE_ODR(sensor->config[SENSOR_CONFIG_AP].odr > 0) &&
-	    time_after(time, ts_last_int[id] +
-				     sensor->config[SENSOR_CONFIG_AP].ec_rate -
-				     expected_data_periods[id] / 2)) {
+	return sensor && sensor->config[SENSOR_CONFIG_AP].ec_rate > 0 &&
+	       BASE_ODR(sensor->config[SENSOR_CONFIG_AP].odr > 0) &&
+	       time_after(time,
+			  ts_int + sensor->config[SENSOR_CONFIG_AP].ec_rate -
+				  expected_data_periods[id] / 2);
+}
+
+/**
+ * Account the sample of a coalesced sensor and flag an AP interrupt when any
+ * pending event would wait too long for the next motion task round, or when
+ * the sensor has too many events pending. The interrupt flushes the events of
+ * all the sensors.
+ *
+ * @param id Sensor number of the sample.
+ * @param sensor The sensor the sample comes from, may be NULL.
+ * @param time Time the sample was taken at.
+ */
+static void fifo_coalesce_add(int id, struct motion_sensor_t *sensor,
+			      uint32_t time)
+{
+	struct fifo_coalesce *policy = &fifo_coalesce[id];
+
+	if (policy->max_latency_us && sensor &&
+	    BASE_ODR(sensor->config[SENSOR_CONFIG_AP].odr) > 0) {
+		if (!policy->events++) {
+			policy->since = time;
+			fifo_coalesce_pending |= BIT(id);
+			fifo_coalesce_arm(time + policy->max_latency_us);
+		}
+		if (policy->max_events && policy->events >= policy->max_events)
+			ap_interrupt_needed = 1;
+	}
+
+	/* The sensor produces its next sample by then. */
+	fifo_coalesce_check(time + expected_data_periods[id]);
+}
+
+/**
+ * Flag an AP interrupt if the sample at <time> is close enough to the sensor
+ * EC rate since the last interrupt, or to the limits of the coalescing
+ * policies.
+ *
+ * @param id Sensor number of the sample.
+ * @param sensor The sensor the sample comes from, may be NULL.
+ * @param time Time the sample was taken at.
+ */
+static void fifo_check_interrupt_needed(int id, struct motion_sensor_t *sensor,
+					uint32_t time)
+{
+	if (!fifo_coalesce[id].max_latency_us &&
+	    fifo_ec_rate_due(id, sensor, time, ts_last_int[id]))
 		ap_interrupt_needed = 1;
+
+	fifo_coalesce_add(id, sensor, time);
+
+	if (fifo_ec_rate_due(id, sensor, time, ts_ec_rate_int[id]))
+		ec_rate_interrupt_needed = true;
+}
+
+void motion_sense_fifo_stage_data(struct ec_response_motion_sensor_data *data,
+				  struct motion_sensor_t *sensor,
+				  int valid_data, uint32_t time)
+{
+	if (IS_ENABLED(CONFIG_SENSOR_TIGHT_TIMESTAMPS)) {
+		fifo_stage_timestamp(time, data->sensor_num);
 	}
+	fifo_check_interrupt_needed(data->sensor_num, sensor, time);
 	fifo_stage_unit(data, sensor, valid_data);
 }
 
+void motion_sense_fifo_batch_add(struct motion_sense_fifo_batch *batch,
+				 struct motion_sensor_t *sensor, const int *v)
+{
+	struct ec_response_motion_sensor_data *data =
+		&batch->data[batch->count];
+
+	data->flags = 0;
+	data->sensor_num = sensor - motion_sensors;
+	data->data[X] = v[X];
+	data->data[Y] = v[Y];
+	data->data[Z] = v[Z];
+
+	if (++batch->count == ARRAY_SIZE(batch->data))
+		motion_sense_fifo_batch_flush(batch);
+}
+
+void motion_sense_fifo_batch_flush(struct motion_sense_fifo_batch *batch)
+{
+	struct ec_response_motion_sensor_data *data;
+	struct motion_sensor_t *sensor;
+	int i;
+
+	if (!batch->count)
+		return;
+
+	mutex_lock(&g_sensor_mutex);
+	for (i = 0; i < batch->count; i++) {
+		data = &batch->data[i];
+		sensor = &motion_sensors[data->sensor_num];
+
+		if (IS_ENABLED(CONFIG_SENSOR_TIGHT_TIMESTAMPS))
+			fifo_stage_timestamp_locked(batch->time,
+						    data->sensor_num);
+		fifo_check_interrupt_needed(data->sensor_num, sensor,
+					    batch->time);
+		fifo_stage_unit_locked(data, sensor, 3);
+	}
+	mutex_unlock(&g_sensor_mutex);
+
+	batch->count = 0;
+}
+
 void motion_sense_fifo_commit_data(void)
 {
 	struct ec_response_motion_sensor_data *data;
@@ -566,6 +862,17 @@ commit_data_end:
 	/* Advance the tail and clear the staged metadata. */
 	queue_advance_tail(&fifo, fifo_staged.count);
 
+	if (IS_ENABLED(CONFIG_ACCEL_TRACE)) {
+		uint32_t sensors = fifo_staged.sensors;
+
+		while (sensors) {
+			sensor_num = __fls(sensors);
+			sensors &= ~BIT(sensor_num);
+			motion_sense_trace(sensor_num,
+					   MOTIONSENSE_TRACE_COMMIT);
+		}
+	}
+
 	/* Reset metadata for next staging cycle. */
 	memset(&fifo_staged, 0, sizeof(fifo_staged));
 
@@ -607,6 +914,35 @@ static int motion_sense_get_next_event(uint8_t *out)
 /* LCOV_EXCL_STOP */
 DECLARE_EVENT_SOURCE(EC_MKBP_EVENT_SENSOR_FIFO, motion_sense_get_next_event);
 
+void motion_sense_fifo_set_coalesce(int sensor_num, uint32_t max_latency_us,
+				    uint16_t max_events)
+{
+	struct fifo_coalesce *policy = &fifo_coalesce[sensor_num];
+
+	mutex_lock(&g_sensor_mutex);
+	policy->max_latency_us = max_latency_us;
+	policy->max_events = max_latency_us ? max_events : 0;
+	policy->events = 0;
+	fifo_coalesce_pending &= ~BIT(sensor_num);
+	mutex_unlock(&g_sensor_mutex);
+}
+
+void motion_sense_fifo_get_coalesce(
+	int sensor_num, struct ec_response_motion_sense_fifo_coalesce *out,
+	int reset)
+{
+	mutex_lock(&g_sensor_mutex);
+	out->max_latency_ms = fifo_coalesce[sensor_num].max_latency_us / MSEC;
+	out->max_events = fifo_coalesce[sensor_num].max_events;
+	out->interrupts = fifo_interrupts;
+	out->interrupts_saved = fifo_interrupts_saved;
+	if (reset) {
+		fifo_interrupts = 0;
+		fifo_interrupts_saved = 0;
+	}
+	mutex_unlock(&g_sensor_mutex);
+}
+
 inline int motion_sense_fifo_over_thres(void)
 {
 	int result;
@@ -629,6 +965,107 @@ int motion_sense_fifo_read(int capacity_bytes, int max_count, void *out,
 	count = queue_remove_units(&fifo, out, count);
 	mutex_unlock(&g_sensor_mutex);
 	*out_size = count * fifo.unit_bytes;
+	if (count)
+		motion_sense_trace(MOTIONSENSE_TRACE_NO_SENSOR,
+				   MOTIONSENSE_TRACE_HOST_READ);
+
+	return count;
+}
+
+/**
+ * Delta encode one fifo entry, see struct ec_response_motion_sense_fifo_delta.
+ *
+ * @param v The fifo entry.
+ * @param out Buffer of at least MOTIONSENSE_FIFO_DELTA_MAX_ENTRY_SIZE bytes.
+ * @return The number of bytes written to out.
+ */
+static int fifo_delta_encode(const struct ec_response_motion_sensor_data *v,
+			     uint8_t *out)
+{
+	struct fifo_delta_ref *ref = NULL;
+	int kind = MOTIONSENSE_FIFO_DELTA_RAW;
+	int size = 1;
+	int delta[3];
+	int i;
+
+	if (v->sensor_num < ARRAY_SIZE(fifo_delta_refs) &&
+	    v->sensor_num < MOTIONSENSE_FIFO_DELTA_MAX_SENSORS)
+		ref = &fifo_delta_refs[v->sensor_num];
+
+	if (v->flags & MOTIONSENSE_SENSOR_FLAG_TIMESTAMP) {
+		uint32_t dt = v->timestamp - (ref ? ref->timestamp : 0);
+
+		if (v->flags == MOTIONSENSE_SENSOR_FLAG_TIMESTAMP && ref &&
+		    ref->has_timestamp && dt <= UINT16_MAX) {
+			kind = MOTIONSENSE_FIFO_DELTA_TIMESTAMP;
+			out[size++] = dt & 0xff;
+			out[size++] = dt >> 8;
+		}
+		if (ref) {
+			ref->has_timestamp = true;
+			ref->timestamp = v->timestamp;
+		}
+	} else {
+		if (v->flags == 0 && ref) {
+			kind = MOTIONSENSE_FIFO_DELTA_AXES16;
+			for (i = 0; i < 3; i++) {
+				delta[i] = v->data[i] - ref->data[i];
+				if (delta[i] < INT8_MIN || delta[i] > INT8_MAX)
+					break;
+			}
+			if (ref->has_data && i == 3)
+				kind = MOTIONSENSE_FIFO_DELTA_AXES8;
+			for (i = 0; i < 3; i++) {
+				if (kind == MOTIONSENSE_FIFO_DELTA_AXES8) {
+					out[size++] = (int8_t)delta[i];
+				} else {
+					out[size++] = v->data[i] & 0xff;
+					out[size++] = (uint16_t)v->data[i] >> 8;
+				}
+			}
+		}
+		if (ref) {
+			ref->has_data = true;
+			memcpy(ref->data, v->data, sizeof(ref->data));
+		}
+	}
+
+	/* Raw entries carry their own sensor number. */
+	out[0] = kind << MOTIONSENSE_FIFO_DELTA_KIND_SHIFT;
+	if (kind == MOTIONSENSE_FIFO_DELTA_RAW) {
+		memcpy(&out[size], v, sizeof(*v));
+		size += sizeof(*v);
+	} else {
+		out[0] |= v->sensor_num;
+	}
+	return size;
+}
+
+int motion_sense_fifo_read_delta(int capacity_bytes, int max_count,
+				 uint8_t *out, uint16_t *out_size)
+{
+	struct ec_response_motion_sensor_data v;
+	uint8_t entry[MOTIONSENSE_FIFO_DELTA_MAX_ENTRY_SIZE];
+	int count, size;
+	int used = 0;
+
+	mutex_lock(&g_sensor_mutex);
+	memset(fifo_delta_refs, 0, sizeof(fifo_delta_refs));
+	max_count = MIN(queue_count(&fifo), max_count);
+	for (count = 0; count < max_count; count++) {
+		queue_peek_units(&fifo, &v, count, 1);
+		size = fifo_delta_encode(&v, entry);
+		if (used + size > capacity_bytes)
+			break;
+		memcpy(&out[used], entry, size);
+		used += size;
+	}
+	queue_advance_head(&fifo, count);
+	mutex_unlock(&g_sensor_mutex);
+	*out_size = used;
+	if (count)
+		motion_sense_trace(MOTIONSENSE_TRACE_NO_SENSOR,
+				   MOTIONSENSE_TRACE_HOST_READ);
 
 	return count;
 }
@@ -643,6 +1080,12 @@ void motion_sense_fifo_reset(void)
 
 	next_timestamp_initialized = 0;
 	memset(&fifo_staged, 0, sizeof(fifo_staged));
+	memset(fifo_coalesce, 0, sizeof(fifo_coalesce));
+	fifo_coalesce_pending = 0;
+	fifo_coalesce_disarm();
+	ec_rate_interrupt_needed = false;
+	fifo_interrupts = 0;
+	fifo_interrupts_saved = 0;
 	motion_sense_fifo_init();
 	queue_init(&fifo);
 	motion_sense_fifo_get_info(fifo_info, /*reset=*/true);
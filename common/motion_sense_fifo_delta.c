@@ -0,0 +1,79 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Decoder of the delta encoded motion sense FIFO, shared with ectool */
+
+#include "motion_sense_fifo_delta.h"
+
+#include <string.h>
+
+int motion_sense_fifo_delta_decode(const uint8_t *in, int size, int count,
+				   struct ec_response_motion_sensor_data *out)
+{
+	uint32_t ts_ref[MOTIONSENSE_FIFO_DELTA_MAX_SENSORS] = { 0 };
+	int16_t data_ref[MOTIONSENSE_FIFO_DELTA_MAX_SENSORS][3] = { { 0 } };
+	struct ec_response_motion_sensor_data *v;
+	int pos = 0;
+	int kind, len;
+	int i, j;
+
+	for (i = 0; i < count; i++) {
+		if (pos >= size)
+			return -1;
+		v = &out[i];
+		kind = in[pos] >> MOTIONSENSE_FIFO_DELTA_KIND_SHIFT;
+		memset(v, 0, sizeof(*v));
+		v->sensor_num = in[pos++] & MOTIONSENSE_FIFO_DELTA_SENSOR_MASK;
+
+		switch (kind) {
+		case MOTIONSENSE_FIFO_DELTA_RAW:
+			len = sizeof(*v);
+			break;
+		case MOTIONSENSE_FIFO_DELTA_TIMESTAMP:
+			len = 2;
+			break;
+		case MOTIONSENSE_FIFO_DELTA_AXES8:
+			len = 3;
+			break;
+		default:
+			len = 6;
+			break;
+		}
+		if (pos + len > size)
+			return -1;
+
+		switch (kind) {
+		case MOTIONSENSE_FIFO_DELTA_RAW:
+			memcpy(v, &in[pos], len);
+			break;
+		case MOTIONSENSE_FIFO_DELTA_TIMESTAMP:
+			v->flags = MOTIONSENSE_SENSOR_FLAG_TIMESTAMP;
+			v->timestamp = ts_ref[v->sensor_num] +
+				       (in[pos] | in[pos + 1] << 8);
+			break;
+		case MOTIONSENSE_FIFO_DELTA_AXES8:
+			for (j = 0; j < 3; j++)
+				v->data[j] = data_ref[v->sensor_num][j] +
+					     (int8_t)in[pos + j];
+			break;
+		default:
+			for (j = 0; j < 3; j++)
+				v->data[j] = in[pos + 2 * j] |
+					     in[pos + 2 * j + 1] << 8;
+			break;
+		}
+		pos += len;
+
+		/* Raw entries may come from sensors with no reference. */
+		if (v->sensor_num >= MOTIONSENSE_FIFO_DELTA_MAX_SENSORS)
+			continue;
+		if (v->flags & MOTIONSENSE_SENSOR_FLAG_TIMESTAMP)
+			ts_ref[v->sensor_num] = v->timestamp;
+		else
+			memcpy(data_ref[v->sensor_num], v->data,
+			       sizeof(data_ref[0]));
+	}
+	return pos;
+}
@@ -0,0 +1 @@
+motion_sense_fifo_delta.c
\ No newline at end of file
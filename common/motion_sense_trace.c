@@ -0,0 +1,72 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Motion sensor read path trace */
+
+#include "common.h"
+#include "motion_sense_trace.h"
+#include "task.h"
+#include "util.h"
+
+BUILD_ASSERT(POWER_OF_TWO(CONFIG_ACCEL_TRACE_SIZE));
+#define TRACE_MASK (CONFIG_ACCEL_TRACE_SIZE - 1)
+
+static struct ec_motion_sense_trace_entry trace[CONFIG_ACCEL_TRACE_SIZE];
+
+/*
+ * "trace_head" is the oldest entry, "trace_tail" is the next entry to write.
+ * They are not wrapped until they are used, so a full buffer is told apart
+ * from an empty one. Entries are written from the motion sense task and the
+ * host command task, so both are protected by a short critical section.
+ */
+static uint32_t trace_head;
+static uint32_t trace_tail;
+static uint16_t trace_lost;
+
+void motion_sense_trace_at(int sensor_num, enum motionsense_trace_point point,
+			   uint32_t timestamp)
+{
+	struct ec_motion_sense_trace_entry *entry;
+	uint32_t lock_key;
+
+	lock_key = irq_lock();
+	if (trace_tail - trace_head == CONFIG_ACCEL_TRACE_SIZE) {
+		trace_head++;
+		if (trace_lost < UINT16_MAX)
+			trace_lost++;
+	}
+	entry = &trace[trace_tail++ & TRACE_MASK];
+	entry->timestamp = timestamp;
+	entry->sensor_num = sensor_num;
+	entry->point = point;
+	irq_unlock(lock_key);
+}
+
+int motion_sense_trace_read(struct ec_motion_sense_trace_entry *out,
+			    int max_count, uint16_t *lost)
+{
+	uint32_t lock_key;
+	int count, i;
+
+	lock_key = irq_lock();
+	count = MIN(max_count, (int)(trace_tail - trace_head));
+	for (i = 0; i < count; i++)
+		out[i] = trace[trace_head++ & TRACE_MASK];
+	*lost = trace_lost;
+	trace_lost = 0;
+	irq_unlock(lock_key);
+
+	return count;
+}
+
+void motion_sense_trace_reset(void)
+{
+	uint32_t lock_key;
+
+	lock_key = irq_lock();
+	trace_head = trace_tail;
+	trace_lost = 0;
+	irq_unlock(lock_key);
+}
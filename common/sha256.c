@@ -211,23 +211,6 @@ void SHA256_update(struct sha256_ctx *ctx, const uint8_t *data, uint32_t len)
 	ctx->tot_len += (block_nb + 1) << 6;
 }
 
-/*
- * Specialized SHA256_init + SHA256_update that takes the first data block of
- * size SHA256_BLOCK_SIZE as input.
- */
-static void SHA256_init_1b(struct sha256_ctx *ctx, const uint8_t *data)
-{
-	int i;
-
-	for (i = 0; i < 8; i++)
-		ctx->h[i] = sha256_h0[i];
-
-	SHA256_transform(ctx, data, 1);
-
-	ctx->len = 0;
-	ctx->tot_len = SHA256_BLOCK_SIZE;
-}
-
 uint8_t *SHA256_final(struct sha256_ctx *ctx)
 {
 	unsigned int block_nb;
@@ -253,6 +236,28 @@ uint8_t *SHA256_final(struct sha256_ctx *ctx)
 	return ctx->buf;
 }
 
+/*
+ * Host tools (e.g. ectool) only need the plain hash and have no ASSERT()
+ * handler, so leave HMAC out of their build.
+ */
+#ifndef HOST_TOOLS_BUILD
+/*
+ * Specialized SHA256_init + SHA256_update that takes the first data block of
+ * size SHA256_BLOCK_SIZE as input.
+ */
+static void SHA256_init_1b(struct sha256_ctx *ctx, const uint8_t *data)
+{
+	int i;
+
+	for (i = 0; i < 8; i++)
+		ctx->h[i] = sha256_h0[i];
+
+	SHA256_transform(ctx, data, 1);
+
+	ctx->len = 0;
+	ctx->tot_len = SHA256_BLOCK_SIZE;
+}
+
 static void hmac_SHA256_step(uint8_t *output, uint8_t mask, const uint8_t *key,
 			     const int key_len, const uint8_t *data,
 			     const int data_len)
@@ -294,3 +299,4 @@ void hmac_SHA256(uint8_t *output, const uint8_t *key, const int key_len,
 	hmac_SHA256_step(output, 0x5c, key, key_len, output,
 			 SHA256_DIGEST_SIZE);
 }
+#endif /* !HOST_TOOLS_BUILD */
@@ -0,0 +1 @@
+sha256.c
\ No newline at end of file
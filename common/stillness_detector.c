@@ -6,106 +6,125 @@
 #include "common.h"
 #include "stillness_detector.h"
 #include "timer.h"
-
-#include <string.h>
+#include "util.h"
+#include "vec3.h"
 
 static void still_det_reset(struct still_det *still_det)
 {
-	still_det->num_samples = 0;
-	still_det->acc_x = FLOAT_TO_FP(0.0f);
-	still_det->acc_y = FLOAT_TO_FP(0.0f);
-	still_det->acc_z = FLOAT_TO_FP(0.0f);
-	still_det->acc_xx = FLOAT_TO_FP(0.0f);
-	still_det->acc_yy = FLOAT_TO_FP(0.0f);
-	still_det->acc_zz = FLOAT_TO_FP(0.0f);
+	int i;
+
+	for (i = X; i <= Z; i++)
+		window_stats_reset(&still_det->stats[i]);
 }
 
-static bool stillness_batch_complete(struct still_det *still_det,
-				     uint32_t sample_time)
+enum still_det_batch {
+	/* The batch goes on. */
+	STILL_DET_PENDING,
+	/* The batch is complete, check it and start over. */
+	STILL_DET_COMPLETE,
+	/* The batch is not usable, start over. */
+	STILL_DET_RESTART,
+};
+
+static enum still_det_batch stillness_batch_state(struct still_det *still_det,
+						  uint32_t sample_time,
+						  uint16_t num_samples)
 {
-	bool complete = false;
 	uint32_t batch_window =
 		time_until(still_det->window_start_time, sample_time);
 
 	/* Checking if enough data is accumulated */
 	if (batch_window >= still_det->min_batch_window &&
-	    still_det->num_samples > still_det->min_batch_size) {
-		if (batch_window <= still_det->max_batch_window) {
-			complete = true;
-		} else {
-			/* Checking for too long batch window, reset and start
-			 * over
-			 */
-			still_det_reset(still_det);
-		}
+	    num_samples > still_det->min_batch_size) {
+		if (batch_window <= still_det->max_batch_window)
+			return STILL_DET_COMPLETE;
+		/* Checking for too long batch window, start over */
+		return STILL_DET_RESTART;
 	} else if (batch_window > still_det->min_batch_window &&
-		   still_det->num_samples < still_det->min_batch_size) {
-		/* Not enough samples collected, reset and start over */
-		still_det_reset(still_det);
+		   num_samples < still_det->min_batch_size) {
+		/* Not enough samples collected, start over */
+		return STILL_DET_RESTART;
 	}
-	return complete;
+	return STILL_DET_PENDING;
+}
+
+/* Add samples to the batch, once the batch is full the samples are dropped. */
+static void still_det_accumulate(struct still_det *still_det, const intv3_t *v,
+				 size_t n)
+{
+	struct intv3_moments m;
+	int i;
+
+	n = MIN(n, still_det->stats[X].size - still_det->stats[X].count);
+	if (!n)
+		return;
+
+	intv3_moments_reset(&m);
+	intv3_moments_add_sq(&m, v, n);
+	for (i = X; i <= Z; i++)
+		window_stats_add_sums(&still_det->stats[i], n, m.sum[i],
+				      m.sum_sq[i]);
 }
 
-static inline fp_t compute_variance(fp_t acc_squared, fp_t acc, fp_t inv)
+/* The batch is complete, check if the sensor was still. */
+static bool still_det_check(struct still_det *still_det)
 {
-	/* (acc^2 - (acc * acc * inv)) * inv */
-	return fp_mul((acc_squared - fp_mul(fp_sq(acc), inv)), inv);
+	int i;
+
+	for (i = X; i <= Z; i++)
+		if (window_stats_variance(&still_det->stats[i]) >=
+		    still_det->var_threshold)
+			return false;
+	for (i = X; i <= Z; i++)
+		still_det->mean[i] = window_stats_mean(&still_det->stats[i]);
+	return true;
 }
 
-bool still_det_update(struct still_det *still_det, uint32_t sample_time, fp_t x,
-		      fp_t y, fp_t z)
+bool still_det_update_batch(struct still_det *still_det,
+			    const uint32_t *sample_times, const intv3_t *v,
+			    size_t n)
 {
-	fp_t inv = FLOAT_TO_FP(0.0f), var_x, var_y, var_z;
-	bool complete = false;
-
-	/* Accumulate for mean and VAR */
-	still_det->acc_x += x;
-	still_det->acc_y += y;
-	still_det->acc_z += z;
-	still_det->acc_xx += fp_mul(x, x);
-	still_det->acc_yy += fp_mul(y, y);
-	still_det->acc_zz += fp_mul(z, z);
-
-	switch (++still_det->num_samples) {
-	case 0:
-		/* If we rolled over, go back. */
-		still_det->num_samples--;
-		break;
-	case 1:
+	const uint16_t size = still_det->stats[X].size;
+	bool still = false;
+	size_t start = 0;
+	uint16_t count;
+	size_t i;
+
+	/*
+	 * The batch limits are checked on every sample, the samples since the
+	 * last check are only summed up when a batch completes or at the end.
+	 */
+	for (i = 0; i < n; i++) {
+		count = MIN(still_det->stats[X].count + (i - start) + 1, size);
+
 		/* Set a new start time if new batch. */
-		still_det->window_start_time = sample_time;
-		break;
-	}
+		if (count == 1)
+			still_det->window_start_time = sample_times[i];
 
-	if (stillness_batch_complete(still_det, sample_time)) {
-		/*
-		 * Compute 1/num_samples and check for num_samples == 0 (should
-		 * never happen, but just in case)
-		 */
-		if (still_det->num_samples) {
-			inv = fp_div(1.0f, INT_TO_FP(still_det->num_samples));
-		} else {
-			still_det_reset(still_det);
-			return complete;
-		}
-		/* Calculating the VAR = sum(x^2)/n - sum(x)^2/n^2 */
-		var_x = compute_variance(still_det->acc_xx, still_det->acc_x,
-					 inv);
-		var_y = compute_variance(still_det->acc_yy, still_det->acc_y,
-					 inv);
-		var_z = compute_variance(still_det->acc_zz, still_det->acc_z,
-					 inv);
-		/* Checking if sensor is still */
-		if (var_x < still_det->var_threshold &&
-		    var_y < still_det->var_threshold &&
-		    var_z < still_det->var_threshold) {
-			still_det->mean_x = fp_mul(still_det->acc_x, inv);
-			still_det->mean_y = fp_mul(still_det->acc_y, inv);
-			still_det->mean_z = fp_mul(still_det->acc_z, inv);
-			complete = true;
+		switch (stillness_batch_state(still_det, sample_times[i],
+					      count)) {
+		case STILL_DET_PENDING:
+			continue;
+		case STILL_DET_COMPLETE:
+			still_det_accumulate(still_det, v + start,
+					     i - start + 1);
+			if (still_det_check(still_det))
+				still = true;
+			break;
+		case STILL_DET_RESTART:
+			break;
 		}
 		/* Reset and start over */
 		still_det_reset(still_det);
+		start = i + 1;
 	}
-	return complete;
+	still_det_accumulate(still_det, v + start, n - start);
+	return still;
+}
+
+bool still_det_update(struct still_det *still_det, uint32_t sample_time,
+		      const intv3_t v)
+{
+	return still_det_update_batch(still_det, &sample_time,
+				      (const intv3_t *)v, 1);
 }
@@ -59,3 +59,148 @@ fp_t fpv3_norm(const fpv3_t v)
 {
 	return fp_sqrtf(fpv3_norm_squared(v));
 }
+
+/*
+ * The paired loops fold two samples per SMLALD on cores with the DSP
+ * extension. The fp_dsp test builds them on the host with a C version of the
+ * instruction, to check them against the portable loops.
+ */
+#if defined(__ARM_FEATURE_DSP) || defined(TEST_FP_DSP)
+#define VEC3_PAIRED_MOMENTS
+
+/* Pack the low halves of 2 values, lo in the bottom half. */
+static inline uint32_t pack16(int lo, int hi)
+{
+	return (uint16_t)lo | ((uint32_t)hi << 16);
+}
+
+/* acc + bottom(a) * bottom(b) + top(a) * top(b), one SMLALD. */
+static inline int64_t smlald(uint32_t a, uint32_t b, int64_t acc)
+{
+#ifdef __ARM_FEATURE_DSP
+	__asm__("smlald %Q0, %R0, %1, %2" : "+r"(acc) : "r"(a), "r"(b));
+	return acc;
+#else
+	return acc + (int64_t)(int16_t)a * (int16_t)b +
+	       (int64_t)(int16_t)(a >> 16) * (int16_t)(b >> 16);
+#endif
+}
+#endif
+
+void intv3_moments_reset(struct intv3_moments *m)
+{
+	memset(m, 0, sizeof(*m));
+}
+
+static void moments_add_sq_one(struct intv3_moments *m, const intv3_t v)
+{
+	int axis;
+
+	for (axis = X; axis <= Z; axis++) {
+		m->sum[axis] += v[axis];
+		m->sum_sq[axis] += (int64_t)v[axis] * v[axis];
+	}
+}
+
+static void moments_add_one(struct intv3_moments *m, const intv3_t v)
+{
+	int64_t w = 0;
+	int axis;
+
+	moments_add_sq_one(m, v);
+	for (axis = X; axis <= Z; axis++)
+		w += (int64_t)v[axis] * v[axis];
+	m->sum_cross[0] += (int64_t)v[X] * v[Y];
+	m->sum_cross[1] += (int64_t)v[X] * v[Z];
+	m->sum_cross[2] += (int64_t)v[Y] * v[Z];
+	for (axis = X; axis <= Z; axis++)
+		m->sum_w[axis] += v[axis] * w;
+}
+
+#ifdef VEC3_PAIRED_MOMENTS
+/*
+ * Whether all the components of v[0] and v[1] fit the 16 bits multipliers.
+ * Overflow codes and scaled readings may not, those pairs take the 32x32
+ * path.
+ */
+static inline bool pair_fits16(const intv3_t *v)
+{
+	int axis;
+
+	for (axis = X; axis <= Z; axis++)
+		if (v[0][axis] != (int16_t)v[0][axis] ||
+		    v[1][axis] != (int16_t)v[1][axis])
+			return false;
+	return true;
+}
+#endif
+
+void intv3_moments_add_sq(struct intv3_moments *m, const intv3_t *v, size_t n)
+{
+	size_t i = 0;
+#ifdef VEC3_PAIRED_MOMENTS
+	int axis;
+
+	/* Two samples per multiply-accumulate. */
+	for (; i + 1 < n; i += 2) {
+		if (!pair_fits16(v + i)) {
+			moments_add_sq_one(m, v[i]);
+			moments_add_sq_one(m, v[i + 1]);
+			continue;
+		}
+		for (axis = X; axis <= Z; axis++) {
+			uint32_t p = pack16(v[i][axis], v[i + 1][axis]);
+
+			m->sum[axis] += v[i][axis] + v[i + 1][axis];
+			m->sum_sq[axis] = smlald(p, p, m->sum_sq[axis]);
+		}
+	}
+#endif
+	for (; i < n; i++)
+		moments_add_sq_one(m, v[i]);
+	m->count += n;
+}
+
+void intv3_moments_add(struct intv3_moments *m, const intv3_t *v, size_t n)
+{
+	size_t i = 0;
+#ifdef VEC3_PAIRED_MOMENTS
+	int64_t w;
+	int axis;
+
+	for (; i + 1 < n; i += 2) {
+		uint32_t px, py, pz;
+		size_t j;
+
+		if (!pair_fits16(v + i)) {
+			moments_add_one(m, v[i]);
+			moments_add_one(m, v[i + 1]);
+			continue;
+		}
+		px = pack16(v[i][X], v[i + 1][X]);
+		py = pack16(v[i][Y], v[i + 1][Y]);
+		pz = pack16(v[i][Z], v[i + 1][Z]);
+
+		for (axis = X; axis <= Z; axis++)
+			m->sum[axis] += v[i][axis] + v[i + 1][axis];
+		m->sum_sq[X] = smlald(px, px, m->sum_sq[X]);
+		m->sum_sq[Y] = smlald(py, py, m->sum_sq[Y]);
+		m->sum_sq[Z] = smlald(pz, pz, m->sum_sq[Z]);
+		m->sum_cross[0] = smlald(px, py, m->sum_cross[0]);
+		m->sum_cross[1] = smlald(px, pz, m->sum_cross[1]);
+		m->sum_cross[2] = smlald(py, pz, m->sum_cross[2]);
+
+		/* w does not fit 16 bits, use 32x32 multiply-accumulates. */
+		for (j = i; j < i + 2; j++) {
+			w = smlald(pack16(v[j][X], v[j][Y]),
+				   pack16(v[j][X], v[j][Y]),
+				   (int64_t)v[j][Z] * v[j][Z]);
+			for (axis = X; axis <= Z; axis++)
+				m->sum_w[axis] += v[j][axis] * w;
+		}
+	}
+#endif
+	for (; i < n; i++)
+		moments_add_one(m, v[i]);
+	m->count += n;
+}
@@ -0,0 +1,92 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "common.h"
+#include "util.h"
+#include "window_stats.h"
+
+void window_stats_init(struct window_stats *ws, int32_t *history,
+		       uint16_t size)
+{
+	ws->history = history;
+	ws->size = MIN(size, WINDOW_STATS_MAX_SIZE);
+	window_stats_reset(ws);
+}
+
+void window_stats_reset(struct window_stats *ws)
+{
+	ws->count = 0;
+	ws->head = 0;
+	ws->sum = 0;
+	ws->n2_variance = 0;
+}
+
+/*
+ * The window grows from k to k + 1 samples. With the deviation of x from the
+ * old mean scaled by k, d = k * x - sum:
+ *
+ * (k + 1)^2 * var' = k^2 * var + (k^2 * var + d^2) / k
+ *
+ * The division is exact, both sides are integers.
+ */
+static void window_stats_grow(struct window_stats *ws, int32_t x)
+{
+	const uint32_t k = ws->count;
+	const int64_t d = (int64_t)k * x - ws->sum;
+
+	if (k)
+		ws->n2_variance += (ws->n2_variance + (uint64_t)(d * d)) / k;
+	ws->sum += x;
+	ws->count++;
+}
+
+/*
+ * x_n replaces x_0 in a full window of n samples:
+ *
+ * n^2 * var' = n^2 * var + (x_n - x_0) * (n * (x_n + x_0) - sum' - sum)
+ */
+static void window_stats_slide(struct window_stats *ws, int32_t x_n)
+{
+	const int64_t n = ws->size;
+	const int32_t x_0 = ws->history[ws->head];
+	const int64_t sum_diff = x_n - x_0;
+	const int64_t new_sum = ws->sum + sum_diff;
+
+	ws->n2_variance += sum_diff * (n * (x_n + x_0) - new_sum - ws->sum);
+	ws->sum = new_sum;
+}
+
+void window_stats_push(struct window_stats *ws, int32_t x)
+{
+	if (!window_stats_full(ws))
+		window_stats_grow(ws, x);
+	else if (ws->history)
+		window_stats_slide(ws, x);
+	else
+		return;
+
+	if (ws->history) {
+		ws->history[ws->head] = x;
+		ws->head = (ws->head + 1 >= ws->size) ? 0 : ws->head + 1;
+	}
+}
+
+/*
+ * For a growing window count^2 * var = count * sum_sq - sum^2, so the sum of
+ * squares of the samples already in is recovered exactly from n2_variance.
+ */
+void window_stats_add_sums(struct window_stats *ws, uint16_t count,
+			   int64_t sum, uint64_t sum_sq)
+{
+	const uint64_t k = ws->count;
+	const uint64_t n = k + count;
+	const int64_t new_sum = ws->sum + sum;
+
+	if (k)
+		sum_sq += (ws->n2_variance + ws->sum * ws->sum) / k;
+	ws->n2_variance = n * sum_sq - (uint64_t)(new_sum * new_sum);
+	ws->sum = new_sum;
+	ws->count = n;
+}
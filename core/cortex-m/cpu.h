@@ -72,6 +72,19 @@ enum {
 #define CPU_SCB_DCISW CPUREG(0xe000ef60)
 #define CPU_SCB_DCCISW CPUREG(0xe000ef74)
 
+/* Debug Exception and Monitor Control Register */
+#define CPU_DEMCR CPUREG(0xe000edfc)
+#define CPU_DEMCR_TRCENA BIT(24)
+
+/* Data Watchpoint and Trace unit: cycle counter */
+#define CPU_DWT_CTRL CPUREG(0xe0001000)
+#define CPU_DWT_CTRL_CYCCNTENA BIT(0)
+#define CPU_DWT_CTRL_NOCYCCNT BIT(25)
+#define CPU_DWT_CYCCNT CPUREG(0xe0001004)
+/* Software lock of the DWT registers, implemented on Cortex-M7 */
+#define CPU_DWT_LAR CPUREG(0xe0001fb0)
+#define CPU_DWT_LAR_KEY 0xc5acce55
+
 /* Floating Point Context Address Register */
 #define CPU_FPU_FPCAR CPUREG(0xe000ef38)
 
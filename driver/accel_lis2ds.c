@@ -20,6 +20,7 @@
 #include "i2c.h"
 #include "math_util.h"
 #include "motion_sense_fifo.h"
+#include "motion_sense_trace.h"
 #include "task.h"
 #include "timer.h"
 #include "util.h"
@@ -150,6 +151,8 @@ static int lis2ds_irq_handler(struct motion_sensor_t *s, uint32_t *event)
 	if (!(*event & CONFIG_ACCEL_LIS2DS_INT_EVENT))
 		return EC_ERROR_NOT_HANDLED;
 
+	motion_sense_trace_irq(s - motion_sensors, interrupt_timestamp);
+
 	ret = st_raw_read_n_noinc(s->port, s->i2c_spi_addr_flags,
 				  LIS2DS_FIFO_SRC_ADDR,
 				  (uint8_t *)fifo_src_samples,
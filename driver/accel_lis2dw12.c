@@ -16,6 +16,7 @@
 #include "math_util.h"
 #include "motion_sense.h"
 #include "motion_sense_fifo.h"
+#include "motion_sense_trace.h"
 #include "task.h"
 #include "util.h"
 
@@ -178,6 +179,8 @@ static int lis2dw12_irq_handler(struct motion_sensor_t *s, uint32_t *event)
 		return EC_ERROR_NOT_HANDLED;
 	}
 
+	motion_sense_trace_irq(s - motion_sensors, interrupt_timestamp);
+
 	if (IS_ENABLED(CONFIG_GESTURE_SENSOR_DOUBLE_TAP)) {
 		int status = 0;
 
@@ -20,6 +20,7 @@
 #include "math_util.h"
 #include "motion_orientation.h"
 #include "motion_sense_fifo.h"
+#include "motion_sense_trace.h"
 #include "spi.h"
 #include "task.h"
 #include "timer.h"
@@ -529,6 +530,8 @@ static int irq_handler(struct motion_sensor_t *s, uint32_t *event)
 	    (!(*event & CONFIG_ACCELGYRO_BMI160_INT_EVENT)))
 		return EC_ERROR_NOT_HANDLED;
 
+	motion_sense_trace_irq(s - motion_sensors, interrupt_timestamp);
+
 	/*
 	 * We have to loop until we see the interrupt status as 0 to avoid
 	 * getting stuck. We use edge triggered interrupts and, once one
@@ -18,6 +18,7 @@
 #include "init_rom.h"
 #include "math_util.h"
 #include "motion_sense_fifo.h"
+#include "motion_sense_trace.h"
 #include "spi.h"
 #include "task.h"
 #include "timer.h"
@@ -337,6 +338,8 @@ static int irq_handler(struct motion_sensor_t *s, uint32_t *event)
 	    motion_sensor_in_forced_mode(s))
 		return EC_ERROR_NOT_HANDLED;
 
+	motion_sense_trace_irq(s - motion_sensors, interrupt_timestamp);
+
 	/*
 	 * We have to loop until we see the interrupt status as 0 to avoid
 	 * getting stuck. We use edge triggered interrupts and, once one
@@ -351,7 +351,8 @@ void bmi_normalize(const struct motion_sensor_t *s, intv3_t v, uint8_t *input)
 }
 
 int bmi_decode_header(struct motion_sensor_t *accel, enum fifo_header hdr,
-		      uint32_t last_ts, uint8_t **bp, uint8_t *ep)
+		      struct motion_sense_fifo_batch *batch, uint8_t **bp,
+		      uint8_t *ep)
 {
 	if ((hdr & BMI_FH_MODE_MASK) == BMI_FH_EMPTY &&
 	    (hdr & BMI_FH_PARM_MASK) != 0) {
@@ -378,20 +379,11 @@ int bmi_decode_header(struct motion_sensor_t *accel, enum fifo_header hdr,
 				if (IS_ENABLED(CONFIG_ACCEL_SPOOF_MODE) &&
 				    s->flags & MOTIONSENSE_FLAG_IN_SPOOF_MODE)
 					v = s->spoof_xyz;
-				if (IS_ENABLED(CONFIG_ACCEL_FIFO)) {
-					struct ec_response_motion_sensor_data
-						vector;
-
-					vector.flags = 0;
-					vector.data[X] = v[X];
-					vector.data[Y] = v[Y];
-					vector.data[Z] = v[Z];
-					vector.sensor_num = s - motion_sensors;
-					motion_sense_fifo_stage_data(
-						&vector, s, 3, last_ts);
-				} else {
+				if (IS_ENABLED(CONFIG_ACCEL_FIFO))
+					motion_sense_fifo_batch_add(batch, s,
+								    v);
+				else
 					motion_sense_push_raw_xyz(s);
-				}
 				*bp += (i == MOTIONSENSE_TYPE_MAG ? 8 : 6);
 			}
 		}
@@ -409,12 +401,14 @@ enum fifo_state {
 	FIFO_DATA_CONFIG,
 };
 
-#define BMI_FIFO_BUFFER 64
+/* Drain as much of the FIFO as a single bus transfer allows. */
+#define BMI_FIFO_BUFFER CONFIG_I2C_CHIP_MAX_TRANSFER_SIZE
 static uint8_t bmi_buffer[BMI_FIFO_BUFFER];
 
 int bmi_load_fifo(struct motion_sensor_t *s, uint32_t last_ts)
 {
 	struct bmi_drv_data_t *data = BMI_GET_DATA(s);
+	struct motion_sense_fifo_batch batch;
 	uint16_t length;
 	enum fifo_state state = FIFO_HEADER;
 	uint8_t *bp = bmi_buffer;
@@ -481,18 +475,19 @@ int bmi_load_fifo(struct motion_sensor_t *s, uint32_t last_ts)
 		return EC_SUCCESS;
 	}
 
+	motion_sense_fifo_batch_init(&batch, last_ts);
 	while (bp < ep) {
 		switch (state) {
 		case FIFO_HEADER: {
 			enum fifo_header hdr = *bp++;
 
-			if (bmi_decode_header(s, hdr, last_ts, &bp, ep))
+			if (bmi_decode_header(s, hdr, &batch, &bp, ep))
 				continue;
 			/* Other cases */
 			hdr &= 0xdc;
 			switch (hdr) {
 			case BMI_FH_EMPTY:
-				return EC_SUCCESS;
+				goto out;
 			case BMI_FH_SKIP:
 				state = FIFO_DATA_SKIP;
 				break;
@@ -508,6 +503,8 @@ int bmi_load_fifo(struct motion_sensor_t *s, uint32_t last_ts)
 				bmi_write8(s->port, s->i2c_spi_addr_flags,
 					   BMI_CMD_REG(V(s)),
 					   BMI_CMD_FIFO_FLUSH);
+				if (IS_ENABLED(CONFIG_ACCEL_FIFO))
+					motion_sense_fifo_batch_flush(&batch);
 				return EC_ERROR_NOT_HANDLED;
 			}
 			break;
@@ -544,6 +541,9 @@ int bmi_load_fifo(struct motion_sensor_t *s, uint32_t last_ts)
 		}
 	}
 
+out:
+	if (IS_ENABLED(CONFIG_ACCEL_FIFO))
+		motion_sense_fifo_batch_flush(&batch);
 	return EC_SUCCESS;
 }
 
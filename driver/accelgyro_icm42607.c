@@ -18,6 +18,7 @@
 #include "math_util.h"
 #include "motion_sense.h"
 #include "motion_sense_fifo.h"
+#include "motion_sense_trace.h"
 #include "spi.h"
 #include "task.h"
 #include "timer.h"
@@ -310,11 +311,10 @@ out_unlock:
 	return ret;
 }
 
-static void __maybe_unused icm42607_push_fifo_data(struct motion_sensor_t *s,
-						   const uint8_t *raw,
-						   uint32_t ts)
+static void __maybe_unused
+icm42607_push_fifo_data(struct motion_sensor_t *s, const uint8_t *raw,
+			struct motion_sense_fifo_batch *batch)
 {
-	struct ec_response_motion_sensor_data vect;
 	int *v = s->raw_xyz;
 
 	if (icm42607_normalize(s, v, raw) != EC_SUCCESS)
@@ -323,23 +323,18 @@ static void __maybe_unused icm42607_push_fifo_data(struct motion_sensor_t *s,
 	if (IS_ENABLED(CONFIG_ACCEL_SPOOF_MODE) &&
 	    s->flags & MOTIONSENSE_FLAG_IN_SPOOF_MODE)
 		v = s->spoof_xyz;
-	if (IS_ENABLED(CONFIG_ACCEL_FIFO)) {
-		vect.data[X] = v[X];
-		vect.data[Y] = v[Y];
-		vect.data[Z] = v[Z];
-		vect.flags = 0;
-		vect.sensor_num = s - motion_sensors;
-		motion_sense_fifo_stage_data(&vect, s, 3, ts);
-	} else {
+	if (IS_ENABLED(CONFIG_ACCEL_FIFO))
+		motion_sense_fifo_batch_add(batch, s, v);
+	else
 		motion_sense_push_raw_xyz(s);
-	}
 }
 
 static int __maybe_unused icm42607_load_fifo(struct motion_sensor_t *s,
 					     uint32_t ts)
 {
 	struct icm_drv_data_t *st = ICM_GET_DATA(s);
-	int count, i, size;
+	struct motion_sense_fifo_batch batch;
+	int count, i, size = 0;
 	const uint8_t *accel, *gyro;
 	int ret;
 
@@ -365,25 +360,29 @@ static int __maybe_unused icm42607_load_fifo(struct motion_sensor_t *s,
 	if (ret != EC_SUCCESS)
 		return ret;
 
+	motion_sense_fifo_batch_init(&batch, ts);
 	for (i = 0; i < count; i += size) {
 		size = icm_fifo_decode_packet(&st->fifo_buffer[i], &accel,
 					      &gyro);
 		/* exit if error or FIFO is empty */
 		if (size <= 0)
-			return -size;
+			break;
 		if (accel != NULL) {
 			ret = icm42607_check_sensor_stabilized(s, ts);
 			if (ret == EC_SUCCESS)
-				icm42607_push_fifo_data(s, accel, ts);
+				icm42607_push_fifo_data(s, accel, &batch);
 		}
 		if (gyro != NULL) {
 			ret = icm42607_check_sensor_stabilized(s + 1, ts);
 			if (ret == EC_SUCCESS)
-				icm42607_push_fifo_data(s + 1, gyro, ts);
+				icm42607_push_fifo_data(s + 1, gyro, &batch);
 		}
 	}
 
-	return EC_SUCCESS;
+	if (IS_ENABLED(CONFIG_ACCEL_FIFO))
+		motion_sense_fifo_batch_flush(&batch);
+
+	return size < 0 ? -size : EC_SUCCESS;
 }
 
 #ifdef ACCELGYRO_ICM42607_INT_ENABLE
@@ -416,6 +415,8 @@ static int icm42607_irq_handler(struct motion_sensor_t *s, uint32_t *event)
 	    (!(*event & CONFIG_ACCELGYRO_ICM42607_INT_EVENT)))
 		return EC_ERROR_NOT_HANDLED;
 
+	motion_sense_trace_irq(s - motion_sensors, interrupt_timestamp);
+
 	mutex_lock(s->mutex);
 
 	/* read and clear interrupt status */
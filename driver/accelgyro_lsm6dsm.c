@@ -17,6 +17,7 @@
 #include "mag_cal.h"
 #include "math_util.h"
 #include "motion_sense_fifo.h"
+#include "motion_sense_trace.h"
 #include "queue.h"
 #include "task.h"
 #include "timer.h"
@@ -272,7 +273,7 @@ static int fifo_next(struct lsm6dsm_data *private)
  * push_fifo_data - Scan data pattern and push upside
  */
 static void push_fifo_data(struct motion_sensor_t *accel, uint8_t *fifo,
-			   uint16_t flen, uint32_t timestamp)
+			   uint16_t flen, struct motion_sense_fifo_batch *batch)
 {
 	struct motion_sensor_t *s;
 	struct lsm6dsm_data *private = LSM6DSM_GET_DATA(accel);
@@ -310,16 +311,7 @@ static void push_fifo_data(struct motion_sensor_t *accel, uint8_t *fifo,
 			    s->flags & MOTIONSENSE_FLAG_IN_SPOOF_MODE)
 				axis = s->spoof_xyz;
 			if (IS_ENABLED(CONFIG_ACCEL_FIFO)) {
-				struct ec_response_motion_sensor_data vect;
-
-				vect.data[X] = axis[X];
-				vect.data[Y] = axis[Y];
-				vect.data[Z] = axis[Z];
-
-				vect.flags = 0;
-				vect.sensor_num = s - motion_sensors;
-				motion_sense_fifo_stage_data(&vect, s, 3,
-							     timestamp);
+				motion_sense_fifo_batch_add(batch, s, axis);
 			} else {
 				motion_sense_push_raw_xyz(s);
 			}
@@ -330,11 +322,19 @@ static void push_fifo_data(struct motion_sensor_t *accel, uint8_t *fifo,
 	}
 }
 
+/*
+ * Drain the FIFO in the largest burst the bus takes, rounded down to whole
+ * samples. Only the motion sense task drains FIFOs, one buffer is enough.
+ */
+#define LSM6DSM_FIFO_DRAIN_LEN \
+	((CONFIG_I2C_CHIP_MAX_TRANSFER_SIZE / OUT_XYZ_SIZE) * OUT_XYZ_SIZE)
+static uint8_t fifo_drain_buf[LSM6DSM_FIFO_DRAIN_LEN];
+
 static int load_fifo(struct motion_sensor_t *s, const struct fstatus *fsts,
 		     const uint32_t timestamp)
 {
+	struct motion_sense_fifo_batch batch;
 	int err, left, length;
-	uint8_t fifo[FIFO_READ_LEN];
 
 	/*
 	 * DIFF[11:0] are number of unread uint16 in FIFO
@@ -344,32 +344,34 @@ static int load_fifo(struct motion_sensor_t *s, const struct fstatus *fsts,
 	left *= sizeof(uint16_t);
 	left = (left / OUT_XYZ_SIZE) * OUT_XYZ_SIZE;
 
+	/*
+	 * Data is pushed with the timestamp of the interrupt that got us into
+	 * this function in the first place. This avoids a potential race
+	 * condition where we empty the FIFO, and a new IRQ comes in between
+	 * reading the last sample and pushing it into the FIFO.
+	 */
+	motion_sense_fifo_batch_init(&batch, timestamp);
+
 	/* Push all data on upper side. */
 	do {
-		/* Fit len to pre-allocated static buffer. */
-		if (left > FIFO_READ_LEN)
-			length = FIFO_READ_LEN;
-		else
-			length = left;
+		length = MIN(left, LSM6DSM_FIFO_DRAIN_LEN);
 
 		/* Read data and copy in buffer. */
 		err = st_raw_read_n_noinc(s->port, s->i2c_spi_addr_flags,
-					  LSM6DSM_FIFO_DATA_ADDR, fifo, length);
+					  LSM6DSM_FIFO_DATA_ADDR,
+					  fifo_drain_buf, length);
 		if (err != EC_SUCCESS)
-			return err;
+			break;
 
-		/*
-		 * Manage patterns and push data. Data is pushed with the
-		 * timestamp of the interrupt that got us into this function
-		 * in the first place. This avoids a potential race condition
-		 * where we empty the FIFO, and a new IRQ comes in between
-		 * reading the last sample and pushing it into the FIFO.
-		 */
-		push_fifo_data(s, fifo, length, timestamp);
+		/* Manage patterns and decode in place. */
+		push_fifo_data(s, fifo_drain_buf, length, &batch);
 		left -= length;
 	} while (left > 0);
 
-	return EC_SUCCESS;
+	if (IS_ENABLED(CONFIG_ACCEL_FIFO))
+		motion_sense_fifo_batch_flush(&batch);
+
+	return err;
 }
 
 /**
@@ -396,6 +398,8 @@ static int irq_handler(struct motion_sensor_t *s, uint32_t *event)
 	    (!(*event & CONFIG_ACCEL_LSM6DSM_INT_EVENT)))
 		return EC_ERROR_NOT_HANDLED;
 
+	motion_sense_trace_irq(s - motion_sensors, interrupt_timestamp);
+
 	while (!fifo_empty) {
 		/* Read how many data pattern on FIFO to read. */
 		RETURN_ERROR(st_raw_read_n_noinc(
@@ -16,6 +16,7 @@
 #include "hwtimer.h"
 #include "math_util.h"
 #include "motion_sense_fifo.h"
+#include "motion_sense_trace.h"
 #include "task.h"
 #include "timer.h"
 
@@ -250,6 +251,8 @@ static int irq_handler(struct motion_sensor_t *s, uint32_t *event)
 	    (!(*event & CONFIG_ACCEL_LSM6DSO_INT_EVENT)))
 		return EC_ERROR_NOT_HANDLED;
 
+	motion_sense_trace_irq(s - motion_sensors, interrupt_timestamp);
+
 	do {
 		/* Read how many data patterns on FIFO to read. */
 		RETURN_ERROR(st_raw_read_n_noinc(
@@ -5,6 +5,7 @@
  * AMS TCS3400 light sensor driver
  */
 #include "accelgyro.h"
+#include "als_process.h"
 #include "als_tcs3400.h"
 #include "common.h"
 #include "console.h"
@@ -216,72 +217,35 @@ static int tcs3400_adjust_sensor_for_saturation(struct motion_sensor_t *s,
 }
 
 /**
- * normalize_channel_data - normalize the light data to remove effect of
- * different atime and again settings from the sample.
+ * tcs3400_norm_gain - gain normalizing the light data to the calibration atime
+ * and again, to remove the effect of different settings from the sample.
  */
-static uint32_t normalize_channel_data(struct motion_sensor_t *s,
-				       uint32_t sample)
+static uint32_t tcs3400_norm_gain(struct motion_sensor_t *s)
 {
-	struct tcs_saturation_t *sat_p =
-		&(TCS3400_RGB_DRV_DATA(s + 1)->saturation);
-	const uint16_t cur_gain = (1 << (2 * sat_p->again));
-	const uint16_t cal_again = (1 << (2 * TCS_CALIBRATION_AGAIN));
-
-	return DIV_ROUND_NEAREST(
-		sample * (TCS_ATIME_GRANULARITY - TCS_CALIBRATION_ATIME) *
-			cal_again,
-		(TCS_ATIME_GRANULARITY - sat_p->atime) * cur_gain);
+	struct tcs3400_rgb_drv_data_t *rgb_drv_data =
+		TCS3400_RGB_DRV_DATA(s + 1);
+	struct tcs_saturation_t *sat_p = &rgb_drv_data->saturation;
+
+	/* atime and again only change when the light level does. */
+	if (!rgb_drv_data->norm ||
+	    rgb_drv_data->norm_saturation.atime != sat_p->atime ||
+	    rgb_drv_data->norm_saturation.again != sat_p->again) {
+		rgb_drv_data->norm_saturation = *sat_p;
+		rgb_drv_data->norm = als_norm_gain(
+			(TCS_ATIME_GRANULARITY - TCS_CALIBRATION_ATIME)
+				<< (2 * TCS_CALIBRATION_AGAIN),
+			(TCS_ATIME_GRANULARITY - sat_p->atime)
+				<< (2 * sat_p->again));
+	}
+	return rgb_drv_data->norm;
 }
 
 __overridable void tcs3400_translate_to_xyz(struct motion_sensor_t *s,
 					    int32_t *crgb_data,
 					    int32_t *xyz_data)
 {
-	struct tcs3400_rgb_drv_data_t *rgb_drv_data =
-		TCS3400_RGB_DRV_DATA(s + 1);
-	int32_t crgb_prime[CRGB_COUNT];
-	int32_t ir;
-	int i;
-
-	/* normalize the data for atime and again changes */
-	for (i = 0; i < CRGB_COUNT; i++)
-		crgb_data[i] = normalize_channel_data(s, crgb_data[i]);
-
-	/* IR removal */
-	ir = FP_TO_INT(fp_mul(INT_TO_FP(crgb_data[1] + crgb_data[2] +
-					crgb_data[3] - crgb_data[0]),
-			      rgb_drv_data->calibration.irt) /
-		       2);
-
-	for (i = 0; i < ARRAY_SIZE(crgb_prime); i++) {
-		if (crgb_data[i] < ir)
-			crgb_prime[i] = 0;
-		else
-			crgb_prime[i] = crgb_data[i] - ir;
-	}
-
-	/* if CC == 0, set BC = 0 */
-	if (crgb_prime[CLEAR_CRGB_IDX] == 0)
-		crgb_prime[BLUE_CRGB_IDX] = 0;
-
-	/* regression fit to XYZ space */
-	for (i = 0; i < 3; i++) {
-		const struct rgb_channel_calibration_t *p =
-			&rgb_drv_data->calibration.rgb_cal[i];
-
-		xyz_data[i] = p->offset +
-			      FP_TO_INT((fp_inter_t)p->coeff[RED_CRGB_IDX] *
-						crgb_prime[RED_CRGB_IDX] +
-					(fp_inter_t)p->coeff[GREEN_CRGB_IDX] *
-						crgb_prime[GREEN_CRGB_IDX] +
-					(fp_inter_t)p->coeff[BLUE_CRGB_IDX] *
-						crgb_prime[BLUE_CRGB_IDX] +
-					(fp_inter_t)p->coeff[CLEAR_CRGB_IDX] *
-						crgb_prime[CLEAR_CRGB_IDX]);
-
-		if (xyz_data[i] < 0)
-			xyz_data[i] = 0;
-	}
+	als_crgb_to_xyz(&TCS3400_RGB_DRV_DATA(s + 1)->calibration,
+			tcs3400_norm_gain(s), crgb_data, xyz_data);
 }
 
 static void tcs3400_process_raw_data(struct motion_sensor_t *s,
@@ -292,48 +256,35 @@ static void tcs3400_process_raw_data(struct motion_sensor_t *s,
 	struct als_drv_data_t *als_drv_data = TCS3400_DRV_DATA(s);
 	struct tcs3400_rgb_drv_data_t *rgb_drv_data =
 		TCS3400_RGB_DRV_DATA(s + 1);
-	const uint8_t calibration_mode = rgb_drv_data->calibration_mode;
-	uint16_t k_channel_scale =
-		als_drv_data->als_cal.channel_scale.k_channel_scale;
-	uint16_t cover_scale = als_drv_data->als_cal.channel_scale.cover_scale;
+	struct rgb_channel_calibration_t *rgb_cal =
+		rgb_drv_data->calibration.rgb_cal;
+	/* rgb data at index 1, 2, and 3 owned by rgb driver, not ALS */
+	const struct als_channel_scale_t *const scale[CRGB_COUNT] = {
+		[CLEAR_CRGB_IDX] = &als_drv_data->als_cal.channel_scale,
+		[RED_CRGB_IDX] = &rgb_cal[RED_RGB_IDX].scale,
+		[GREEN_CRGB_IDX] = &rgb_cal[GREEN_RGB_IDX].scale,
+		[BLUE_CRGB_IDX] = &rgb_cal[BLUE_RGB_IDX].scale,
+	};
 	int32_t crgb_data[CRGB_COUNT];
 	int i;
 
-	/* adjust for calibration and scale data */
-	for (i = 0; i < CRGB_COUNT; i++) {
-		int index = i * 2;
-
-		/* assemble the light value for this channel */
-		crgb_data[i] = raw_light_data[i] =
-			((raw_data_buf[index + 1] << 8) | raw_data_buf[index]);
-
-		/* in calibration mode, we only assemble the raw data */
-		if (calibration_mode)
-			continue;
-
-		/* rgb data at index 1, 2, and 3 owned by rgb driver, not ALS */
-		if (i > 0) {
-			struct als_channel_scale_t *csp =
-				&rgb_drv_data->calibration.rgb_cal[i - 1].scale;
-			k_channel_scale = csp->k_channel_scale;
-			cover_scale = csp->cover_scale;
-		}
-
-		/* Step 1: divide by individual channel scale value */
-		crgb_data[i] =
-			SENSOR_APPLY_DIV_SCALE(crgb_data[i], k_channel_scale);
+	/* assemble the light value of each channel */
+	for (i = 0; i < CRGB_COUNT; i++)
+		raw_light_data[i] = (raw_data_buf[i * 2 + 1] << 8) |
+				    raw_data_buf[i * 2];
 
-		/* compensate for the light cover */
-		crgb_data[i] = SENSOR_APPLY_SCALE(crgb_data[i], cover_scale);
-	}
+	if (!rgb_drv_data->calibration_mode) {
+		/* divide by the channel scale, compensate for the cover */
+		als_crgb_update_gains(&rgb_drv_data->gains, scale);
+		als_crgb_scale(&rgb_drv_data->gains, raw_light_data, crgb_data);
 
-	if (!calibration_mode) {
 		/* we're not in calibration mode & we want xyz translation */
 		tcs3400_translate_to_xyz(s, crgb_data, xyz_data);
 	} else {
 		/* normalize the data for atime and again changes */
 		for (i = 0; i < CRGB_COUNT; i++)
-			crgb_data[i] = normalize_channel_data(s, crgb_data[i]);
+			crgb_data[i] = raw_light_data[i];
+		als_crgb_normalize(crgb_data, tcs3400_norm_gain(s), CRGB_COUNT);
 
 		/* calibration mode returns raw data */
 		for (i = 0; i < 3; i++)
@@ -355,10 +306,36 @@ static int32_t get_lux_from_xyz(struct motion_sensor_t *s, int32_t *xyz_data)
 	return lux;
 }
 
-static bool is_spoof(struct motion_sensor_t *s)
-{
-	return IS_ENABLED(CONFIG_ACCEL_SPOOF_MODE) &&
-	       (s->flags & MOTIONSENSE_FLAG_IN_SPOOF_MODE);
+/*
+ * Keep the first <axes> values of a new light vector, or of the spoofed one
+ * in spoof mode, and stage them in the FIFO. The other axes are sent as 0.
+ * The caller commits the FIFO once both sensors are staged.
+ */
+static void tcs3400_publish(struct motion_sensor_t *s, const int32_t *v,
+			    int axes, uint32_t time)
+{
+	int *last_v = s->raw_xyz;
+
+	if (IS_ENABLED(CONFIG_ACCEL_SPOOF_MODE) &&
+	    (s->flags & MOTIONSENSE_FLAG_IN_SPOOF_MODE))
+		memcpy(last_v, s->spoof_xyz, axes * sizeof(*last_v));
+	else
+		memcpy(last_v, v, axes * sizeof(*last_v));
+
+	if (IS_ENABLED(CONFIG_ACCEL_FIFO)) {
+		struct ec_response_motion_sensor_data vector = {
+			.flags = 0,
+		};
+		int32_t sent[3] = { 0, 0, 0 };
+		void *udata = vector.udata;
+
+		memcpy(sent, last_v, axes * sizeof(*sent));
+		ec_motion_sensor_clamp_u16s(udata, sent);
+		vector.sensor_num = s - motion_sensors;
+		motion_sense_fifo_stage_data(&vector, s, 3, time);
+	} else {
+		motion_sense_push_raw_xyz(s);
+	}
 }
 
 static int tcs3400_post_events(struct motion_sensor_t *s, uint32_t last_ts,
@@ -413,30 +390,13 @@ static int tcs3400_post_events(struct motion_sensor_t *s, uint32_t last_ts,
 	lux = is_calibration ? xyz_data[Y] : get_lux_from_xyz(s, xyz_data);
 
 	/* if clear channel data changed, send illuminance upstream */
-	last_v = s->raw_xyz;
 	if (is_calibration ||
 	    ((raw_data[CLEAR_CRGB_IDX] != TCS_SATURATION_LEVEL) &&
-	     (last_v[X] != lux))) {
-		if (is_spoof(s))
-			last_v[X] = s->spoof_xyz[X];
-		else
-			last_v[X] = is_calibration ? raw_data[CLEAR_CRGB_IDX] :
-						     lux;
-
-		if (IS_ENABLED(CONFIG_ACCEL_FIFO)) {
-			struct ec_response_motion_sensor_data vector = {
-				.flags = 0,
-			};
-
-			vector.udata[X] = ec_motion_sensor_clamp_u16(last_v[X]);
-			vector.udata[Y] = 0;
-			vector.udata[Z] = 0;
-
-			vector.sensor_num = s - motion_sensors;
-			motion_sense_fifo_stage_data(&vector, s, 3, last_ts);
-		} else {
-			motion_sense_push_raw_xyz(s);
-		}
+	     (s->raw_xyz[X] != lux))) {
+		int32_t v = is_calibration ? raw_data[CLEAR_CRGB_IDX] : lux;
+
+		/* Illuminance only, Y and Z of the clear sensor stay 0. */
+		tcs3400_publish(s, &v, 1, last_ts);
 	}
 
 	/*
@@ -450,31 +410,12 @@ static int tcs3400_post_events(struct motion_sensor_t *s, uint32_t last_ts,
 	     ((raw_data[RED_CRGB_IDX] != TCS_SATURATION_LEVEL) &&
 	      (raw_data[BLUE_CRGB_IDX] != TCS_SATURATION_LEVEL) &&
 	      (raw_data[GREEN_CRGB_IDX] != TCS_SATURATION_LEVEL)))) {
-		if (is_spoof(rgb_s)) {
-			memcpy(last_v, rgb_s->spoof_xyz,
-			       sizeof(rgb_s->spoof_xyz));
-		} else if (is_calibration) {
-			last_v[0] = raw_data[RED_CRGB_IDX];
-			last_v[1] = raw_data[GREEN_CRGB_IDX];
-			last_v[2] = raw_data[BLUE_CRGB_IDX];
-		} else {
-			memcpy(last_v, xyz_data, sizeof(xyz_data));
-		}
-
-		if (IS_ENABLED(CONFIG_ACCEL_FIFO)) {
-			struct ec_response_motion_sensor_data vector = {
-				.flags = 0,
-			};
-			void *udata = vector.udata;
-
-			ec_motion_sensor_clamp_u16s(udata, last_v);
-
-			vector.sensor_num = rgb_s - motion_sensors;
-			motion_sense_fifo_stage_data(&vector, rgb_s, 3,
-						     last_ts);
-		} else {
-			motion_sense_push_raw_xyz(rgb_s);
+		if (is_calibration) {
+			xyz_data[X] = raw_data[RED_CRGB_IDX];
+			xyz_data[Y] = raw_data[GREEN_CRGB_IDX];
+			xyz_data[Z] = raw_data[BLUE_CRGB_IDX];
 		}
+		tcs3400_publish(rgb_s, xyz_data, 3, last_ts);
 	}
 	if (IS_ENABLED(CONFIG_ACCEL_FIFO))
 		motion_sense_fifo_commit_data();
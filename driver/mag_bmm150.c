@@ -226,7 +226,7 @@ void bmm150_normalize(const struct motion_sensor_t *s, intv3_t v, uint8_t *data)
 
 	bmm150_temp_compensate_xy(s, raw, v, r);
 	bmm150_temp_compensate_z(s, raw, v, r);
-	mag_cal_update(cal, v);
+	mag_cal_stage(cal, v);
 
 	v[X] += cal->bias[X];
 	v[Y] += cal->bias[Y];
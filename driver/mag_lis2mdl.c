@@ -57,7 +57,7 @@ void lis2mdl_normalize(const struct motion_sensor_t *s, intv3_t v, uint8_t *raw)
 		v[i] = LIS2MDL_RATIO(v[i]);
 
 	if (IS_ENABLED(CONFIG_MAG_CALIBRATE))
-		mag_cal_update(cal, v);
+		mag_cal_stage(cal, v);
 
 	v[X] += cal->bias[X];
 	v[Y] += cal->bias[Y];
@@ -244,6 +244,19 @@ int tcpc_xfer_unlocked(int port, const uint8_t *out, int out_size, uint8_t *in,
 	return rv;
 }
 
+int tcpc_xfer_vec(int port, const struct i2c_xfer_seg *segs, int count)
+{
+	int rv;
+
+	pd_wait_exit_low_power(port);
+
+	rv = i2c_xfer_vec(tcpc_config[port].i2c_info.port,
+			  tcpc_config[port].i2c_info.addr_flags, segs, count);
+
+	pd_device_accessed(port);
+	return rv;
+}
+
 int tcpc_update8(int port, int reg, uint8_t mask,
 		 enum mask_update_action action)
 {
@@ -672,12 +685,6 @@ static int tcpm_alert_status(int port, int *alert)
 	return tcpc_read16(port, TCPC_REG_ALERT, alert);
 }
 
-static int tcpm_alert_ext_status(int port, int *alert_ext)
-{
-	/* Read TCPC Extended Alert register */
-	return tcpc_read(port, TCPC_REG_ALERT_EXT, alert_ext);
-}
-
 static int tcpm_ext_status(int port, int *ext_status)
 {
 	/* Read TCPC Extended Status register */
@@ -1025,29 +1032,80 @@ int tcpci_tcpm_transmit(int port, enum tcpci_msg_type type, uint16_t header,
 				  pd_get_retry_count(port, type), type));
 }
 
+/* A register read by tcpci_read_regs() */
+struct tcpci_reg_read {
+	uint8_t reg;
+	uint8_t size; /* 1 or 2 bytes */
+	int *val;
+};
+
 /*
- * Returns true if TCPC has reset based on reading mask registers.
+ * Read several registers in one bus transaction on Zephyr, rather than one
+ * transaction per register (see i2c_xfer_vec()). If the transaction fails,
+ * the registers are read one by one, so that one failed read does not lose
+ * the others. A value is only set if its read succeeds.
  */
-static int register_mask_reset(int port)
+static int tcpci_read_regs(int port, const struct tcpci_reg_read *regs,
+			   int count)
 {
-	int mask;
-
-	mask = 0;
-	tcpc_read16(port, TCPC_REG_ALERT_MASK, &mask);
-	if (mask == TCPC_REG_ALERT_MASK_ALL)
-		return 1;
+	const int i2c_addr = tcpc_config[port].i2c_info.addr_flags;
+	struct i2c_xfer_seg segs[I2C_XFER_VEC_MAX_SEGS];
+	uint8_t buf[I2C_XFER_VEC_MAX_SEGS][2];
+	int i, rv, err, val;
+
+	for (i = 0; i < count; i++) {
+		segs[i].out = &regs[i].reg;
+		segs[i].out_size = 1;
+		segs[i].in = buf[i];
+		segs[i].in_size = regs[i].size;
+	}
 
-	mask = 0;
-	tcpc_read(port, TCPC_REG_POWER_STATUS_MASK, &mask);
-	if (mask == TCPC_REG_POWER_STATUS_MASK_ALL)
-		return 1;
+	rv = tcpc_xfer_vec(port, segs, count);
+	if (rv && count > 1) {
+		rv = EC_SUCCESS;
+		for (i = 0; i < count; i++) {
+			if (regs[i].size == 2)
+				err = tcpc_read16(port, regs[i].reg, &val);
+			else
+				err = tcpc_read(port, regs[i].reg, &val);
+			if (err)
+				rv = err;
+			else
+				*regs[i].val = val;
+		}
+		return rv;
+	}
+	if (rv)
+		return rv;
 
-	return 0;
+	/* Same byte order as tcpc_read16() */
+	for (i = 0; i < count; i++) {
+		if (regs[i].size == 1)
+			*regs[i].val = buf[i][0];
+		else if (I2C_IS_BIG_ENDIAN(i2c_addr))
+			*regs[i].val = buf[i][0] << 8 | buf[i][1];
+		else
+			*regs[i].val = buf[i][1] << 8 | buf[i][0];
+	}
+	return EC_SUCCESS;
 }
 
-static int tcpci_get_fault(int port, int *fault)
+/*
+ * Returns true if TCPC has reset based on reading mask registers.
+ */
+static int register_mask_reset(int port)
 {
-	return tcpc_read(port, TCPC_REG_FAULT_STATUS, fault);
+	int mask = 0;
+	int power_mask = 0;
+	const struct tcpci_reg_read regs[] = {
+		{ TCPC_REG_ALERT_MASK, 2, &mask },
+		{ TCPC_REG_POWER_STATUS_MASK, 1, &power_mask },
+	};
+
+	tcpci_read_regs(port, regs, ARRAY_SIZE(regs));
+
+	return mask == TCPC_REG_ALERT_MASK_ALL ||
+	       power_mask == TCPC_REG_POWER_STATUS_MASK_ALL;
 }
 
 static int tcpci_handle_fault(int port, int fault)
@@ -1134,26 +1192,35 @@ static int tcpci_clear_fault(int port, int fault)
 
 static void tcpci_check_vbus_changed(int port, int alert, uint32_t *pd_event)
 {
+	/* TCPCI Rev2 includes Safe0V detection */
+	const bool check_safe0v = TCPC_FLAGS_VSAFE0V(tcpc_config[port].flags) &&
+				  (alert & TCPC_REG_ALERT_EXT_STATUS);
+	struct tcpci_reg_read status[2];
+	int count = 0;
+	int ext_status = 0;
+	int pwr_status = 0;
+
 	/*
 	 * Check for VBus change
 	 */
-	/* TCPCI Rev2 includes Safe0V detection */
-	if (TCPC_FLAGS_VSAFE0V(tcpc_config[port].flags) &&
-	    (alert & TCPC_REG_ALERT_EXT_STATUS)) {
-		int ext_status = 0;
-
-		/* Determine if Safe0V was detected */
-		tcpm_ext_status(port, &ext_status);
-		if (ext_status & TCPC_REG_EXT_STATUS_SAFE0V)
-			/* Safe0V=1 and Present=0 */
-			tcpc_vbus[port] = BIT(VBUS_SAFE0V);
-	}
+	if (check_safe0v)
+		status[count++] = (struct tcpci_reg_read){
+			TCPC_REG_EXT_STATUS, 1, &ext_status
+		};
+	if (alert & TCPC_REG_ALERT_POWER_STATUS)
+		status[count++] = (struct tcpci_reg_read){
+			TCPC_REG_POWER_STATUS, 1, &pwr_status
+		};
+	if (count)
+		tcpci_read_regs(port, status, count);
+
+	/* Determine if Safe0V was detected */
+	if (check_safe0v && (ext_status & TCPC_REG_EXT_STATUS_SAFE0V))
+		/* Safe0V=1 and Present=0 */
+		tcpc_vbus[port] = BIT(VBUS_SAFE0V);
 
 	if (alert & TCPC_REG_ALERT_POWER_STATUS) {
-		int pwr_status = 0;
-
 		/* Determine reason for power status change */
-		tcpci_tcpm_get_power_status(port, &pwr_status);
 		if (pwr_status & TCPC_REG_POWER_STATUS_VBUS_PRES)
 			/* Safe0V=0 and Present=1 */
 			tcpc_vbus[port] = BIT(VBUS_PRESENT);
@@ -1184,6 +1251,47 @@ static void tcpci_check_vbus_changed(int port, int alert, uint32_t *pd_event)
 	}
 }
 
+/*
+ * Clear the alert bits that were handled, in one bus transaction on Zephyr.
+ * Ext first because ALERT.AlertExtended is set if any bit of ALERT_EXTENDED
+ * is set.
+ */
+static void tcpci_clear_alert(int port, int alert, int alert_ext)
+{
+	const int i2c_addr = tcpc_config[port].i2c_info.addr_flags;
+	const uint8_t ext_buf[] = { TCPC_REG_ALERT_EXT, alert_ext };
+	uint8_t alert_buf[] = { TCPC_REG_ALERT, alert & 0xff, alert >> 8 };
+	struct i2c_xfer_seg segs[2] = {};
+	int count = 0;
+
+	/* Same byte order as tcpc_write16() */
+	if (I2C_IS_BIG_ENDIAN(i2c_addr)) {
+		alert_buf[1] = alert >> 8;
+		alert_buf[2] = alert & 0xff;
+	}
+
+	if (alert_ext) {
+		segs[count].out = ext_buf;
+		segs[count++].out_size = sizeof(ext_buf);
+	}
+	if (alert) {
+		segs[count].out = alert_buf;
+		segs[count++].out_size = sizeof(alert_buf);
+	}
+	if (!count)
+		return;
+
+	if (IS_ENABLED(DEBUG_I2C_FAULT_LAST_WRITE_OP)) {
+		last_write_op[port].addr = i2c_addr;
+		last_write_op[port].reg = alert ? TCPC_REG_ALERT :
+						  TCPC_REG_ALERT_EXT;
+		last_write_op[port].val = alert ? alert & 0xFFFF : alert_ext;
+		last_write_op[port].mask = 0;
+	}
+
+	tcpc_xfer_vec(port, segs, count);
+}
+
 /*
  * Don't let the TCPC try to pull from the RX buffer forever. We typical only
  * have 1 or 2 messages waiting.
@@ -1194,6 +1302,9 @@ void tcpci_tcpc_alert(int port)
 {
 	int alert = 0;
 	int alert_ext = 0;
+	int fault = 0;
+	struct tcpci_reg_read status[2];
+	int count = 0;
 	int failed_attempts;
 	uint32_t pd_event = 0;
 	int retval = 0;
@@ -1205,19 +1316,22 @@ void tcpci_tcpc_alert(int port)
 		return;
 	}
 
-	/* Get Extended Alert register if needed */
+	/* Get Extended Alert and Fault registers if needed, at once */
 	if (alert & TCPC_REG_ALERT_ALERT_EXT)
-		tcpm_alert_ext_status(port, &alert_ext);
+		status[count++] = (struct tcpci_reg_read){
+			TCPC_REG_ALERT_EXT, 1, &alert_ext
+		};
+	if (alert & TCPC_REG_ALERT_FAULT)
+		status[count++] = (struct tcpci_reg_read){
+			TCPC_REG_FAULT_STATUS, 1, &fault
+		};
+	if (count)
+		tcpci_read_regs(port, status, count);
 
 	/* Clear any pending faults */
-	if (alert & TCPC_REG_ALERT_FAULT) {
-		int fault;
-
-		if (tcpci_get_fault(port, &fault) == EC_SUCCESS && fault != 0 &&
-		    tcpci_handle_fault(port, fault) == EC_SUCCESS &&
-		    tcpci_clear_fault(port, fault) == EC_SUCCESS)
-			CPRINTS("C%d FAULT 0x%02X handled", port, fault);
-	}
+	if (fault != 0 && tcpci_handle_fault(port, fault) == EC_SUCCESS &&
+	    tcpci_clear_fault(port, fault) == EC_SUCCESS)
+		CPRINTS("C%d FAULT 0x%02X handled", port, fault);
 
 	/*
 	 * Check for TX complete first b/c PD state machine waits on TX
@@ -1283,14 +1397,8 @@ void tcpci_tcpc_alert(int port)
 		}
 	}
 
-	/*
-	 * Clear all pending alert bits. Ext first because ALERT.AlertExtended
-	 * is set if any bit of ALERT_EXTENDED is set.
-	 */
-	if (alert_ext)
-		tcpc_write(port, TCPC_REG_ALERT_EXT, alert_ext);
-	if (alert)
-		tcpc_write16(port, TCPC_REG_ALERT, alert);
+	/* Clear all pending alert bits */
+	tcpci_clear_alert(port, alert, alert_ext);
 
 	if (alert & TCPC_REG_ALERT_CC_STATUS) {
 		/*
@@ -0,0 +1,90 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Shared processing of color light sensor samples */
+
+#ifndef __CROS_EC_ALS_PROCESS_H
+#define __CROS_EC_ALS_PROCESS_H
+
+#include "accelgyro.h"
+#include "common.h"
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Fractional bits of the channel gains. */
+#define ALS_GAIN_SHIFT 16
+
+/*
+ * Gains of the clear, red, green and blue channels, indexed by
+ * enum xyz_coeff_index. Each gain folds the channel scale and the cover
+ * compensation into a single multiplier.
+ */
+struct als_crgb_gains {
+	/* Channel scales the gains were computed from. */
+	struct als_channel_scale_t scale[COEFF_CHANNEL_COUNT];
+	/* Multipliers, with ALS_GAIN_SHIFT fractional bits. */
+	uint32_t gain[COEFF_CHANNEL_COUNT];
+	bool valid;
+};
+
+/**
+ * Recompute the gains of the channels whose scale changed.
+ *
+ * @param gains The gains to update.
+ * @param scale Scale of each channel, indexed by enum xyz_coeff_index.
+ */
+void als_crgb_update_gains(
+	struct als_crgb_gains *gains,
+	const struct als_channel_scale_t *const scale[COEFF_CHANNEL_COUNT]);
+
+/**
+ * Compute the gain normalizing samples to another integration time and
+ * analog gain: num / den.
+ *
+ * @return The gain, with ALS_GAIN_SHIFT fractional bits.
+ */
+uint32_t als_norm_gain(uint32_t num, uint32_t den);
+
+/**
+ * Apply the channel gains to the channels of a raw sample.
+ *
+ * @param gains The channel gains.
+ * @param raw The COEFF_CHANNEL_COUNT channels of the sample.
+ * @param crgb The scaled channels.
+ */
+void als_crgb_scale(const struct als_crgb_gains *gains, const uint16_t *raw,
+		    int32_t *crgb);
+
+/**
+ * Multiply channel values by a normalization gain, in place.
+ *
+ * @param crgb The values.
+ * @param norm The gain, from als_norm_gain().
+ * @param count The number of values.
+ */
+void als_crgb_normalize(int32_t *crgb, uint32_t norm, int count);
+
+/**
+ * Translate a scaled sample to the XYZ color space: normalize its channels,
+ * remove the infrared component and apply the calibration matrix.
+ *
+ * @param cal The calibration: IR factor, coefficients and offsets.
+ * @param norm The normalization gain, from als_norm_gain().
+ * @param crgb The scaled channels, from als_crgb_scale(). They are
+ *	normalized in place.
+ * @param xyz The XYZ vector, clamped to 0.
+ */
+void als_crgb_to_xyz(const struct rgb_calibration_t *cal, uint32_t norm,
+		     int32_t *crgb, int32_t *xyz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CROS_EC_ALS_PROCESS_H */
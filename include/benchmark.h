@@ -16,6 +16,15 @@
 
 #include <stdint.h>
 
+#if defined(CONFIG_ZEPHYR)
+#include <zephyr/kernel.h>
+#elif defined(CORE_CORTEX_M)
+#include "cpu.h"
+#elif defined(CORE_HOST)
+#include <time.h>
+#endif
+
+#include <algorithm>
 #include <array>
 #include <functional>
 #include <optional>
@@ -29,11 +38,77 @@ struct BenchmarkOptions {
 	bool reload_watchdog = true;
 	/* Whether to enable fast CPU clock during the test (when supported) */
 	bool use_fast_cpu = true;
+	/* Number of untimed executions of f() before the timed iterations */
+	int num_warmup_iterations = 0;
+	/* Whether to also count cycles per iteration (when supported) */
+	bool use_cycle_counter = true;
+};
+
+/* Free-running counter used for cycle-accurate timing of each iteration:
+ * the DWT cycle counter on Cortex-M, the kernel hardware cycle counter on
+ * Zephyr and a nanosecond monotonic clock (i.e. a 1 GHz "cycle") on the
+ * host build. The counter is 32 bits wide, so an iteration must complete
+ * before it wraps.
+ */
+struct CycleCounter {
+	/* Start the counter, returning false if the core doesn't have one or
+	 * it doesn't count, in which case only the timer is used.
+	 */
+	static bool enable()
+	{
+#if defined(CONFIG_ZEPHYR) || defined(CORE_HOST)
+		return true;
+#elif defined(CORE_CORTEX_M)
+		CPU_DEMCR |= CPU_DEMCR_TRCENA;
+		if (CPU_DWT_CTRL & CPU_DWT_CTRL_NOCYCCNT)
+			return false;
+		/* Writes are ignored while the DWT is locked. */
+		CPU_DWT_LAR = CPU_DWT_LAR_KEY;
+		CPU_DWT_CTRL |= CPU_DWT_CTRL_CYCCNTENA;
+
+		uint32_t start = CPU_DWT_CYCCNT;
+		for (volatile int i = 0; i < 16; i++)
+			;
+		return CPU_DWT_CYCCNT != start;
+#else
+		return false;
+#endif
+	}
+
+	static uint32_t read()
+	{
+#if defined(CONFIG_ZEPHYR)
+		return k_cycle_get_32();
+#elif defined(CORE_CORTEX_M)
+		return CPU_DWT_CYCCNT;
+#elif defined(CORE_HOST)
+		struct timespec ts;
+
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#else
+		return 0;
+#endif
+	}
+
+	/* Counter frequency in Hz */
+	static uint32_t frequency()
+	{
+#if defined(CONFIG_ZEPHYR)
+		return sys_clock_hw_cycles_per_sec();
+#elif defined(CORE_HOST)
+		return 1000000000;
+#else
+		return clock_get_freq();
+#endif
+	}
 };
 
 /* The result of a benchmark run with various timing metrics.
  * All time measurements are in micro seconds, except the average that
- * is captured in nanoseconds for increased resolution.
+ * is captured in nanoseconds for increased resolution. Cycle counts are
+ * only filled in when cycle_frequency is non-zero, and percentiles only
+ * when num_samples is non-zero.
  */
 struct BenchmarkResult {
 	/* Name of the test, used when printing results */
@@ -46,6 +121,20 @@ struct BenchmarkResult {
 	uint32_t min_time;
 	/* Maximum elapsed time (us) for a single iteration */
 	uint32_t max_time;
+	/* Median elapsed time (us) for a single iteration */
+	uint32_t median_time;
+	/* 99th percentile elapsed time (us) for a single iteration */
+	uint32_t p99_time;
+	/* Number of iterations the percentiles were computed from */
+	uint32_t num_samples;
+	/* Frequency (Hz) of the cycle counter, 0 if cycles were not counted */
+	uint32_t cycle_frequency;
+	/* Average/minimum/maximum/median/99th percentile cycles per iteration */
+	uint32_t average_cycles;
+	uint32_t min_cycles;
+	uint32_t max_cycles;
+	uint32_t median_cycles;
+	uint32_t p99_cycles;
 
 	/* Compare two BenchmarkResult structs and print delta between baseline
 	 * and other. */
@@ -53,14 +142,18 @@ struct BenchmarkResult {
 			    const BenchmarkResult &other)
 	{
 		auto print_comparison = [](std::string_view title,
-					   uint32_t baseline, uint32_t other) {
-			ccprintf(" %7s (us): %9u %9u %+9d (%+d%%)\n",
-				 title.data(), baseline, other,
+					   uint32_t baseline, uint32_t other,
+					   std::string_view unit = "us") {
+			ccprintf(" %7s (%s): %9u %9u %+9d (%+d%%)\n",
+				 title.data(), unit.data(), baseline, other,
 				 other - baseline,
-				 100 *
-					 (static_cast<int32_t>(other) -
-					  static_cast<int32_t>(baseline)) /
-					 static_cast<int32_t>(baseline));
+				 baseline == 0 ?
+					 0 :
+					 100 *
+						 (static_cast<int32_t>(other) -
+						  static_cast<int32_t>(
+							  baseline)) /
+						 static_cast<int32_t>(baseline));
 		};
 		ccprintf("-----------------------------------------------\n");
 		ccprintf("Compare: %s vs %s\n", baseline.name.data(),
@@ -72,6 +165,46 @@ struct BenchmarkResult {
 		print_comparison("Max", baseline.max_time, other.max_time);
 		print_comparison("Avg", baseline.average_time,
 				 other.average_time);
+		if (baseline.num_samples && other.num_samples) {
+			print_comparison("Median", baseline.median_time,
+					 other.median_time);
+			print_comparison("P99", baseline.p99_time,
+					 other.p99_time);
+		}
+		if (baseline.cycle_frequency && other.cycle_frequency) {
+			print_comparison("Min", baseline.min_cycles,
+					 other.min_cycles, "cyc");
+			print_comparison("Max", baseline.max_cycles,
+					 other.max_cycles, "cyc");
+			print_comparison("Avg", baseline.average_cycles,
+					 other.average_cycles, "cyc");
+		}
+		cflush();
+	}
+
+	/* Print the result as a single line of space separated key=value
+	 * pairs, prefixed with "BENCHMARK", so that runs can be extracted from
+	 * a console log and diffed against a stored baseline. Benchmark names
+	 * must not contain spaces for the line to parse.
+	 */
+	void print_machine_readable(int num_iterations) const
+	{
+		ccprintf("BENCHMARK name=%s iterations=%d elapsed_us=%u "
+			 "avg_us=%u min_us=%u max_us=%u",
+			 name.data(), num_iterations, elapsed_time,
+			 average_time, min_time, max_time);
+		if (num_samples)
+			ccprintf(" median_us=%u p99_us=%u", median_time,
+				 p99_time);
+		if (cycle_frequency)
+			ccprintf(" cycle_hz=%u avg_cycles=%u min_cycles=%u "
+				 "max_cycles=%u",
+				 cycle_frequency, average_cycles, min_cycles,
+				 max_cycles);
+		if (cycle_frequency && num_samples)
+			ccprintf(" median_cycles=%u p99_cycles=%u",
+				 median_cycles, p99_cycles);
+		ccprintf("\n");
 		cflush();
 	}
 };
@@ -80,8 +213,12 @@ struct BenchmarkResult {
  * collecting/printing the results.
  * Note that the implementation intentionally avoid dynamic memory allocations
  * and stores up to MAX_NUM_RESULTS results into a std::array.
+ * The median and 99th percentile are computed from the first MAX_NUM_SAMPLES
+ * iterations of each run, whose times and cycles are kept in std::arrays as
+ * well; the default of 0 keeps no samples so the object stays small enough
+ * for task stacks.
  */
-template <int MAX_NUM_RESULTS = 5> class Benchmark {
+template <int MAX_NUM_RESULTS = 5, int MAX_NUM_SAMPLES = 0> class Benchmark {
     public:
 	explicit Benchmark(const BenchmarkOptions &options = BenchmarkOptions())
 		: options_(options) {};
@@ -105,16 +242,33 @@ template <int MAX_NUM_RESULTS = 5> class Benchmark {
 		}
 
 		BenchmarkResult &result = results_[num_results_++];
+		result = {};
 		result.name = benchmark_name;
-		result.elapsed_time = 0;
 
 		if (options_.use_fast_cpu)
 			clock_enable_module(MODULE_FAST_CPU, 1);
 
+		for (int i = 0; i < options_.num_warmup_iterations; ++i) {
+			f();
+			if (options_.reload_watchdog)
+				watchdog_reload();
+		}
+
+		const bool use_cycles = options_.use_cycle_counter &&
+					CycleCounter::enable();
+		const int num_samples =
+			MIN(options_.num_iterations, MAX_NUM_SAMPLES);
+		uint64_t elapsed_cycles = 0;
+
 		bool valid_min_max = false;
 		for (int i = 0; i < options_.num_iterations; ++i) {
 			timestamp_t start_time = get_time();
+			uint32_t start_cycles = use_cycles ? CycleCounter::read() :
+							     0;
 			f();
+			uint32_t iteration_cycles =
+				use_cycles ? CycleCounter::read() - start_cycles :
+					     0;
 			uint32_t iteration_time = time_since32(start_time);
 
 			if (options_.reload_watchdog)
@@ -125,20 +279,61 @@ template <int MAX_NUM_RESULTS = 5> class Benchmark {
 					MAX(result.max_time, iteration_time);
 				result.min_time =
 					MIN(result.min_time, iteration_time);
+				result.max_cycles = MAX(result.max_cycles,
+							iteration_cycles);
+				result.min_cycles = MIN(result.min_cycles,
+							iteration_cycles);
 			} else {
 				result.max_time = iteration_time;
 				result.min_time = iteration_time;
+				result.max_cycles = iteration_cycles;
+				result.min_cycles = iteration_cycles;
 				valid_min_max = true;
 			}
 			result.elapsed_time += iteration_time;
+			elapsed_cycles += iteration_cycles;
+
+			if (i < num_samples) {
+				time_samples_[i] = iteration_time;
+				cycle_samples_[i] = iteration_cycles;
+			}
 		}
 
+		/* Read the frequency before the fast CPU clock is released. */
+		if (use_cycles)
+			result.cycle_frequency = CycleCounter::frequency();
+
 		if (options_.use_fast_cpu)
 			clock_enable_module(MODULE_FAST_CPU, 0);
 
 		result.average_time =
 			(result.elapsed_time) / options_.num_iterations;
 
+		if (use_cycles)
+			result.average_cycles =
+				elapsed_cycles / options_.num_iterations;
+
+		/* Times and cycles come from different clocks, so each has
+		 * its own percentiles, consistent with its min and max.
+		 */
+		if (num_samples > 0) {
+			std::sort(time_samples_.begin(),
+				  time_samples_.begin() + num_samples);
+			result.num_samples = num_samples;
+			result.median_time = percentile(time_samples_.data(),
+							num_samples, 50);
+			result.p99_time = percentile(time_samples_.data(),
+						     num_samples, 99);
+		}
+		if (num_samples > 0 && use_cycles) {
+			std::sort(cycle_samples_.begin(),
+				  cycle_samples_.begin() + num_samples);
+			result.median_cycles = percentile(
+				cycle_samples_.data(), num_samples, 50);
+			result.p99_cycles = percentile(cycle_samples_.data(),
+						       num_samples, 99);
+		}
+
 		return result;
 	}
 
@@ -155,14 +350,42 @@ template <int MAX_NUM_RESULTS = 5> class Benchmark {
 			ccprintf(" Min (us):     %u\n", result.min_time);
 			ccprintf(" Max (us):     %u\n", result.max_time);
 			ccprintf(" Avg (us):     %u\n", result.average_time);
+			if (result.num_samples) {
+				ccprintf(" Median (us):  %u\n",
+					 result.median_time);
+				ccprintf(" P99 (us):     %u\n", result.p99_time);
+			}
+			if (result.cycle_frequency) {
+				ccprintf(" Min (cyc):    %u\n",
+					 result.min_cycles);
+				ccprintf(" Max (cyc):    %u\n",
+					 result.max_cycles);
+				ccprintf(" Avg (cyc):    %u\n",
+					 result.average_cycles);
+			}
+			if (result.cycle_frequency && result.num_samples) {
+				ccprintf(" Median (cyc): %u\n",
+					 result.median_cycles);
+				ccprintf(" P99 (cyc):    %u\n",
+					 result.p99_cycles);
+			}
 			cflush();
+			result.print_machine_readable(options_.num_iterations);
 		}
 	}
 
+	/* Nearest-rank p-th percentile of n sorted samples, n > 0. */
+	static uint32_t percentile(const uint32_t *sorted_samples, int n, int p)
+	{
+		return sorted_samples[(n * p + 99) / 100 - 1];
+	}
+
     private:
 	const BenchmarkOptions options_;
 	std::array<BenchmarkResult, MAX_NUM_RESULTS> results_;
 	int num_results_ = 0;
+	std::array<uint32_t, MAX_NUM_SAMPLES> time_samples_;
+	std::array<uint32_t, MAX_NUM_SAMPLES> cycle_samples_;
 };
 
 #endif /* __CROS_EC_BENCHMARK_H */
@@ -65,6 +65,15 @@
 /* The amount of free entries that trigger an interrupt to the AP. */
 #undef CONFIG_ACCEL_FIFO_THRES
 
+/*
+ * Record timestamps along the sensor read path, from the sensor interrupt to
+ * the AP reading the FIFO, for MOTIONSENSE_CMD_TRACE_READ.
+ */
+#undef CONFIG_ACCEL_TRACE
+
+/* Number of entries of the read path trace, must be a power of 2. */
+#define CONFIG_ACCEL_TRACE_SIZE 64
+
 /*
  * Sensors in this mask are in forced mode: they needed to be polled
  * at their data rate frequency.
@@ -352,6 +361,12 @@
 /* Define to include the clear channel driver for the tcs3400 light sensor */
 #undef CONFIG_ALS_TCS3400
 
+/*
+ * Shared processing of color light sensor samples (common/als_process.c).
+ * Selected by the drivers that need it.
+ */
+#undef CONFIG_ALS_PROCESS
+
 /* Define to include Vishay VEML3328 driver */
 #undef CONFIG_ALS_VEML3328
 
@@ -2580,6 +2595,14 @@
  */
 #undef CONFIG_LID_ANGLE_UPDATE
 
+/*
+ * Compute the lid angle from the arctangents of the accelerometer vectors in
+ * the hinge plane, with a small lookup table, instead of normalizing the
+ * vectors and taking the arc cosine of their dot product. This is faster and
+ * accurate to a few hundredths of a degree.
+ */
+#undef CONFIG_LID_ANGLE_ATAN_TABLE
+
 /*
  * Defer the (re)configuration of motion sensors after the suspend event or
  * resume event.  Sensor power rails may be powered up or down asynchronously
@@ -2635,9 +2658,17 @@
 
 /*
  * The host commands are sorted in the .rodata.hcmds section so use the binary
- * search algorithm to match a command to its handler
+ * search algorithm to match a command to its handler. This relies on every
+ * command being defined as a 4-digit upper case hex value. Undefine it to fall
+ * back to a linear scan of the table.
+ */
+#define CONFIG_HOSTCMD_SECTION_SORTED
+
+/*
+ * Support EC_CMD_BATCH, which runs several host commands from a single
+ * request so that the AP can poll a set of values in one bus round trip.
  */
-#undef CONFIG_HOSTCMD_SECTION_SORTED
+#undef CONFIG_HOSTCMD_BATCH
 
 /*
  * Host command parameters and response are 32-bit aligned.  This generates
@@ -2774,6 +2805,15 @@
 /* Enable debugging and profiling statistics for hook functions */
 #undef CONFIG_HOOK_DEBUG
 
+/*
+ * Let the hook task sleep until the nearest real deadline instead of waking
+ * up every HOOK_TICK_INTERVAL. HOOK_TICK and HOOK_SECOND routines declared
+ * with DECLARE_HOOK_WITH_JITTER() then run on the next wakeup within their
+ * allowed jitter, and the task does not wake up at all for a periodic hook
+ * type without routines.
+ */
+#undef CONFIG_HOOK_TICKLESS
+
 /*****************************************************************************/
 /* CRC configuration */
 
@@ -2783,6 +2823,13 @@
 /* Enable the software routine for CRC computation */
 #undef CONFIG_SW_CRC
 
+/*
+ * Number of 256-entry lookup tables used by the software CRC-32: 1 for the
+ * compact byte at a time table (1 KiB), 4 or 8 for slice-by-4 (4 KiB) or
+ * slice-by-8 (8 KiB), which fold a word or two words in per step.
+ */
+#define CONFIG_SW_CRC_SLICES 1
+
 /*****************************************************************************/
 
 /* Enable system hibernate */
@@ -2856,6 +2903,8 @@
 #undef CONFIG_I2C
 #endif /* CONFIG_ZEPHYR */
 #undef CONFIG_I2C_DEBUG
+/* Number of records of the I2C trace, a power of two. */
+#define CONFIG_I2C_TRACE_SIZE 64
 #undef CONFIG_I2C_DEBUG_PASSTHRU
 #undef CONFIG_I2C_PASSTHRU_RESTRICTED
 #undef CONFIG_I2C_VIRTUAL_BATTERY
@@ -2895,6 +2944,27 @@
  */
 #undef CONFIG_I2C_XFER_BOARD_CALLBACK
 
+/*
+ * Enable i2c_xfer_submit(), to queue transfers run asynchronously from the
+ * hook task, or from a work queue per port on Zephyr.
+ */
+#undef CONFIG_I2C_XFER_ASYNC
+
+/*
+ * Enable the register cache of I2C peripherals, which drivers attach to the
+ * peripherals whose registers are only changed by the EC. See i2c_regcache.h.
+ */
+#undef CONFIG_I2C_REGCACHE
+
+/*
+ * Account the I2C transfers in per port and per address statistics, read with
+ * the EC_CMD_I2C_STATS host command. CONFIG_I2C_STATS_ADDRS is the number of
+ * addresses tracked, the transfers to other addresses only count in the port
+ * statistics.
+ */
+#undef CONFIG_I2C_STATS
+#define CONFIG_I2C_STATS_ADDRS 16
+
 /*
  * EC uses an I2C controller interface.
  * Note: if this is defined, i2c_init() will be called
@@ -3623,6 +3693,9 @@
 /* Include code to do online compass calibration */
 #undef CONFIG_MAG_CALIBRATE
 
+/* Include the stillness detector, to calibrate sensors when they are still */
+#undef CONFIG_STILLNESS_DETECTOR
+
 /* Microchip LPC enable debug messages */
 #undef CONFIG_MCHP_DEBUG_LPC
 
@@ -7241,6 +7314,10 @@
 
 #endif /* CONFIG_ACCEL_FIFO */
 
+#ifdef CONFIG_ALS_TCS3400
+#define CONFIG_ALS_PROCESS
+#endif
+
 /*
  * If USB PD Discharge is enabled, verify that CONFIG_USB_PD_DISCHARGE_GPIO
  * and CONFIG_USB_PD_PORT_MAX_COUNT, CONFIG_USB_PD_DISCHARGE_TCPC, or
@@ -88,6 +88,17 @@ struct console_command {
 #endif
 };
 
+#ifdef TEST_BUILD
+/**
+ * Find a command by name, or by a prefix unique to one command.
+ *
+ * @param name		Command name to find.
+ *
+ * @return A pointer to the command structure, or NULL if no match found.
+ */
+const struct console_command *find_command(const char *name);
+#endif
+
 /* Flag bits for when CONFIG_CONSOLE_COMMAND_FLAGS is enabled */
 #define CMD_FLAG_RESTRICTED 0x00000001
 
@@ -261,6 +272,8 @@ void console_has_input(void);
  *                      existing command name.  Must be less than 15 characters
  *                      long (excluding null terminator).  Note this is NOT in
  *                      quotes so it can be concatenated to form a struct name.
+ *                      Must be lowercase: the linker sorts the command table
+ *                      by name and lookups binary search it case-insensitively.
  * @param routine       Command handling routine, of the form
  *                      int handler(int argc, const char **argv)
  * @param argdesc       String describing arguments to command; NULL if none.
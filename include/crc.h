@@ -8,21 +8,29 @@
 /* CRC-32 implementation with USB constants */
 /* Note: it's a stateful CRC-32 to match the hardware block interface */
 
-#if defined(CONFIG_HW_CRC) && !defined(HOST_TOOLS_BUILD)
-#include "crc_hw.h"
-#else
 #ifdef CONFIG_ZEPHYR
 #include <stdint.h>
 #endif /* CONFIG_ZEPHYR */
 
+/*
+ * Boards pick the implementation:
+ * - CONFIG_HW_CRC: the static context variant runs on the chip CRC unit.
+ * - CONFIG_SW_CRC: table driven software, CONFIG_SW_CRC_SLICES selects the
+ *   compact table or slice-by-4/8.
+ * The provided context variant is always software.
+ */
+
+#if defined(CONFIG_HW_CRC) && !defined(HOST_TOOLS_BUILD)
+#include "crc_hw.h"
+#endif
+
 #ifndef HOST_TOOLS_BUILD
 #ifdef __cplusplus
 extern "C" {
 #endif
 #endif
 
-/* Use software implementation */
-
+#if !defined(CONFIG_HW_CRC) || defined(HOST_TOOLS_BUILD)
 /* Static context variant */
 
 void crc32_init(void);
@@ -40,6 +48,7 @@ void crc32_hash32(uint32_t val);
 void crc32_hash16(uint16_t val);
 
 uint32_t crc32_result(void);
+#endif /* !CONFIG_HW_CRC || HOST_TOOLS_BUILD */
 
 /* Provided context variant */
 
@@ -79,6 +88,4 @@ uint16_t cros_crc16(const uint8_t *data, int len, uint16_t previous_crc);
 #endif
 #endif
 
-#endif /* CONFIG_HW_CRC && !HOST_TOOLS_BUILD */
-
 #endif /* __CROS_EC_CRC_H */
@@ -12,6 +12,7 @@
 #include "accelgyro_bmi260.h"
 #include "accelgyro_bmi_common_public.h"
 #include "mag_bmm150.h"
+#include "motion_sense_fifo.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -241,12 +242,14 @@ void bmi_normalize(const struct motion_sensor_t *s, intv3_t v, uint8_t *input);
  *
  * @accel: base sensor
  * @hdr: the header to decode
- * @last_ts: the last timestamp of fifo interrupt.
+ * @batch: batch the decoded samples are added to, timed at the last fifo
+ *         interrupt.
  * @bp: current pointer in the buffer, updated when processing the header.
  * @ep: pointer to the end of the valid data in the buffer.
  */
 int bmi_decode_header(struct motion_sensor_t *accel, enum fifo_header hdr,
-		      uint32_t last_ts, uint8_t **bp, uint8_t *ep);
+		      struct motion_sense_fifo_batch *batch, uint8_t **bp,
+		      uint8_t *ep);
 /**
  * Retrieve hardware FIFO from sensor,
  * - put data in Sensor Hub fifo.
@@ -9,6 +9,7 @@
 #define __CROS_EC_DRIVER_ALS_TCS3400_PUBLIC_H
 
 #include "accelgyro.h"
+#include "als_process.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -69,6 +70,12 @@ struct tcs3400_rgb_drv_data_t {
 
 	struct rgb_calibration_t calibration;
 	struct tcs_saturation_t saturation; /* saturation adjustment */
+
+	/* Channel gains, cached until the channel scales change */
+	struct als_crgb_gains gains;
+	/* Normalization gain, cached for the saturation it was computed for */
+	struct tcs_saturation_t norm_saturation;
+	uint32_t norm;
 };
 
 extern const struct accelgyro_drv tcs3400_drv;
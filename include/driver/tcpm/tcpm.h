@@ -87,6 +87,13 @@ static inline int tcpc_xfer_unlocked(int port, const uint8_t *out, int out_size,
 				 out_size, in, in_size, flags);
 }
 
+static inline int tcpc_xfer_vec(int port, const struct i2c_xfer_seg *segs,
+				int count)
+{
+	return i2c_xfer_vec(tcpc_config[port].i2c_info.port,
+			    tcpc_config[port].i2c_info.addr_flags, segs, count);
+}
+
 static inline int tcpc_read_block(int port, int reg, uint8_t *in, int size)
 {
 	return i2c_read_block(tcpc_config[port].i2c_info.port,
@@ -130,6 +137,7 @@ int tcpc_xfer(int port, const uint8_t *out, int out_size, uint8_t *in,
 	      int in_size);
 int tcpc_xfer_unlocked(int port, const uint8_t *out, int out_size, uint8_t *in,
 		       int in_size, int flags);
+int tcpc_xfer_vec(int port, const struct i2c_xfer_seg *segs, int count);
 
 int tcpc_update8(int port, int reg, uint8_t mask,
 		 enum mask_update_action action);
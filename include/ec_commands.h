@@ -2934,6 +2934,31 @@ enum motionsense_command {
 	 */
 	MOTIONSENSE_CMD_GET_ACTIVITY = 20,
 
+	/*
+	 * Return a portion of the fifo, delta encoded.
+	 * Same entries as MOTIONSENSE_CMD_FIFO_READ, in a compact byte stream
+	 * described with struct ec_response_motion_sense_fifo_delta.
+	 */
+	MOTIONSENSE_CMD_FIFO_READ_DELTA = 21,
+
+	/*
+	 * Return, and optionally reset, the statistics of the sensor reads
+	 * scheduled by the EC (sensors not in interrupt mode).
+	 */
+	MOTIONSENSE_CMD_SCHED_STATS = 22,
+
+	/*
+	 * Set or get the interrupt coalescing policy of a sensor, return the
+	 * FIFO interrupt statistics.
+	 */
+	MOTIONSENSE_CMD_FIFO_COALESCE = 23,
+
+	/*
+	 * Return, and remove, the oldest entries of the read path trace, see
+	 * struct ec_response_motion_sense_trace.
+	 */
+	MOTIONSENSE_CMD_TRACE_READ = 24,
+
 	/* Number of motionsense sub-commands. */
 	MOTIONSENSE_NUM_CMDS,
 };
@@ -3032,6 +3057,91 @@ struct ec_response_motion_sensor_data {
 	};
 } __ec_todo_packed;
 
+/*
+ * Statistics of the sensor reads scheduled by the EC. The jitter is the
+ * distance between the time a read starts and the time it was due.
+ */
+struct ec_response_motion_sense_sched_stats {
+	/* Number of scheduled reads. */
+	uint32_t reads;
+	/* Reads that started more than the minimal motion interval late. */
+	uint32_t late_reads;
+	/* Collections skipped because the EC fell a full period behind. */
+	uint32_t missed_reads;
+	/* Average and maximal jitter, in us. */
+	uint32_t jitter_avg_us;
+	uint32_t jitter_max_us;
+} __ec_todo_packed;
+
+/*
+ * Interrupt coalescing policy of a sensor, and FIFO interrupts statistics of
+ * the EC.
+ *
+ * Without a policy, the FIFO interrupts the AP every ec_rate of the sensor.
+ * With one, the EC holds the sensor events back until the oldest one is about
+ * to wait max_latency_ms or max_events are pending, and flushes the events of
+ * all the sensors at once.
+ */
+struct ec_response_motion_sense_fifo_coalesce {
+	/* Longest wait of an event in the FIFO, 0 when there is no policy. */
+	uint16_t max_latency_ms;
+	/* Most events of the sensor pending in the FIFO, 0 for no limit. */
+	uint16_t max_events;
+	/* MKBP events sent to the AP for the FIFO. */
+	uint32_t interrupts;
+	/*
+	 * Interrupts the sensors ec_rate would have raised, that the policies
+	 * coalesced with later ones.
+	 */
+	uint32_t interrupts_saved;
+} __ec_todo_packed;
+
+/* MOTIONSENSE_CMD_FIFO_COALESCE flags */
+enum motionsense_fifo_coalesce_flags {
+	/* Update the policy of the sensor. */
+	MOTIONSENSE_FIFO_COALESCE_SET = BIT(0),
+	/* Clear the statistics once returned. */
+	MOTIONSENSE_FIFO_COALESCE_RESET = BIT(1),
+};
+
+/* Points of the sensor read path, recorded by the EC. */
+enum motionsense_trace_point {
+	/* The sensor raised an interrupt, time taken by the interrupt handler. */
+	MOTIONSENSE_TRACE_IRQ = 0,
+	/* The motion task starts reading the sensor. */
+	MOTIONSENSE_TRACE_TASK = 1,
+	/* The first sample of the sensor since the last commit is staged. */
+	MOTIONSENSE_TRACE_STAGE = 2,
+	/* The staged samples of the sensor are committed, visible to the AP. */
+	MOTIONSENSE_TRACE_COMMIT = 3,
+	/* The AP read entries from the FIFO, for all the sensors. */
+	MOTIONSENSE_TRACE_HOST_READ = 4,
+	MOTIONSENSE_TRACE_POINT_COUNT,
+};
+
+/* sensor_num of the trace points not tied to a sensor. */
+#define MOTIONSENSE_TRACE_NO_SENSOR 0xff
+
+struct ec_motion_sense_trace_entry {
+	/* EC time, in us. */
+	uint32_t timestamp;
+	uint8_t sensor_num;
+	/* enum motionsense_trace_point */
+	uint8_t point;
+} __ec_todo_packed;
+
+/*
+ * Read path trace, oldest entries first. The EC drops the oldest entries when
+ * its trace buffer is full.
+ */
+struct ec_response_motion_sense_trace {
+	/* Number of entries in this response. */
+	uint16_t count;
+	/* Entries dropped since the last response. */
+	uint16_t lost;
+	struct ec_motion_sense_trace_entry entries[FLEXIBLE_ARRAY_MEMBER_SIZE];
+} __ec_todo_packed;
+
 /* Response to AP reporting calibration data for a given sensor. */
 struct ec_response_online_calibration_data {
 	/** The calibration values. */
@@ -3059,6 +3169,56 @@ struct ec_response_motion_sense_fifo_data {
 	struct ec_response_motion_sensor_data data[0];
 } __ec_todo_packed;
 
+/*
+ * Delta encoded fifo entries, used by MOTIONSENSE_CMD_FIFO_READ_DELTA.
+ *
+ * Each fifo entry starts with a header byte: the encoding in the high bits,
+ * the sensor number in the low bits (0 for MOTIONSENSE_FIFO_DELTA_RAW, the
+ * entry has its own). The encoding state is reset for every
+ * response, so each response decodes on its own:
+ *
+ * - MOTIONSENSE_FIFO_DELTA_RAW: the 8 bytes entry follows unchanged, as it
+ *   would be returned by MOTIONSENSE_CMD_FIFO_READ. It is used for the first
+ *   timestamp entry of a sensor, for a timestamp more than UINT16_MAX us
+ *   after the previous one, for entries with flags (other than
+ *   MOTIONSENSE_SENSOR_FLAG_TIMESTAMP alone on a timestamp entry) and for
+ *   sensor numbers that do not fit in the header.
+ * - MOTIONSENSE_FIFO_DELTA_TIMESTAMP: timestamp entry with no other flag, a
+ *   little endian uint16_t follows, to add to the previous timestamp of the
+ *   same sensor.
+ * - MOTIONSENSE_FIFO_DELTA_AXES8: data entry with no flag, three int8_t
+ *   follow, to add to the previous data of the same sensor.
+ * - MOTIONSENSE_FIFO_DELTA_AXES16: data entry with no flag, the three
+ *   little endian int16_t axes follow. It is used for the first data entry
+ *   of a sensor, and when a change does not fit in an int8_t.
+ *
+ * Both the timestamp and the data references are updated by every entry of
+ * their kind, including MOTIONSENSE_FIFO_DELTA_RAW entries.
+ */
+#define MOTIONSENSE_FIFO_DELTA_SENSOR_MASK 0x3f
+#define MOTIONSENSE_FIFO_DELTA_MAX_SENSORS \
+	(MOTIONSENSE_FIFO_DELTA_SENSOR_MASK + 1)
+#define MOTIONSENSE_FIFO_DELTA_KIND_SHIFT 6
+
+enum motionsense_fifo_delta_kind {
+	MOTIONSENSE_FIFO_DELTA_RAW = 0,
+	MOTIONSENSE_FIFO_DELTA_TIMESTAMP = 1,
+	MOTIONSENSE_FIFO_DELTA_AXES8 = 2,
+	MOTIONSENSE_FIFO_DELTA_AXES16 = 3,
+};
+
+/* Largest encoded entry: header byte and a raw entry. */
+#define MOTIONSENSE_FIFO_DELTA_MAX_ENTRY_SIZE \
+	(1 + sizeof(struct ec_response_motion_sensor_data))
+
+struct ec_response_motion_sense_fifo_delta {
+	/* Number of fifo entries encoded in data. */
+	uint16_t number_data;
+	/* Number of bytes used in data. */
+	uint16_t size;
+	uint8_t data[FLEXIBLE_ARRAY_MEMBER_SIZE];
+} __ec_todo_packed;
+
 /* List supported activity recognition */
 enum motionsensor_activity {
 	MOTIONSENSE_ACTIVITY_RESERVED = 0,
@@ -3242,7 +3402,11 @@ struct ec_params_motion_sense {
 		/* Used for MOTIONSENSE_CMD_FIFO_INFO */
 		/* (no params) */
 
-		/* Used for MOTIONSENSE_CMD_FIFO_READ */
+		/*
+		 * Used for MOTIONSENSE_CMD_FIFO_READ,
+		 * MOTIONSENSE_CMD_FIFO_READ_DELTA and
+		 * MOTIONSENSE_CMD_TRACE_READ.
+		 */
 		struct __ec_todo_unpacked {
 			/*
 			 * Number of expected vector to return.
@@ -3324,6 +3488,24 @@ struct ec_params_motion_sense {
 			uint8_t sensor_num;
 			uint8_t activity; /* enum motionsensor_activity */
 		} get_activity;
+
+		/* Used for MOTIONSENSE_CMD_SCHED_STATS. */
+		struct __ec_todo_unpacked {
+			uint8_t sensor_num;
+			/* Clear the statistics once returned when set. */
+			uint8_t reset;
+		} sched_stats;
+
+		/* Used for MOTIONSENSE_CMD_FIFO_COALESCE. */
+		struct __ec_todo_unpacked {
+			uint8_t sensor_num;
+			/* See enum motionsense_fifo_coalesce_flags. */
+			uint8_t flags;
+			/* New policy, 0 to interrupt every ec_rate again. */
+			uint16_t max_latency_ms;
+			/* 0 for no limit. */
+			uint16_t max_events;
+		} fifo_coalesce;
 	} __ec_todo_packed;
 } __ec_todo_packed;
 
@@ -3444,6 +3626,8 @@ struct ec_response_motion_sense {
 
 		struct ec_response_motion_sense_fifo_data fifo_read;
 
+		struct ec_response_motion_sense_fifo_delta fifo_read_delta;
+
 		struct ec_response_online_calibration_data online_calib_read;
 
 		struct __ec_todo_packed {
@@ -3479,6 +3663,12 @@ struct ec_response_motion_sense {
 		struct __ec_todo_unpacked {
 			uint8_t state;
 		} get_activity;
+
+		struct ec_response_motion_sense_sched_stats sched_stats;
+
+		struct ec_response_motion_sense_fifo_coalesce fifo_coalesce;
+
+		struct ec_response_motion_sense_trace trace_read;
 	};
 } __ec_todo_packed;
 
@@ -8281,6 +8471,169 @@ struct ec_params_switch_enable_poe {
 	uint8_t enabled;
 } __ec_align1;
 
+/*
+ * Read the oldest records of the I2C trace, and remove them. The trace holds
+ * the transfers of the peripherals enabled with the "i2ctrace" console
+ * command. Only whole records are returned; count is 0 when the trace is
+ * empty.
+ */
+#define EC_CMD_I2C_TRACE_READ 0x0146
+
+/* Bytes of data kept per record: written bytes first, then read bytes. */
+#define EC_I2C_TRACE_DATA_SIZE 10
+
+struct ec_i2c_trace_record {
+	/* Start of the transfer, low 32 bits of the EC time in us */
+	uint32_t timestamp;
+	/* Duration of the transfer in us, saturated at UINT16_MAX */
+	uint16_t duration;
+	/* I2C port */
+	uint8_t port;
+	/* 7-bit I2C address */
+	uint8_t addr;
+	/* Bytes written and read by the transfer */
+	uint16_t out_size;
+	uint16_t in_size;
+	/* Result: EC_SUCCESS, an EC error code or a negative errno */
+	int16_t result;
+	/*
+	 * The first MIN(out_size, EC_I2C_TRACE_DATA_SIZE) bytes written, then
+	 * as many of the bytes read as fit. No byte read is kept when the
+	 * transfer failed.
+	 */
+	uint8_t data[EC_I2C_TRACE_DATA_SIZE];
+} __ec_align4;
+
+struct ec_response_i2c_trace_read {
+	/* Number of records */
+	uint16_t count;
+	/* Records dropped since the last read because the trace was full */
+	uint16_t lost;
+	struct ec_i2c_trace_record records[FLEXIBLE_ARRAY_MEMBER_SIZE];
+} __ec_align4;
+
+BUILD_ASSERT(sizeof(struct ec_i2c_trace_record) == 24);
+
+/*
+ * Read the statistics of the I2C transfers, per port or per peripheral
+ * address, or reset them.
+ */
+#define EC_CMD_I2C_STATS 0x0147
+
+enum ec_i2c_stats_cmd {
+	/* Get the statistics of port <index> */
+	EC_I2C_STATS_GET_PORT = 0,
+	/* Get the statistics of the <index>th address seen */
+	EC_I2C_STATS_GET_ADDR = 1,
+	/* Reset all the statistics, no response */
+	EC_I2C_STATS_RESET = 2,
+};
+
+/*
+ * Transfer latency histogram: bucket i counts the transfers shorter than
+ * (EC_I2C_STATS_HIST_BASE_US << i), which are not in bucket i - 1. The last
+ * bucket also counts all the longer transfers.
+ */
+#define EC_I2C_STATS_HIST_BUCKETS 8
+#define EC_I2C_STATS_HIST_BASE_US 64
+
+/* Address of the port statistics */
+#define EC_I2C_STATS_NO_ADDR 0xff
+
+struct ec_params_i2c_stats {
+	uint8_t cmd; /* enum ec_i2c_stats_cmd */
+	uint8_t index;
+} __ec_align1;
+
+struct ec_i2c_stats {
+	/* Transfers, and transfers which failed after all their retries */
+	uint32_t xfers;
+	uint32_t errors;
+	/*
+	 * Attempts not acknowledged by the peripheral. Only Zephyr builds tell
+	 * them apart, other builds count them in errors only and report 0.
+	 */
+	uint32_t nacks;
+	/* Attempts after the first one of a transfer */
+	uint32_t retries;
+	/* Bytes written and read */
+	uint32_t bytes_out;
+	uint32_t bytes_in;
+	/* Time spent in transfers, in us */
+	uint32_t busy_us;
+	/* Time spent waiting for the port lock, in us. Ports only. */
+	uint32_t lock_wait_us;
+	uint32_t hist[EC_I2C_STATS_HIST_BUCKETS];
+} __ec_align4;
+
+struct ec_response_i2c_stats {
+	/*
+	 * Number of ports, or of addresses seen. When index is not below
+	 * count, only count is valid.
+	 */
+	uint8_t count;
+	uint8_t port;
+	/* 7-bit I2C address, or EC_I2C_STATS_NO_ADDR */
+	uint8_t addr;
+	uint8_t reserved;
+	/*
+	 * Time since the statistics were last reset, or since the EC booted,
+	 * in ms. Divide busy_us by it to get the utilization.
+	 */
+	uint32_t elapsed_ms;
+	struct ec_i2c_stats stats;
+} __ec_align4;
+
+/*
+ * Run several host commands in one request, saving the bus transaction,
+ * header, checksum and status poll of each one.
+ *
+ * The params are a struct ec_params_batch followed by num_cmds sub-commands,
+ * each a struct ec_params_batch_cmd followed by params_size bytes of params.
+ * The response is a struct ec_response_batch followed by num_done
+ * sub-responses, each a struct ec_response_batch_cmd followed by
+ * response_size bytes of response. Params and responses are padded to
+ * EC_BATCH_ALIGN() so that every header and payload stays 4-byte aligned.
+ *
+ * Sub-commands run in order. The result of each one is reported in its own
+ * header; the batch carries on after a failure unless
+ * EC_BATCH_FLAG_STOP_ON_ERROR is set. It also stops early, with num_done
+ * less than num_cmds, when the next sub-response might not fit. Nested
+ * batches, and commands that reboot or respond before they complete, are
+ * rejected with EC_RES_INVALID_COMMAND.
+ */
+#define EC_CMD_BATCH 0x0148
+
+#define EC_BATCH_ALIGN(size) (((size) + 3) & ~3)
+
+/* Stop at the first sub-command that doesn't return EC_RES_SUCCESS. */
+#define EC_BATCH_FLAG_STOP_ON_ERROR BIT(0)
+
+struct ec_params_batch {
+	uint8_t num_cmds;
+	uint8_t flags; /* EC_BATCH_FLAG_* */
+	uint16_t reserved;
+} __ec_align4;
+
+struct ec_params_batch_cmd {
+	uint16_t command;
+	uint8_t version;
+	uint8_t reserved;
+	uint16_t params_size;
+	/* Maximum size of the response the host is prepared to receive */
+	uint16_t response_max;
+} __ec_align4;
+
+struct ec_response_batch {
+	uint8_t num_done; /* Sub-commands that ran */
+	uint8_t reserved[3];
+} __ec_align4;
+
+struct ec_response_batch_cmd {
+	uint16_t result; /* enum ec_status */
+	uint16_t response_size;
+} __ec_align4;
+
 /*****************************************************************************/
 /* The command range 0x200-0x2FF is reserved for Rotor. */
 
@@ -304,7 +304,20 @@ struct hook_data {
 	/* Hook processing routine. */
 	void (*routine)(void);
 	/* Priority; low numbers = higher priority. */
-	int priority;
+	uint16_t priority; /* HOOK_PRIO_LAST = 9999 */
+	/*
+	 * How late (ms) a HOOK_TICK or HOOK_SECOND routine may run in
+	 * CONFIG_HOOK_TICKLESS mode. 0 means it needs full resolution.
+	 */
+	uint16_t jitter_ms;
+};
+
+/* Run time statistics of a single hook routine, for CONFIG_HOOK_DEBUG */
+struct hook_stats {
+	/* Maximum run time (us) */
+	uint32_t max_run_time;
+	/* Moving average of the run time (us) */
+	uint32_t avg_run_time;
 };
 
 /**
@@ -380,11 +393,28 @@ int hook_call_deferred(const struct deferred_data *data, int us);
  *			unless there's a compelling reason to care about the
  *			order in which hooks are called.
  */
-#define DECLARE_HOOK(hooktype, routine, priority)                            \
+#define DECLARE_HOOK(hooktype, routine, priority) \
+	DECLARE_HOOK_WITH_JITTER(hooktype, routine, priority, 0)
+
+/**
+ * Register a periodic hook routine that tolerates running late.
+ *
+ * With CONFIG_HOOK_TICKLESS, the hook task does not wake up for a HOOK_TICK
+ * or HOOK_SECOND deadline on its own as long as every routine of that type
+ * allows some jitter; instead the routines run on the next wakeup that falls
+ * within the allowed jitter, or when the jitter expires. Without
+ * CONFIG_HOOK_TICKLESS this is the same as DECLARE_HOOK().
+ *
+ * @param hooktype	Type of hook for routine (HOOK_TICK or HOOK_SECOND)
+ * @param routine	Hook routine, with prototype void routine(void)
+ * @param priority	Priority, see DECLARE_HOOK()
+ * @param jitter_ms	How late (ms) the routine may be called
+ */
+#define DECLARE_HOOK_WITH_JITTER(hooktype, routine, priority, jitter_ms)     \
 	const struct hook_data __keep __no_sanitize_address CONCAT4(         \
 		__hook_, hooktype, _, routine)                               \
 		__attribute__((section(".rodata." STRINGIFY(hooktype)))) = { \
-			routine, priority                                    \
+			routine, priority, jitter_ms                         \
 		}
 
 /**
@@ -421,6 +451,7 @@ int hook_call_deferred(const struct deferred_data *data, int us);
 	{                                            \
 		func();                              \
 	}
+#define DECLARE_HOOK_WITH_JITTER(t, func, p, j) DECLARE_HOOK(t, func, p)
 #define DECLARE_DEFERRED(func)                     \
 	void CONCAT2(unused_deferred_, func)(void) \
 	{                                          \
@@ -13,6 +13,7 @@
 #include "ec_commands.h"
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -217,6 +218,22 @@ int host_is_event_set(enum host_event_code event);
  */
 const struct host_command *find_host_command(int command);
 
+/**
+ * Find a command in a table of commands sorted by command number.
+ *
+ * Both the legacy linker scripts and the Zephyr iterable section emit the
+ * host command table ordered by command number, so the lookup is a binary
+ * search rather than a scan of every registered command.
+ *
+ * @param table		First entry of the sorted table
+ * @param count		Number of entries in the table
+ * @param command	Command number to find
+ * @return The command structure, or NULL if no match found.
+ */
+const struct host_command *
+host_command_find_sorted(const struct host_command *table, size_t count,
+			 int command);
+
 #ifdef CONFIG_HOSTCMD_X86
 
 FORWARD_DECLARE_ENUM(power_state);
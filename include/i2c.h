@@ -12,6 +12,7 @@
 #include "gpio_signal.h"
 #include "host_command.h"
 #include "stddef.h"
+#include "task_id.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -208,6 +209,107 @@ int i2c_xfer_unlocked(const int port, const uint16_t addr_flags,
 		      const uint8_t *out, int out_size, uint8_t *in,
 		      int in_size, int flags);
 
+/*
+ * Segment of a scatter-gather transfer, see i2c_xfer_vec(): data to send,
+ * then data to receive, like i2c_xfer().
+ */
+struct i2c_xfer_seg {
+	const uint8_t *out;
+	int out_size;
+	uint8_t *in;
+	int in_size;
+};
+
+/* Most segments of one scatter-gather transfer */
+#define I2C_XFER_VEC_MAX_SEGS 4
+
+/**
+ * Run a list of segments with a peripheral, in one locked bus transaction.
+ * Each segment starts with a repeated start, and the bus is only released
+ * after the last one. This replaces a series of register accesses, each one
+ * taking the lock and the bus on its own.
+ *
+ * Only Zephyr builds merge the segments into one bus transaction. Legacy chip
+ * drivers do not all support a repeated start after a read, so there the
+ * segments are separate transfers run back to back under the port lock. They
+ * take as many bus transactions as one call per segment, only the lock round
+ * trips are saved.
+ *
+ * @param port		Port to access
+ * @param addr_flags	Peripheral device address
+ * @param segs		The segments, at most I2C_XFER_VEC_MAX_SEGS
+ * @param count		Number of segments
+ * @return EC_SUCCESS, or non-zero if any segment failed.
+ */
+int i2c_xfer_vec(const int port, const uint16_t addr_flags,
+		 const struct i2c_xfer_seg *segs, int count);
+
+/**
+ * Same as i2c_xfer_vec, but the bus is not implicitly locked.  It must be
+ * called between i2c_lock(port, 1) and i2c_lock(port, 0).
+ */
+int i2c_xfer_vec_unlocked(const int port, const uint16_t addr_flags,
+			  const struct i2c_xfer_seg *segs, int count);
+
+/* Progress of an asynchronous transfer */
+enum i2c_xfer_state {
+	/* Never submitted */
+	I2C_XFER_IDLE = 0,
+	/* Waiting for its port */
+	I2C_XFER_QUEUED,
+	/* On the bus */
+	I2C_XFER_RUNNING,
+	/* Result set, may be submitted again */
+	I2C_XFER_DONE,
+};
+
+/*
+ * Descriptor of an asynchronous transfer, see i2c_xfer_submit(). The caller
+ * owns it and its buffers, and must keep them until the transfer completes.
+ */
+struct i2c_xfer_desc {
+	int port;
+	uint16_t addr_flags;
+	const uint8_t *out;
+	int out_size;
+	uint8_t *in;
+	int in_size;
+	/* Called once the transfer is done, or NULL */
+	void (*done)(struct i2c_xfer_desc *desc);
+	/* Without callback, event set to the task once the transfer is done */
+	task_id_t task;
+	uint32_t event;
+	/* Set by i2c_xfer_submit() and the context running the transfer */
+	volatile enum i2c_xfer_state state;
+	/* Result of the transfer, valid once state is I2C_XFER_DONE */
+	int result;
+	/* Private: next transfer in the queue */
+	struct i2c_xfer_desc *next;
+};
+
+/**
+ * Queue an I2C_XFER_SINGLE transfer, and return without waiting for it.
+ *
+ * Transfers of a port run in the order they were submitted, blocking
+ * i2c_xfer() calls may run in between. When a transfer is done, its result
+ * is set, then its callback is called or its event is set. The callback
+ * runs without the port lock, it may submit transfers.
+ *
+ * On Zephyr each port runs its transfers and callbacks from its own work
+ * queue thread, so the ports run in parallel. Elsewhere the hook task runs
+ * the oldest queued transfer of all the ports, one per deferred call, so the
+ * ports take turns and other hooks run in between.
+ *
+ * Can be called from interrupt context. The descriptor must be zeroed
+ * before its first submission.
+ *
+ * @param desc		The transfer
+ * @return EC_SUCCESS, EC_ERROR_BUSY if desc is queued or running, or
+ *	EC_ERROR_INVAL if the port does not exist. The result of the transfer
+ *	itself is in desc->result.
+ */
+int i2c_xfer_submit(struct i2c_xfer_desc *desc);
+
 #define I2C_LINE_SCL_HIGH BIT(0)
 #define I2C_LINE_SDA_HIGH BIT(1)
 #define I2C_LINE_IDLE (I2C_LINE_SCL_HIGH | I2C_LINE_SDA_HIGH)
@@ -549,10 +651,52 @@ void i2c_end_xfer_notify(const int port, const uint16_t addr_flags);
  * @param in_data: pointer to data read
  * @param in_size: size of data read
  * @param ret: return of i2c transaction (EC_SUCCESS or otherwise on failure)
+ * @param start_us: low 32 bits of the time the transaction started at
  */
 void i2c_trace_notify(int port, uint16_t addr_flags, const uint8_t *out_data,
 		      size_t out_size, const uint8_t *in_data, size_t in_size,
-		      int ret);
+		      int ret, uint32_t start_us);
+
+/**
+ * Same as i2c_trace_notify(), for a scatter-gather transfer run as one bus
+ * transaction. It is recorded as one transfer, writing the bytes of all the
+ * segments and then reading the bytes of all the segments.
+ *
+ * @param port: I2C port number
+ * @param addr_flags: peripheral device address
+ * @param segs: segments of the transfer
+ * @param count: number of segments
+ * @param ret: return of i2c transaction (EC_SUCCESS or otherwise on failure)
+ * @param start_us: low 32 bits of the time the transaction started at
+ */
+void i2c_trace_notify_vec(int port, uint16_t addr_flags,
+			  const struct i2c_xfer_seg *segs, int count, int ret,
+			  uint32_t start_us);
+
+/**
+ * Defined in common/i2c_stats.c, used by i2c controller to account a
+ * transaction in the bus statistics.
+ *
+ * @param port: I2C port number
+ * @param addr_flags: peripheral device address
+ * @param out_size: size of data written
+ * @param in_size: size of data read
+ * @param ret: return of i2c transaction (EC_SUCCESS or otherwise on failure)
+ * @param duration_us: time spent in the transaction, including retries
+ * @param attempts: number of attempts, 0 if the transaction was not started
+ * @param nacks: number of attempts not acknowledged by the peripheral
+ */
+void i2c_stats_xfer(int port, uint16_t addr_flags, int out_size, int in_size,
+		    int ret, uint32_t duration_us, int attempts, int nacks);
+
+/**
+ * Defined in common/i2c_stats.c, used by i2c controller to account the time
+ * spent waiting for the lock of a port.
+ *
+ * @param port: I2C port number
+ * @param wait_us: time spent waiting
+ */
+void i2c_stats_lock_wait(int port, uint32_t wait_us);
 
 /**
  * Convert an enum i2c_freq constant to numeric frequency in kHz.
@@ -0,0 +1,175 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Register cache of I2C peripherals */
+
+#ifndef __CROS_EC_I2C_REGCACHE_H
+#define __CROS_EC_I2C_REGCACHE_H
+
+#include "common.h"
+#include "util.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Write the registers back when the chipset resumes, for peripherals whose
+ * power is removed while the chipset is suspended.
+ */
+#define I2C_REGCACHE_RESTORE_ON_RESUME BIT(0)
+
+/*
+ * Cache of the 8-bit addressed registers of a peripheral, used by the
+ * i2c_readN(), i2c_writeN() and i2c_updateN() functions once attached.
+ *
+ * Registers are read from the bus once, then served from the cache. Every
+ * write goes to the bus, and marks the register dirty: its value was set by
+ * the EC, and is what a resume restores. The registers the peripheral changes
+ * on its own (status, interrupts, counters) must be declared volatile.
+ *
+ * Only accesses of reg_bytes bytes to registers below num_regs are cached;
+ * other accesses go to the bus and invalidate the registers they write. Writes
+ * through i2c_xfer() or i2c_write_block() are not seen by the cache.
+ *
+ * The cache lives in RAM which is not preserved, so it starts empty after a
+ * reset or a sysjump. Drivers invalidate it when they reset the peripheral.
+ * Peripherals using PEC are not supported.
+ */
+struct i2c_regcache {
+	/* Number of cached registers, from 0 */
+	const uint16_t num_regs;
+	/* Size of the registers in bytes */
+	const uint8_t reg_bytes;
+	/* I2C_REGCACHE_* flags */
+	const uint8_t flags;
+	/* Bitmap of the volatile registers, or NULL */
+	const uint32_t *const volatile_regs;
+
+	/* Values, in bus byte order */
+	uint8_t *const vals;
+	/* Bitmaps of the valid and dirty registers */
+	uint32_t *const valid;
+	uint32_t *const dirty;
+
+	int port;
+	uint16_t addr_flags;
+	/* Changed by every write, to drop fills racing with it */
+	uint32_t seq;
+
+	uint32_t hits;
+	uint32_t misses;
+
+	struct i2c_regcache *next;
+};
+
+#define I2C_REGCACHE_WORDS(num_regs) DIV_ROUND_UP(num_regs, 32)
+
+/**
+ * Define the register cache of a peripheral.
+ *
+ * @param name Name of the struct i2c_regcache.
+ * @param _num_regs Number of cached registers.
+ * @param _reg_bytes Size of the registers in bytes.
+ * @param _volatile_regs Bitmap of the volatile registers, or NULL.
+ * @param _flags I2C_REGCACHE_* flags.
+ */
+#define I2C_REGCACHE_DEFINE(name, _num_regs, _reg_bytes, _volatile_regs,     \
+			    _flags)                                          \
+	static uint8_t name##_vals[(_num_regs) * (_reg_bytes)];              \
+	static uint32_t name##_valid[I2C_REGCACHE_WORDS(_num_regs)];         \
+	static uint32_t name##_dirty[I2C_REGCACHE_WORDS(_num_regs)];         \
+	struct i2c_regcache name = {                                         \
+		.num_regs = (_num_regs),                                     \
+		.reg_bytes = (_reg_bytes),                                   \
+		.flags = (_flags),                                           \
+		.volatile_regs = (_volatile_regs),                           \
+		.vals = name##_vals,                                         \
+		.valid = name##_valid,                                       \
+		.dirty = name##_dirty,                                       \
+	}
+
+/**
+ * Start caching the registers of a peripheral. The cache starts empty.
+ * Attaching again moves the cache to another peripheral.
+ *
+ * @param cache The cache.
+ * @param port I2C port of the peripheral.
+ * @param addr_flags I2C address of the peripheral.
+ */
+void i2c_regcache_attach(struct i2c_regcache *cache, int port,
+			 uint16_t addr_flags);
+
+/**
+ * Stop caching the registers of a peripheral. Accesses go to the bus until
+ * the cache is attached again.
+ *
+ * @param cache The cache.
+ */
+void i2c_regcache_detach(struct i2c_regcache *cache);
+
+/**
+ * Forget the registers, after the peripheral was reset.
+ *
+ * @param cache The cache.
+ */
+void i2c_regcache_invalidate(struct i2c_regcache *cache);
+
+/**
+ * Write the dirty registers back, after the peripheral lost its state. The
+ * other registers are invalidated.
+ *
+ * @param cache The cache.
+ * @return EC_SUCCESS, or the error of the first failed write.
+ */
+int i2c_regcache_sync(struct i2c_regcache *cache);
+
+/**
+ * Serve a register read from the cache.
+ *
+ * @param port I2C port.
+ * @param addr_flags I2C address.
+ * @param reg The register.
+ * @param in Where to copy the value to.
+ * @param in_size Size of the read.
+ * @param seq Set on a miss, to pass to i2c_regcache_fill().
+ * @return true on a hit.
+ */
+bool i2c_regcache_read(int port, uint16_t addr_flags, uint8_t reg, uint8_t *in,
+		       int in_size, uint32_t *seq);
+
+/**
+ * Store a register read from the bus after a miss.
+ *
+ * @param port I2C port.
+ * @param addr_flags I2C address.
+ * @param reg The register.
+ * @param in The value read.
+ * @param in_size Size of the read.
+ * @param seq From i2c_regcache_read().
+ */
+void i2c_regcache_fill(int port, uint16_t addr_flags, uint8_t reg,
+		       const uint8_t *in, int in_size, uint32_t seq);
+
+/**
+ * Record a register write.
+ *
+ * @param port I2C port.
+ * @param addr_flags I2C address.
+ * @param out The register, then its value.
+ * @param out_size Size of out.
+ * @param rv Result of the write.
+ */
+void i2c_regcache_write(int port, uint16_t addr_flags, const uint8_t *out,
+			int out_size, int rv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CROS_EC_I2C_REGCACHE_H */
@@ -38,6 +38,19 @@ void kasa_reset(struct kasa_fit *kasa);
  */
 void kasa_accumulate(struct kasa_fit *kasa, fp_t x, fp_t y, fp_t z);
 
+/**
+ * Add a batch of raw samples to the kasa_fit structure.
+ *
+ * Same as calling kasa_accumulate() on each sample, but the sums are computed
+ * exactly in integer and folded in once, so on FPU builds the result may
+ * differ from the scalar path by float rounding.
+ *
+ * @param kasa Pointer to the struct to update.
+ * @param v The samples to add, in raw sensor counts.
+ * @param n The number of samples in v.
+ */
+void kasa_accumulate_batch(struct kasa_fit *kasa, const intv3_t *v, size_t n);
+
 /**
  * Compute the current center/radius from the kasa_fit structure.
  *
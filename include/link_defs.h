@@ -100,6 +100,14 @@ extern const struct deferred_data __deferred_funcs[];
 extern const struct deferred_data __deferred_funcs_end[];
 extern uint64_t __deferred_until[];
 extern uint64_t __deferred_until_end[];
+extern uint16_t __deferred_heap[];
+extern uint16_t __deferred_heap_end[];
+
+/* Hooks priority order and per-hook statistics (reserved by linker) */
+extern uint16_t __hooks_order[];
+extern uint16_t __hooks_order_end[];
+extern struct hook_stats __hooks_stats[];
+extern struct hook_stats __hooks_stats_end[];
 
 /* I2C fake devices for unit testing */
 extern const struct test_i2c_xfer __test_i2c_xfer[];
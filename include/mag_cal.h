@@ -20,6 +20,7 @@ extern "C" {
 #define MAG_CAL_MAX_SAMPLES 0xffff
 #define MAG_CAL_MIN_BATCH_WINDOW_US (2 * SECOND)
 #define MAG_CAL_MIN_BATCH_SIZE 50 /* samples */
+#define MAG_CAL_STAGE_SIZE 8 /* samples */
 
 struct mag_cal_t {
 	struct kasa_fit kasa_fit;
@@ -29,6 +30,10 @@ struct mag_cal_t {
 
 	/* number of samples needed to calibrate */
 	uint16_t batch_size;
+
+	/* samples waiting to be accumulated, see mag_cal_stage() */
+	uint8_t num_staged;
+	intv3_t staged[MAG_CAL_STAGE_SIZE];
 };
 
 void init_mag_cal(struct mag_cal_t *moc);
@@ -43,6 +48,34 @@ void init_mag_cal(struct mag_cal_t *moc);
  */
 int mag_cal_update(struct mag_cal_t *moc, const intv3_t v);
 
+/**
+ * Update the magnetometer calibration with a batch of samples, for instance
+ * a whole FIFO read, and possibly compute the new bias.
+ *
+ * Equivalent to calling mag_cal_update() on each sample: a calibration batch
+ * boundary may fall in the middle of v.
+ *
+ * @param moc Pointer to the magnetometer struct to update.
+ * @param v   The new data.
+ * @param n   The number of samples in v.
+ * @return    1 if a new calibration value is available, 0 otherwise.
+ */
+int mag_cal_update_batch(struct mag_cal_t *moc, const intv3_t *v, size_t n);
+
+/**
+ * Stage a sample read from the sensor, and update the calibration with
+ * mag_cal_update_batch() once MAG_CAL_STAGE_SIZE samples are staged.
+ *
+ * Drivers call it for each sample they read, so the calibration runs on
+ * batches of samples. A new bias applies at most MAG_CAL_STAGE_SIZE samples
+ * later than with mag_cal_update().
+ *
+ * @param moc Pointer to the magnetometer struct to update.
+ * @param v   The new data.
+ * @return    1 if a new calibration value is available, 0 otherwise.
+ */
+int mag_cal_stage(struct mag_cal_t *moc, const intv3_t v);
+
 #ifdef __cplusplus
 }
 #endif
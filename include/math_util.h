@@ -187,6 +187,17 @@ enum { X, Y, Z, W };
  */
 fp_t arc_cos(fp_t x);
 
+/**
+ * Find the angle of the vector (x, y) in degrees, counterclockwise from the
+ * x axis, like atan2(y, x). The result is within 0.02 degree.
+ *
+ * @param y
+ * @param x
+ *
+ * @return angle in degrees, in [0, 360), 0 for a null vector.
+ */
+fp_t arc_tan2(int y, int x);
+
 /**
  * Calculate the dot product of 2 vectors.
  */
@@ -38,6 +38,12 @@ enum ec_status host_cmd_motion_lid(struct host_cmd_handler_args *args);
 
 void motion_lid_calc(void);
 
+#ifdef TEST_BUILD
+/* Clockwise angle from base to lid around the hinge, in degrees. */
+fp_t hinge_angle_acos(const intv3_t base, const intv3_t lid);
+fp_t hinge_angle_atan(const intv3_t base, const intv3_t lid);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -59,11 +59,47 @@ int motion_sense_fifo_interrupt_needed(void);
  */
 int motion_sense_fifo_wake_up_needed(void);
 
+/**
+ * Count an MKBP event sent to the AP for the FIFO, see
+ * MOTIONSENSE_CMD_FIFO_COALESCE.
+ */
+void motion_sense_fifo_interrupt_sent(void);
+
 /**
  * Resets the flag for wake up and bypass needed.
  */
 void motion_sense_fifo_reset_needed_flags(void);
 
+/**
+ * Note that the motion task did not interrupt the AP this round, so that the
+ * interrupts held back by the coalescing policies are counted.
+ */
+void motion_sense_fifo_interrupt_deferred(void);
+
+/**
+ * Set the interrupt coalescing policy of a sensor.
+ *
+ * @param sensor_num The sensor to set the policy for.
+ * @param max_latency_us Longest time an event of the sensor may wait for an
+ *	interrupt, 0 to interrupt the AP every ec_rate of the sensor.
+ * @param max_events Most events of the sensor pending before an interrupt,
+ *	0 for no limit.
+ */
+void motion_sense_fifo_set_coalesce(int sensor_num, uint32_t max_latency_us,
+				    uint16_t max_events);
+
+/**
+ * Get the interrupt coalescing policy of a sensor and the interrupt
+ * statistics.
+ *
+ * @param sensor_num The sensor to get the policy of.
+ * @param out Policy and statistics.
+ * @param reset Whether or not to reset statistics after reading them.
+ */
+void motion_sense_fifo_get_coalesce(
+	int sensor_num, struct ec_response_motion_sense_fifo_coalesce *out,
+	int reset);
+
 /**
  * Insert an async event into the fifo.
  *
@@ -94,6 +130,58 @@ void motion_sense_fifo_stage_data(struct ec_response_motion_sensor_data *data,
 				  struct motion_sensor_t *sensor,
 				  int valid_data, uint32_t time);
 
+/** Number of samples a motion_sense_fifo_batch holds before staging them. */
+#define MOTION_SENSE_FIFO_BATCH_SIZE 16
+
+/**
+ * Samples decoded from a sensor hardware FIFO, staged together so the fifo
+ * lock is taken once per batch instead of once per sample.
+ *
+ * @time: accurate time (ideally measured in an interrupt) the hardware FIFO
+ *	was drained for, used for every sample in the batch.
+ * @count: number of samples in data[].
+ * @data: decoded samples, 3 axes each.
+ */
+struct motion_sense_fifo_batch {
+	uint32_t time;
+	int count;
+	struct ec_response_motion_sensor_data
+		data[MOTION_SENSE_FIFO_BATCH_SIZE];
+};
+
+/**
+ * Start a new batch of samples.
+ *
+ * @param batch batch to initialize
+ * @param time accurate time the samples were taken at
+ */
+static inline void
+motion_sense_fifo_batch_init(struct motion_sense_fifo_batch *batch,
+			     uint32_t time)
+{
+	batch->time = time;
+	batch->count = 0;
+}
+
+/**
+ * Add a 3-axis sample to a batch. The batch is staged when it fills up.
+ *
+ * @param batch batch to add the sample to
+ * @param sensor sensor the sample comes from
+ * @param v normalized X, Y and Z values
+ */
+void motion_sense_fifo_batch_add(struct motion_sense_fifo_batch *batch,
+				 struct motion_sensor_t *sensor, const int *v);
+
+/**
+ * Stage all the samples of a batch, as motion_sense_fifo_stage_data() would
+ * one by one. Like it, the data is not visible to the AP until
+ * motion_sense_fifo_commit_data() is called.
+ *
+ * @param batch batch to stage, empty on return
+ */
+void motion_sense_fifo_batch_flush(struct motion_sense_fifo_batch *batch);
+
 /**
  * Commit all the currently staged data to the fifo. Doing so makes it readable
  * to the AP.
@@ -130,6 +218,19 @@ int motion_sense_fifo_over_thres(void);
 int motion_sense_fifo_read(int capacity_bytes, int max_count, void *out,
 			   uint16_t *out_size);
 
+/**
+ * Read available committed entries from the fifo, delta encoded as described
+ * with struct ec_response_motion_sense_fifo_delta.
+ *
+ * @param capacity_bytes The number of bytes available to be written to `out`.
+ * @param max_count The maximum number of entries to encode in `out`.
+ * @param out The target to encode the data into.
+ * @param out_size The number of bytes written to `out`.
+ * @return The number of entries encoded in `out`.
+ */
+int motion_sense_fifo_read_delta(int capacity_bytes, int max_count,
+				 uint8_t *out, uint16_t *out_size);
+
 /**
  * Reset the internal data structures of the motion sense fifo.
  */
@@ -0,0 +1,41 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Decoder of the delta encoded motion sense FIFO, shared with ectool */
+
+#ifndef __CROS_EC_MOTION_SENSE_FIFO_DELTA_H
+#define __CROS_EC_MOTION_SENSE_FIFO_DELTA_H
+
+#include "ec_commands.h"
+
+#include <stdint.h>
+
+#ifndef HOST_TOOLS_BUILD
+#ifdef __cplusplus
+extern "C" {
+#endif
+#endif
+
+/**
+ * Decode the entries of a MOTIONSENSE_CMD_FIFO_READ_DELTA response, see
+ * struct ec_response_motion_sense_fifo_delta. The references start from
+ * zero, as every response is encoded on its own.
+ *
+ * @param in     Encoded entries, the data of the response
+ * @param size   Number of bytes in in
+ * @param count  Number of entries encoded in in
+ * @param out    Destination of the count decoded entries
+ * @return the number of bytes decoded, -1 if the entries are malformed.
+ */
+int motion_sense_fifo_delta_decode(const uint8_t *in, int size, int count,
+				   struct ec_response_motion_sensor_data *out);
+
+#ifndef HOST_TOOLS_BUILD
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#endif /* __CROS_EC_MOTION_SENSE_FIFO_DELTA_H */
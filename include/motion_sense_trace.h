@@ -0,0 +1,75 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Motion sensor read path trace */
+
+#ifndef __CROS_EC_MOTION_SENSE_TRACE_H
+#define __CROS_EC_MOTION_SENSE_TRACE_H
+
+#include "common.h"
+#include "ec_commands.h"
+#include "hwtimer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Record a point of the sensor read path. When the trace buffer is full, the
+ * oldest entry is dropped. Can be called from any context.
+ *
+ * @param sensor_num The sensor, or MOTIONSENSE_TRACE_NO_SENSOR.
+ * @param point The point reached, enum motionsense_trace_point.
+ * @param timestamp Time the point was reached at, in us.
+ */
+void motion_sense_trace_at(int sensor_num, enum motionsense_trace_point point,
+			   uint32_t timestamp);
+
+/**
+ * Remove the oldest entries of the trace.
+ *
+ * @param out Where to copy the entries to.
+ * @param max_count Most entries to copy.
+ * @param lost Entries dropped since the last read.
+ * @return The number of entries copied.
+ */
+int motion_sense_trace_read(struct ec_motion_sense_trace_entry *out,
+			    int max_count, uint16_t *lost);
+
+/** Drop all the entries of the trace. */
+void motion_sense_trace_reset(void);
+
+/**
+ * Record a point of the sensor read path, reached now.
+ *
+ * @param sensor_num The sensor, or MOTIONSENSE_TRACE_NO_SENSOR.
+ * @param point The point reached, enum motionsense_trace_point.
+ */
+static inline void motion_sense_trace(int sensor_num,
+				      enum motionsense_trace_point point)
+{
+	if (IS_ENABLED(CONFIG_ACCEL_TRACE))
+		motion_sense_trace_at(sensor_num, point,
+				      __hw_clock_source_read());
+}
+
+/**
+ * Record the interrupt of a sensor, from the bottom half of its driver.
+ *
+ * @param sensor_num The sensor that raised the interrupt.
+ * @param timestamp Time the top half took the interrupt at.
+ */
+static inline void motion_sense_trace_irq(int sensor_num, uint32_t timestamp)
+{
+	if (IS_ENABLED(CONFIG_ACCEL_TRACE))
+		motion_sense_trace_at(sensor_num, MOTIONSENSE_TRACE_IRQ,
+				      timestamp);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CROS_EC_MOTION_SENSE_TRACE_H */
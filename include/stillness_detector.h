@@ -0,0 +1,90 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Detect when a sensor is still, to calibrate it. */
+
+#ifndef __CROS_EC_STILLNESS_DETECTOR_H
+#define __CROS_EC_STILLNESS_DETECTOR_H
+
+#include "common.h"
+#include "math_util.h"
+#include "window_stats.h"
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct still_det {
+	/** Variance threshold, in squared sensor counts. */
+	uint32_t var_threshold;
+	/** Minimum window of a batch, in us. */
+	uint32_t min_batch_window;
+	/** Maximum window of a batch, in us. */
+	uint32_t max_batch_window;
+	/** Minimum number of samples in a batch. */
+	uint16_t min_batch_size;
+
+	/** Time of the first sample of the batch. */
+	uint32_t window_start_time;
+	/** Per axis statistics of the batch. */
+	struct window_stats stats[3];
+
+	/** Mean of the last still batch. */
+	intv3_t mean;
+};
+
+/**
+ * Initialize a stillness detector, the batches hold up to
+ * WINDOW_STATS_MAX_SIZE samples.
+ */
+#define STILL_DET(VAR_THRES, MIN_BATCH_WIN, MAX_BATCH_WIN, MIN_BATCH_SIZE) \
+	((struct still_det){                                               \
+		.var_threshold = VAR_THRES,                                \
+		.min_batch_window = MIN_BATCH_WIN,                         \
+		.max_batch_window = MAX_BATCH_WIN,                         \
+		.min_batch_size = MIN_BATCH_SIZE,                          \
+		.stats = {                                                 \
+			{ .size = WINDOW_STATS_MAX_SIZE },                 \
+			{ .size = WINDOW_STATS_MAX_SIZE },                 \
+			{ .size = WINDOW_STATS_MAX_SIZE },                 \
+		},                                                         \
+	})
+
+/**
+ * Update a stillness detector with a new sample.
+ *
+ * @param still_det Pointer to the stillness detector.
+ * @param sample_time Time of the sample, in us.
+ * @param v The sample, in sensor counts.
+ * @return true when a batch completed and the sensor was still, mean is then
+ *         the average of the batch.
+ */
+bool still_det_update(struct still_det *still_det, uint32_t sample_time,
+		      const intv3_t v);
+
+/**
+ * Update a stillness detector with a batch of samples, from a FIFO read.
+ *
+ * Same as calling still_det_update() on each sample, the samples are summed
+ * up in batches through intv3_moments_add_sq().
+ *
+ * @param still_det Pointer to the stillness detector.
+ * @param sample_times Time of each sample, in us.
+ * @param v The samples, in sensor counts.
+ * @param n The number of samples.
+ * @return true when a batch completed during the update and the sensor was
+ *         still, mean is then the average of the last such batch.
+ */
+bool still_det_update_batch(struct still_det *still_det,
+			    const uint32_t *sample_times, const intv3_t *v,
+			    size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CROS_EC_STILLNESS_DETECTOR_H */
@@ -9,6 +9,9 @@
 
 #include "math_util.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -84,6 +87,50 @@ fp_t fpv3_norm_squared(const fpv3_t v);
  */
 fp_t fpv3_norm(const fpv3_t v);
 
+/*
+ * Exact sums over a batch of integer vectors, for the statistics calibration
+ * and stillness detection compute on whole sensor FIFO batches.
+ *
+ * Vector components are raw sensor readings. Components that do not fit in an
+ * int16_t are summed exactly too, on a slower path.
+ */
+struct intv3_moments {
+	/* Sums of x, y and z. */
+	int64_t sum[3];
+	/* Sums of x * x, y * y and z * z. */
+	int64_t sum_sq[3];
+	/* Sums of x * y, x * z and y * z. */
+	int64_t sum_cross[3];
+	/* Sums of x * w, y * w and z * w, with w = x * x + y * y + z * z. */
+	int64_t sum_w[3];
+	uint32_t count;
+};
+
+/**
+ * Clear all the sums.
+ *
+ * @param m Pointer to the sums to clear.
+ */
+void intv3_moments_reset(struct intv3_moments *m);
+
+/**
+ * Add a batch of vectors to the sums and sums of squares only.
+ *
+ * @param m Pointer to the sums to update, sum_cross and sum_w are untouched.
+ * @param v The vectors to add.
+ * @param n The number of vectors in v.
+ */
+void intv3_moments_add_sq(struct intv3_moments *m, const intv3_t *v, size_t n);
+
+/**
+ * Add a batch of vectors to all the sums.
+ *
+ * @param m Pointer to the sums to update.
+ * @param v The vectors to add.
+ * @param n The number of vectors in v.
+ */
+void intv3_moments_add(struct intv3_moments *m, const intv3_t *v, size_t n);
+
 #ifdef __cplusplus
 }
 #endif
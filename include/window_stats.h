@@ -0,0 +1,104 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+/* Incremental mean and variance over a window of integer samples. */
+
+#ifndef __CROS_EC_WINDOW_STATS_H
+#define __CROS_EC_WINDOW_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Largest window, so that count^2 * variance of int16_t samples can not
+ * overflow the 64 bits accumulators.
+ */
+#define WINDOW_STATS_MAX_SIZE 16384
+
+/*
+ * Mean and variance updated in O(1) per sample, with Welford's update kept in
+ * exact integers: the mean is carried as sum = count * mean and the spread as
+ * n2_variance = count^2 * variance.
+ *
+ * With a history buffer the window slides over the last `size` samples once
+ * it is full. Without one, it grows until it is reset and samples past `size`
+ * are dropped.
+ */
+struct window_stats {
+	/* Ring of the samples in the window, NULL for a growing window. */
+	int32_t *history;
+	/* Window length. */
+	uint16_t size;
+	/* Samples in the window. */
+	uint16_t count;
+	/* Oldest sample in history, once the window is full. */
+	uint16_t head;
+	int64_t sum;
+	uint64_t n2_variance;
+};
+
+/**
+ * Set up a window and clear it.
+ *
+ * @param ws Window to set up.
+ * @param history Storage for size samples, or NULL for a growing window.
+ * @param size Window length, at most WINDOW_STATS_MAX_SIZE.
+ */
+void window_stats_init(struct window_stats *ws, int32_t *history,
+		       uint16_t size);
+
+/**
+ * Drop all the samples from the window.
+ */
+void window_stats_reset(struct window_stats *ws);
+
+/**
+ * Add a sample to the window, evicting the oldest one if the window is full.
+ *
+ * @param ws Window to update.
+ * @param x New sample, must fit in an int16_t.
+ */
+void window_stats_push(struct window_stats *ws, int32_t x);
+
+/**
+ * Add a batch of samples to a growing window, given their sums.
+ *
+ * Same as calling window_stats_push() on each sample. The window must have no
+ * history and room for all of them.
+ *
+ * @param ws Window to update.
+ * @param count Number of samples in the batch.
+ * @param sum Sum of the samples.
+ * @param sum_sq Sum of the squares of the samples.
+ */
+void window_stats_add_sums(struct window_stats *ws, uint16_t count,
+			   int64_t sum, uint64_t sum_sq);
+
+static inline bool window_stats_full(const struct window_stats *ws)
+{
+	return ws->count == ws->size;
+}
+
+/* Mean of the samples in the window, 0 if empty. */
+static inline int32_t window_stats_mean(const struct window_stats *ws)
+{
+	return ws->count ? ws->sum / ws->count : 0;
+}
+
+/* Variance of the samples in the window, 0 if empty. */
+static inline uint64_t window_stats_variance(const struct window_stats *ws)
+{
+	return ws->count ? ws->n2_variance / ws->count / ws->count : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CROS_EC_WINDOW_STATS_H */
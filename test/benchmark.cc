@@ -144,6 +144,115 @@ test_static int test_min_max_time()
 	return EC_SUCCESS;
 }
 
+test_static int test_warmup_iterations()
+{
+	Benchmark benchmark({ .num_iterations = 5, .num_warmup_iterations = 2 });
+	int num_calls = 0;
+
+	auto result = benchmark.run("call_counter", [&] { ++num_calls; });
+	TEST_ASSERT(result.has_value());
+	TEST_EQ(num_calls, 7, "%d");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_percentile_math()
+{
+	const uint32_t ten[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+	uint32_t hundred[100];
+	const uint32_t one[] = { 42 };
+
+	for (int i = 0; i < 100; i++)
+		hundred[i] = i + 1;
+
+	// Nearest rank: the smallest sample with at least p% of the samples
+	// at or below it.
+	TEST_EQ(Benchmark<>::percentile(ten, 10, 50), 5U, "%u");
+	TEST_EQ(Benchmark<>::percentile(ten, 10, 99), 10U, "%u");
+	TEST_EQ(Benchmark<>::percentile(ten, 10, 10), 1U, "%u");
+	TEST_EQ(Benchmark<>::percentile(ten, 10, 11), 2U, "%u");
+	TEST_EQ(Benchmark<>::percentile(hundred, 100, 50), 50U, "%u");
+	TEST_EQ(Benchmark<>::percentile(hundred, 100, 99), 99U, "%u");
+	TEST_EQ(Benchmark<>::percentile(hundred, 100, 100), 100U, "%u");
+	TEST_EQ(Benchmark<>::percentile(one, 1, 50), 42U, "%u");
+	TEST_EQ(Benchmark<>::percentile(one, 1, 99), 42U, "%u");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_percentiles()
+{
+	// Ten iterations of 1ms, except for a single 4ms outlier
+	Benchmark<1, 10> benchmark({ .num_iterations = 10 });
+	int iteration = 0;
+
+	auto result = benchmark.run("delay", [&iteration] {
+		udelay(iteration++ == 3 ? 4000 : 1000);
+	});
+	TEST_ASSERT(result.has_value());
+
+	// The percentiles come from the same clock as the minimum and the
+	// maximum, and p99 of ten samples is the largest one.
+	TEST_EQ(result->num_samples, 10U, "%u");
+	TEST_LE(result->min_time, result->median_time, "%u");
+	TEST_LE(result->median_time, result->p99_time, "%u");
+	TEST_EQ(result->p99_time, result->max_time, "%u");
+	if (result->cycle_frequency) {
+		TEST_LE(result->min_cycles, result->median_cycles, "%u");
+		TEST_EQ(result->p99_cycles, result->max_cycles, "%u");
+	}
+
+	// Delays only get longer, by interrupts, so the bounds are loose.
+	TEST_GE(result->median_time, 900U, "%u");
+	TEST_LE(result->median_time, 2000U, "%u");
+	TEST_GE(result->p99_time, 3600U, "%u");
+
+	benchmark.print_results();
+	return EC_SUCCESS;
+}
+
+test_static int test_no_samples()
+{
+	Benchmark benchmark({ .num_iterations = 3 });
+
+	auto result = benchmark.run("call", [] {});
+	TEST_ASSERT(result.has_value());
+	TEST_EQ(result->num_samples, 0U, "%u");
+	TEST_EQ(result->median_time, 0U, "%u");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_cycle_counter()
+{
+	Benchmark benchmark({ .num_iterations = 3 });
+
+	auto result = benchmark.run("delay", [] { udelay(1000); });
+	TEST_ASSERT(result.has_value());
+
+	if (!result->cycle_frequency) {
+		ccprintf("No cycle counter, skipping\n");
+		return EC_SUCCESS;
+	}
+	TEST_LE(result->min_cycles, result->average_cycles, "%u");
+	TEST_LE(result->average_cycles, result->max_cycles, "%u");
+
+	// A hundred times longer delay must take more cycles
+	auto short_max_cycles = result->max_cycles;
+	result = benchmark.run("long_delay", [] { udelay(100000); });
+	TEST_ASSERT(result.has_value());
+	TEST_GT(result->min_cycles, short_max_cycles, "%u");
+
+	Benchmark no_cycles({ .num_iterations = 3,
+			      .use_cycle_counter = false });
+	result = no_cycles.run("delay", [] { udelay(1000); });
+	TEST_ASSERT(result.has_value());
+	TEST_EQ(result->cycle_frequency, 0U, "%u");
+	TEST_EQ(result->average_cycles, 0U, "%u");
+
+	return EC_SUCCESS;
+}
+
 void run_test(int argc, const char **argv)
 {
 	test_reset();
@@ -155,5 +264,10 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_too_many_runs);
 	RUN_TEST(test_empty_benchmark_name);
 	RUN_TEST(test_min_max_time);
+	RUN_TEST(test_warmup_iterations);
+	RUN_TEST(test_percentile_math);
+	RUN_TEST(test_percentiles);
+	RUN_TEST(test_no_samples);
+	RUN_TEST(test_cycle_counter);
 	test_print_result();
 }
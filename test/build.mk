@@ -36,13 +36,17 @@ test-list-host += charge_ramp
 test-list-host += chipset
 test-list-host += compile_time_macros
 test-list-host += console_edit
+test-list-host += core_kernels_benchmark
 test-list-host += crc
+test-list-host += crc_slice4
+test-list-host += crc_slice8
 test-list-host += debug_unimplemented
 test-list-host += entropy
 test-list-host += fan
 test-list-host += flash
 test-list-host += float
 test-list-host += fp
+test-list-host += fp_dsp
 test-list-host += fp_transport
 test-list-host += fpsensor_auth_commands
 test-list-host += fpsensor_auth_commands_otp
@@ -56,7 +60,9 @@ test-list-host += fpsensor_state
 test-list-host += fpsensor_utils
 test-list-host += gettimeofday
 test-list-host += hooks
+test-list-host += hooks_tickless
 test-list-host += host_command
+test-list-host += host_command_benchmark
 test-list-host += hyperdebug
 test-list-host += i2c_bitbang
 test-list-host += inductive_charging
@@ -82,6 +88,7 @@ test-list-host += math_util
 test-list-host += motion_angle
 test-list-host += motion_angle_tablet
 test-list-host += motion_lid
+test-list-host += motion_lid_atan
 test-list-host += motion_sense_fifo
 test-list-host += mutex
 test-list-host += mutex_recursive
@@ -100,6 +107,8 @@ test-list-host += rtc
 test-list-host += sbrk
 test-list-host += sbs_charging
 test-list-host += scoped_fast_cpu
+test-list-host += sensor_math_benchmark
+test-list-host += sensor_replay
 test-list-host += sha256
 test-list-host += sha256_unrolled
 test-list-host += shmalloc
@@ -145,6 +154,7 @@ test-list-host += utils
 test-list-host += utils_str
 test-list-host += vboot
 test-list-host += version
+test-list-host += window_stats
 test-list-host += x25519
 -include ../ec-private/test/build.mk
 endif
@@ -201,8 +211,11 @@ charge_ramp-y+=charge_ramp.o
 chipset-y+=chipset.o
 compile_time_macros-y=compile_time_macros.o
 console_edit-y=console_edit.o
+core_kernels_benchmark-y=core_kernels_benchmark.o
 cortexm_fpu-y=cortexm_fpu.o
 crc-y=crc.o
+crc_slice4-y=crc.o
+crc_slice8-y=crc.o
 debug-y=debug.o
 debug_unimplemented-y=debug_unimplemented.o
 entropy-y=entropy.o
@@ -228,7 +241,9 @@ ftrapv-y=ftrapv.o
 gettimeofday-y=gettimeofday.o
 global_initialization-y=global_initialization.o
 hooks-y=hooks.o
+hooks_tickless-y=hooks_tickless.o
 host_command-y=host_command.o
+host_command_benchmark-y=host_command_benchmark.o
 hyperdebug-y=hyperdebug.o
 i2c_bitbang-y=i2c_bitbang.o
 inductive_charging-y=inductive_charging.o
@@ -247,6 +262,7 @@ math_util-y=math_util.o
 motion_angle-y=motion_angle.o motion_angle_data_literals.o motion_common.o
 motion_angle_tablet-y=motion_angle_tablet.o motion_angle_data_literals_tablet.o motion_common.o
 motion_lid-y=motion_lid.o
+motion_lid_atan-y=motion_lid.o
 motion_sense_fifo-y=motion_sense_fifo.o
 null_pointer-y=null_pointer.o
 nvidia_gpu-y=nvidia_gpu.o
@@ -283,6 +299,9 @@ scratchpad-y=scratchpad.o
 sbrk-y=sbrk.o
 sbs_charging-y=sbs_charging.o
 scoped_fast_cpu-y=scoped_fast_cpu.o
+sensor_math_benchmark-y=sensor_math_benchmark.o
+sensor_replay-y=sensor_replay.o sensor_replay_engine.o \
+	body_detection_data_literals.o motion_angle_data_literals_tablet.o
 sha256-y=sha256.o
 sha256_unrolled-y=sha256.o
 shmalloc-y=shmalloc.o
@@ -348,8 +367,10 @@ utils_str-y=utils_str.o
 vboot-y=vboot.o
 version-y += version.o
 watchdog-y=watchdog.o
+window_stats-y=window_stats.o
 float-y=fp.o
 fp-y=fp.o
+fp_dsp-y=fp.o
 x25519-y=x25519.o
 
 host-is_enabled_error: TEST_SCRIPT=is_enabled_error.sh
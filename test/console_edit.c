@@ -8,6 +8,7 @@
 #include "common.h"
 #include "console.h"
 #include "ec_commands.h"
+#include "link_defs.h"
 #include "test_util.h"
 #include "timer.h"
 #include "uart.h"
@@ -30,6 +31,12 @@ static int command_test_2(int argc, const char **argv)
 }
 DECLARE_CONSOLE_COMMAND(test2, command_test_2, NULL, NULL);
 
+static int command_test_2_long(int argc, const char **argv)
+{
+	return EC_SUCCESS;
+}
+DECLARE_CONSOLE_COMMAND(test2long, command_test_2_long, NULL, NULL);
+
 /*****************************************************************************/
 /* Test utilities */
 
@@ -333,6 +340,62 @@ static int test_cprints_overflow(void)
 	return EC_SUCCESS;
 }
 
+static int test_command_table_sorted(void)
+{
+	const struct console_command *cmd;
+
+	for (cmd = __cmds + 1; cmd < __cmds_end; cmd++)
+		TEST_LT(strcasecmp(cmd[-1].name, cmd->name), 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_find_command(void)
+{
+	/* Exact matches, in any case. */
+	TEST_ASSERT(find_command("test1")->handler == command_test_1);
+	TEST_ASSERT(find_command("TEST1")->handler == command_test_1);
+
+	/* An exact match wins over a longer command it prefixes. */
+	TEST_ASSERT(find_command("test2")->handler == command_test_2);
+
+	/* A unique prefix matches. */
+	TEST_ASSERT(find_command("test2l")->handler == command_test_2_long);
+
+	/* Ambiguous prefixes and unknown names don't. */
+	TEST_ASSERT(find_command("test") == NULL);
+	TEST_ASSERT(find_command("") == NULL);
+	TEST_ASSERT(find_command("test3") == NULL);
+	TEST_ASSERT(find_command("zzzzzzzz") == NULL);
+
+	/* Every registered command can be found by its own name. */
+	for (const struct console_command *cmd = __cmds; cmd < __cmds_end;
+	     cmd++)
+		TEST_ASSERT(find_command(cmd->name) == cmd);
+
+	return EC_SUCCESS;
+}
+
+static int test_help_command(void)
+{
+	const struct console_command *help = find_command("help");
+	const char *argv[] = { "help", NULL };
+
+	TEST_ASSERT(help != NULL);
+
+	/* "help <cmd>" finds the command like running it does. */
+	argv[1] = "test1";
+	TEST_EQ(help->handler(2, argv), EC_SUCCESS, "%d");
+	argv[1] = "test2l";
+	TEST_EQ(help->handler(2, argv), EC_SUCCESS, "%d");
+	argv[1] = "test";
+	TEST_EQ(help->handler(2, argv), EC_ERROR_UNKNOWN, "%d");
+	argv[1] = "zzzzzzzz";
+	TEST_EQ(help->handler(2, argv), EC_ERROR_UNKNOWN, "%d");
+
+	return EC_SUCCESS;
+}
+
 void run_test(int argc, const char **argv)
 {
 	test_reset();
@@ -352,6 +415,9 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_output_channel);
 	RUN_TEST(test_buf_notify_null);
 	RUN_TEST(test_cprints_overflow);
+	RUN_TEST(test_command_table_sorted);
+	RUN_TEST(test_find_command);
+	RUN_TEST(test_help_command);
 
 	test_print_result();
 }
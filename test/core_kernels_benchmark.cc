@@ -0,0 +1,311 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Micro-benchmarks of the hot kernels shared by every image, so regressions
+ * show up on the host build before they reach firmware.
+ */
+
+#include "benchmark.h"
+#include "common.h"
+#include "crc.h"
+#include "crc8.h"
+#include "curve25519.h"
+#include "printf.h"
+#include "queue.h"
+#include "rsa.h"
+#include "sha256.h"
+#include "shared_mem.h"
+#include "test_util.h"
+
+#include "rsa2048-F4.h"
+
+#include <array>
+#include <cstring>
+
+/* Iterations are short, keep enough samples for a meaningful p99. */
+using KernelBenchmark = Benchmark<1, 100>;
+
+static constexpr BenchmarkOptions options = {
+	.num_iterations = 100,
+	.num_warmup_iterations = 5,
+};
+
+alignas(uint32_t) static std::array<uint8_t, 1024> buffer;
+
+static void init_buffer()
+{
+	for (size_t i = 0; i < buffer.size(); i++)
+		buffer[i] = i * 7 + 3;
+}
+
+test_static int test_crc32()
+{
+	KernelBenchmark benchmark(options);
+	volatile uint32_t sink;
+	const uint8_t check[] = "123456789";
+
+	crc32_init();
+	crc32_hash(check, sizeof(check) - 1);
+	TEST_EQ(crc32_result(), 0xcbf43926U, "0x%08x");
+
+	auto result = benchmark.run("crc32_hash32", [&sink] {
+		crc32_init();
+		for (size_t i = 0; i < buffer.size(); i += 4)
+			crc32_hash32(*reinterpret_cast<uint32_t *>(&buffer[i]));
+		sink = crc32_result();
+	});
+	TEST_ASSERT(result.has_value());
+
+	benchmark.print_results();
+	return EC_SUCCESS;
+}
+
+test_static int test_crc32_buffer()
+{
+	Benchmark<2, 100> benchmark(options);
+	volatile uint32_t sink;
+	uint32_t crc;
+	uint32_t bytewise;
+
+	/* One byte per lookup, same as the compact table. */
+	auto baseline = benchmark.run("crc32_ctx_hash8", [&] {
+		crc32_ctx_init(&crc);
+		for (uint8_t b : buffer)
+			crc32_ctx_hash8(&crc, b);
+		sink = crc32_ctx_result(&crc);
+	});
+	TEST_ASSERT(baseline.has_value());
+	bytewise = sink;
+
+	/* Uses the CONFIG_SW_CRC_SLICES kernel. */
+	auto sliced = benchmark.run("crc32_ctx_hash", [&] {
+		crc32_ctx_init(&crc);
+		crc32_ctx_hash(&crc, buffer.data(), buffer.size());
+		sink = crc32_ctx_result(&crc);
+	});
+	TEST_ASSERT(sliced.has_value());
+	TEST_EQ(sink, bytewise, "0x%08x");
+
+	benchmark.print_results();
+	BenchmarkResult::compare(baseline.value(), sliced.value());
+	return EC_SUCCESS;
+}
+
+test_static int test_crc8()
+{
+	KernelBenchmark benchmark(options);
+	volatile uint8_t sink;
+	const uint8_t check[] = "123456789";
+
+	TEST_EQ(cros_crc8(check, sizeof(check) - 1), 0xf4, "0x%02x");
+
+	auto result = benchmark.run("cros_crc8", [&sink] {
+		sink = cros_crc8(buffer.data(), buffer.size());
+	});
+	TEST_ASSERT(result.has_value());
+
+	benchmark.print_results();
+	return EC_SUCCESS;
+}
+
+test_static int test_sha256()
+{
+	KernelBenchmark benchmark(options);
+	struct sha256_ctx ctx;
+	uint8_t *digest;
+	const uint8_t abc[] = "abc";
+	const uint8_t abc_digest[SHA256_DIGEST_SIZE] = {
+		0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+		0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+		0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+		0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad,
+	};
+
+	SHA256_init(&ctx);
+	SHA256_update(&ctx, abc, sizeof(abc) - 1);
+	digest = SHA256_final(&ctx);
+	TEST_ASSERT_ARRAY_EQ(digest, abc_digest, SHA256_DIGEST_SIZE);
+
+	auto result = benchmark.run("SHA256_update", [&ctx] {
+		SHA256_init(&ctx);
+		SHA256_update(&ctx, buffer.data(), buffer.size());
+		SHA256_final(&ctx);
+	});
+	TEST_ASSERT(result.has_value());
+
+	benchmark.print_results();
+	return EC_SUCCESS;
+}
+
+test_static int test_rsa_verify()
+{
+	/* A verification is expensive, fewer iterations are plenty. */
+	Benchmark<1, 10> benchmark({ .num_iterations = 10,
+				     .num_warmup_iterations = 1 });
+	static uint32_t rsa_workbuf[3 * RSANUMBYTES / 4];
+	int good = 0;
+
+	auto result = benchmark.run("rsa_verify", [&good] {
+		good = rsa_verify(rsa_key, sig, hash, rsa_workbuf);
+	});
+	TEST_ASSERT(result.has_value());
+	TEST_ASSERT(good);
+
+	benchmark.print_results();
+	return EC_SUCCESS;
+}
+
+test_static int test_x25519()
+{
+	/* Taken from https://tools.ietf.org/html/rfc7748#section-5.2 */
+	static const uint8_t scalar[32] = {
+		0xa5, 0x46, 0xe3, 0x6b, 0xf0, 0x52, 0x7c, 0x9d,
+		0x3b, 0x16, 0x15, 0x4b, 0x82, 0x46, 0x5e, 0xdd,
+		0x62, 0x14, 0x4c, 0x0a, 0xc1, 0xfc, 0x5a, 0x18,
+		0x50, 0x6a, 0x22, 0x44, 0xba, 0x44, 0x9a, 0xc4,
+	};
+	static const uint8_t point[32] = {
+		0xe6, 0xdb, 0x68, 0x67, 0x58, 0x30, 0x30, 0xdb,
+		0x35, 0x94, 0xc1, 0xa4, 0x24, 0xb1, 0x5f, 0x7c,
+		0x72, 0x66, 0x24, 0xec, 0x26, 0xb3, 0x35, 0x3b,
+		0x10, 0xa9, 0x03, 0xa6, 0xd0, 0xab, 0x1c, 0x4c,
+	};
+	static const uint8_t expected[32] = {
+		0xc3, 0xda, 0x55, 0x37, 0x9d, 0xe9, 0xc6, 0x90,
+		0x8e, 0x94, 0xea, 0x4d, 0xf2, 0x8d, 0x08, 0x4f,
+		0x32, 0xec, 0xcf, 0x03, 0x49, 0x1c, 0x71, 0xf7,
+		0x54, 0xb4, 0x07, 0x55, 0x77, 0xa2, 0x85, 0x52,
+	};
+	Benchmark<1, 10> benchmark({ .num_iterations = 10,
+				     .num_warmup_iterations = 1 });
+	uint8_t out[32];
+
+	auto result = benchmark.run("x25519",
+				    [&out] { X25519(out, scalar, point); });
+	TEST_ASSERT(result.has_value());
+	TEST_ASSERT_ARRAY_EQ(out, expected, sizeof(out));
+
+	benchmark.print_results();
+	return EC_SUCCESS;
+}
+
+test_static int test_queue()
+{
+	static struct queue_state state;
+	static std::array<uint8_t, 256> queue_buffer;
+	static struct queue const queue = {
+		.state = &state,
+		.policy = &queue_policy_null,
+		.buffer_units = queue_buffer.size(),
+		.buffer_units_mask = queue_buffer.size() - 1,
+		.unit_bytes = sizeof(uint8_t),
+		.buffer = queue_buffer.data(),
+	};
+	KernelBenchmark benchmark(options);
+	std::array<uint8_t, 48> out;
+	size_t moved = 0;
+
+	queue_init(&queue);
+
+	/* Odd-sized chunks, so that the copies wrap around the buffer. */
+	auto result = benchmark.run("queue_add_remove_units", [&] {
+		for (size_t i = 0; i < buffer.size(); i += out.size()) {
+			moved += queue_add_units(&queue, &buffer[i],
+						 MIN(out.size(),
+						     buffer.size() - i));
+			moved -= queue_remove_units(&queue, out.data(),
+						    out.size());
+		}
+	});
+	TEST_ASSERT(result.has_value());
+	TEST_EQ(moved, (size_t)0, "%zu");
+
+	benchmark.print_results();
+	return EC_SUCCESS;
+}
+
+static int count_char(void *context, int c)
+{
+	++*static_cast<int *>(context);
+	return 0;
+}
+
+static int format(int *count, const char *fmt, ...)
+{
+	va_list args;
+	int rv;
+
+	va_start(args, fmt);
+	rv = vfnprintf(count_char, count, fmt, args);
+	va_end(args);
+
+	return rv;
+}
+
+test_static int test_vfnprintf()
+{
+	KernelBenchmark benchmark(options);
+	auto format_all = [](int *count) {
+		format(count, "%s %d %u 0x%08x %-8s %lld %c", "string", -12345,
+		       67890U, 0xdeadbeefU, "pad", -1234567890123LL, 'x');
+	};
+	int expected = 0;
+	int count = 0;
+
+	format_all(&expected);
+	auto result = benchmark.run("vfnprintf",
+				    [&] { format_all(&count); });
+	TEST_ASSERT(result.has_value());
+	TEST_EQ(count,
+		expected * (options.num_iterations +
+			    options.num_warmup_iterations),
+		"%d");
+
+	benchmark.print_results();
+	return EC_SUCCESS;
+}
+
+test_static int test_shared_mem()
+{
+	KernelBenchmark benchmark(options);
+	int rv = EC_SUCCESS;
+	char *mem;
+
+	/* The buffer is usable, and all of it is available again after. */
+	TEST_EQ(shared_mem_acquire(512, &mem), EC_SUCCESS, "%d");
+	memset(mem, 0x5a, 512);
+	TEST_EQ(mem[0], 0x5a, "%d");
+	TEST_EQ(mem[511], 0x5a, "%d");
+	shared_mem_release(mem);
+
+	auto result = benchmark.run("shared_mem_acquire", [&rv, &mem] {
+		if (shared_mem_acquire(512, &mem) == EC_SUCCESS)
+			shared_mem_release(mem);
+		else
+			rv = EC_ERROR_UNKNOWN;
+	});
+	TEST_ASSERT(result.has_value());
+	TEST_EQ(rv, EC_SUCCESS, "%d");
+	TEST_EQ(shared_mem_acquire(shared_mem_size(), &mem), EC_SUCCESS, "%d");
+	shared_mem_release(mem);
+
+	benchmark.print_results();
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+	init_buffer();
+	RUN_TEST(test_crc32);
+	RUN_TEST(test_crc32_buffer);
+	RUN_TEST(test_crc8);
+	RUN_TEST(test_sha256);
+	RUN_TEST(test_rsa_verify);
+	RUN_TEST(test_x25519);
+	RUN_TEST(test_queue);
+	RUN_TEST(test_vfnprintf);
+	RUN_TEST(test_shared_mem);
+	test_print_result();
+}
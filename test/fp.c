@@ -15,7 +15,7 @@
 #include "test_util.h"
 #include "vec3.h"
 
-#if defined(TEST_FP) && !defined(CONFIG_FPU)
+#if (defined(TEST_FP) || defined(TEST_FP_DSP)) && !defined(CONFIG_FPU)
 #define NORM_TOLERANCE FLOAT_TO_FP(0.01f)
 #define NORM_SQUARED_TOLERANCE FLOAT_TO_FP(0.0f)
 #define DOT_TOLERANCE FLOAT_TO_FP(0.001f)
@@ -313,6 +313,65 @@ static int test_mat44_fp_solve(void)
 	return EC_SUCCESS;
 }
 
+test_static int test_intv3_moments(void)
+{
+	/*
+	 * Odd count to cover the tail of the paired kernels. The last rows
+	 * do not fit in an int16_t, like the bmm150 overflow code and scaled
+	 * lis2mdl readings.
+	 */
+	static const intv3_t v[] = {
+		{ -32768, 32767, 0 },	 { 32767, -32768, -1 },
+		{ 1, -1, 32767 },	 { -523, 12, 7 },
+		{ 4000, -4000, 16000 },	 { -1, -1, -1 },
+		{ 32767, 32767, 32767 }, { 32768, -5, 3 },
+		{ 520, 12, -7 },	 { -78643, 78643, -32769 },
+		{ 78643, 1, 2 },
+	};
+	struct intv3_moments m, sq, split;
+	int64_t w;
+	int i, axis;
+
+	intv3_moments_reset(&m);
+	intv3_moments_add(&m, v, ARRAY_SIZE(v));
+	intv3_moments_reset(&sq);
+	intv3_moments_add_sq(&sq, v, ARRAY_SIZE(v));
+	intv3_moments_reset(&split);
+	intv3_moments_add(&split, v, 3);
+	intv3_moments_add(&split, v + 3, ARRAY_SIZE(v) - 3);
+
+	/* Subtract the naive scalar sums, everything must cancel out. */
+	for (i = 0; i < ARRAY_SIZE(v); i++) {
+		w = 0;
+		for (axis = X; axis <= Z; axis++) {
+			m.sum[axis] -= v[i][axis];
+			m.sum_sq[axis] -= (int64_t)v[i][axis] * v[i][axis];
+			w += (int64_t)v[i][axis] * v[i][axis];
+		}
+		m.sum_cross[0] -= (int64_t)v[i][X] * v[i][Y];
+		m.sum_cross[1] -= (int64_t)v[i][X] * v[i][Z];
+		m.sum_cross[2] -= (int64_t)v[i][Y] * v[i][Z];
+		for (axis = X; axis <= Z; axis++)
+			m.sum_w[axis] -= v[i][axis] * w;
+	}
+	TEST_EQ(m.count, (uint32_t)ARRAY_SIZE(v), "%u");
+	for (axis = X; axis <= Z; axis++) {
+		TEST_ASSERT(m.sum[axis] == 0);
+		TEST_ASSERT(m.sum_sq[axis] == 0);
+		TEST_ASSERT(m.sum_cross[axis] == 0);
+		TEST_ASSERT(m.sum_w[axis] == 0);
+
+		/* The cheaper kernel agrees on what it computes. */
+		TEST_ASSERT(sq.sum[axis] == split.sum[axis]);
+		TEST_ASSERT(sq.sum_sq[axis] == split.sum_sq[axis]);
+		TEST_ASSERT(sq.sum_cross[axis] == 0);
+		TEST_ASSERT(sq.sum_w[axis] == 0);
+	}
+	TEST_EQ(sq.count, split.count, "%u");
+
+	return EC_SUCCESS;
+}
+
 test_static int test_isnan(void)
 {
 	float zero = 0.0f;
@@ -382,6 +441,7 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_mat33_fp_get_eigenbasis);
 	RUN_TEST(test_mat44_fp_decompose_lup);
 	RUN_TEST(test_mat44_fp_solve);
+	RUN_TEST(test_intv3_moments);
 	RUN_TEST(test_isnan);
 	RUN_TEST(test_isinf);
 
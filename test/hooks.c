@@ -52,6 +52,42 @@ static void tick2_hook(void)
 /* tick2_hook() prio means it should be called after tick_hook() */
 DECLARE_HOOK(HOOK_TICK, tick2_hook, HOOK_PRIO_DEFAULT + 1);
 
+static int pwrbtn_prio_seen[4];
+static int pwrbtn_call_count;
+
+static void record_pwrbtn_prio(int prio)
+{
+	if (pwrbtn_call_count < ARRAY_SIZE(pwrbtn_prio_seen))
+		pwrbtn_prio_seen[pwrbtn_call_count] = prio;
+	pwrbtn_call_count++;
+}
+
+/* Declared out of priority order on purpose */
+static void pwrbtn_last_hook(void)
+{
+	record_pwrbtn_prio(HOOK_PRIO_LAST);
+}
+DECLARE_HOOK(HOOK_POWER_BUTTON_CHANGE, pwrbtn_last_hook, HOOK_PRIO_LAST);
+
+static void pwrbtn_default_hook(void)
+{
+	record_pwrbtn_prio(HOOK_PRIO_DEFAULT);
+}
+DECLARE_HOOK(HOOK_POWER_BUTTON_CHANGE, pwrbtn_default_hook, HOOK_PRIO_DEFAULT);
+
+static void pwrbtn_first_hook(void)
+{
+	record_pwrbtn_prio(HOOK_PRIO_FIRST);
+}
+DECLARE_HOOK(HOOK_POWER_BUTTON_CHANGE, pwrbtn_first_hook, HOOK_PRIO_FIRST);
+
+static void pwrbtn_post_first_hook(void)
+{
+	record_pwrbtn_prio(HOOK_PRIO_POST_FIRST);
+}
+DECLARE_HOOK(HOOK_POWER_BUTTON_CHANGE, pwrbtn_post_first_hook,
+	     HOOK_PRIO_POST_FIRST);
+
 static void second_hook(void)
 {
 	second_hook_count++;
@@ -118,6 +154,20 @@ static int test_priority(void)
 	return EC_SUCCESS;
 }
 
+static int test_priority_order(void)
+{
+	pwrbtn_call_count = 0;
+	hook_notify(HOOK_POWER_BUTTON_CHANGE);
+
+	TEST_EQ(pwrbtn_call_count, 4, "%d");
+	TEST_EQ(pwrbtn_prio_seen[0], HOOK_PRIO_FIRST, "%d");
+	TEST_EQ(pwrbtn_prio_seen[1], HOOK_PRIO_POST_FIRST, "%d");
+	TEST_EQ(pwrbtn_prio_seen[2], HOOK_PRIO_DEFAULT, "%d");
+	TEST_EQ(pwrbtn_prio_seen[3], HOOK_PRIO_LAST, "%d");
+
+	return EC_SUCCESS;
+}
+
 static int test_deferred(void)
 {
 	deferred_call_count = 0;
@@ -147,6 +197,59 @@ static int test_deferred(void)
 	return EC_SUCCESS;
 }
 
+static char deferred_order[5];
+static int deferred_order_count;
+
+static void record_deferred_order(char name)
+{
+	if (deferred_order_count < ARRAY_SIZE(deferred_order) - 1)
+		deferred_order[deferred_order_count++] = name;
+}
+
+static void deferred_a(void)
+{
+	record_deferred_order('a');
+}
+DECLARE_DEFERRED(deferred_a);
+
+static void deferred_b(void)
+{
+	record_deferred_order('b');
+}
+DECLARE_DEFERRED(deferred_b);
+
+static void deferred_c(void)
+{
+	record_deferred_order('c');
+}
+DECLARE_DEFERRED(deferred_c);
+
+static void deferred_d(void)
+{
+	record_deferred_order('d');
+}
+DECLARE_DEFERRED(deferred_d);
+
+static int test_deferred_order(void)
+{
+	memset(deferred_order, 0, sizeof(deferred_order));
+	deferred_order_count = 0;
+
+	hook_call_deferred(&deferred_a_data, 40 * MSEC);
+	hook_call_deferred(&deferred_b_data, 10 * MSEC);
+	hook_call_deferred(&deferred_c_data, 30 * MSEC);
+	hook_call_deferred(&deferred_d_data, 20 * MSEC);
+
+	/* Cancel one and move another one ahead of everything */
+	hook_call_deferred(&deferred_c_data, -1);
+	hook_call_deferred(&deferred_a_data, 5 * MSEC);
+
+	crec_usleep(100 * MSEC);
+	TEST_ASSERT_ARRAY_EQ(deferred_order, "abd", 4);
+
+	return EC_SUCCESS;
+}
+
 static int repeating_deferred_count;
 static void deferred_repeating_func(void);
 DECLARE_DEFERRED(deferred_repeating_func);
@@ -180,7 +283,9 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_init_early_hook);
 	RUN_TEST(test_ticks);
 	RUN_TEST(test_priority);
+	RUN_TEST(test_priority_order);
 	RUN_TEST(test_deferred);
+	RUN_TEST(test_deferred_order);
 	RUN_TEST(test_repeating_deferred);
 
 	test_print_result();
@@ -0,0 +1,109 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test the hook task in CONFIG_HOOK_TICKLESS mode.
+ */
+
+#include "common.h"
+#include "console.h"
+#include "hooks.h"
+#include "test_util.h"
+#include "timer.h"
+#include "util.h"
+
+#define TICK_JITTER_MS 100
+#define SECOND_JITTER_MS 500
+
+/* Slack for the time the hook task itself takes to run */
+#define SLACK (1 * MSEC)
+
+static int tick_hook_count;
+static timestamp_t tick_time[2];
+static int second_hook_count;
+static timestamp_t second_time[2];
+static timestamp_t deferred_time;
+
+static void tick_hook(void)
+{
+	tick_hook_count++;
+	tick_time[0] = tick_time[1];
+	tick_time[1] = get_time();
+}
+DECLARE_HOOK_WITH_JITTER(HOOK_TICK, tick_hook, HOOK_PRIO_DEFAULT,
+			 TICK_JITTER_MS);
+
+static void second_hook(void)
+{
+	second_hook_count++;
+	second_time[0] = second_time[1];
+	second_time[1] = get_time();
+}
+DECLARE_HOOK_WITH_JITTER(HOOK_SECOND, second_hook, HOOK_PRIO_DEFAULT,
+			 SECOND_JITTER_MS);
+
+static void deferred_func(void)
+{
+	deferred_time = get_time();
+}
+DECLARE_DEFERRED(deferred_func);
+
+static int test_ticks_within_jitter(void)
+{
+	uint64_t interval;
+
+	crec_usleep(3 * SECOND);
+	TEST_ASSERT(tick_hook_count >= 2);
+	TEST_ASSERT(second_hook_count >= 2);
+
+	interval = tick_time[1].val - tick_time[0].val;
+	TEST_GE(interval, (uint64_t)HOOK_TICK_INTERVAL, "%" PRIu64);
+	TEST_LE(interval,
+		(uint64_t)(HOOK_TICK_INTERVAL + TICK_JITTER_MS * MSEC + SLACK),
+		"%" PRIu64);
+
+	interval = second_time[1].val - second_time[0].val;
+	TEST_GE(interval, (uint64_t)SECOND, "%" PRIu64);
+	TEST_LE(interval, (uint64_t)(SECOND + SECOND_JITTER_MS * MSEC + SLACK),
+		"%" PRIu64);
+
+	return EC_SUCCESS;
+}
+
+static int test_tick_coalesced_with_deferred(void)
+{
+	int count = tick_hook_count;
+	uint64_t since_tick;
+
+	/* Line up with the last tick */
+	while (tick_hook_count == count)
+		crec_usleep(MSEC);
+	count = tick_hook_count;
+	since_tick = get_time().val - tick_time[1].val;
+
+	/*
+	 * Fire a deferred call halfway through the jitter window of the next
+	 * tick: the tick should run in the same wakeup rather than on its own.
+	 */
+	hook_call_deferred(&deferred_func_data,
+			   HOOK_TICK_INTERVAL + TICK_JITTER_MS * MSEC / 2 -
+				   since_tick);
+	while (tick_hook_count == count)
+		crec_usleep(MSEC);
+
+	TEST_GE(tick_time[1].val, deferred_time.val, "%" PRIu64);
+	TEST_LE(tick_time[1].val - deferred_time.val, (uint64_t)SLACK,
+		"%" PRIu64);
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_ticks_within_jitter);
+	RUN_TEST(test_tick_coalesced_with_deferred);
+
+	test_print_result();
+}
@@ -8,6 +8,7 @@
 #include "common.h"
 #include "console.h"
 #include "host_command.h"
+#include "link_defs.h"
 #include "printf.h"
 #include "task.h"
 #include "test_util.h"
@@ -306,6 +307,173 @@ static int test_hostcmd_clears_unused_data(void)
 	return EC_SUCCESS;
 }
 
+static int test_hostcmd_table_sorted(void)
+{
+	const struct host_command *cmd;
+
+	/* find_host_command() binary searches the table */
+	for (cmd = __hcmds + 1; cmd < __hcmds_end; cmd++)
+		TEST_LT(cmd[-1].command, cmd->command, "0x%x");
+
+	for (cmd = __hcmds; cmd < __hcmds_end; cmd++)
+		TEST_EQ(find_host_command(cmd->command), cmd, "%p");
+
+	TEST_EQ(find_host_command(UINT16_MAX), NULL, "%p");
+
+	return EC_SUCCESS;
+}
+
+#ifdef CONFIG_HOSTCMD_BATCH
+static uint8_t batch_buf[BUFFER_SIZE] __aligned(4);
+static uint8_t batch_resp_buf[BUFFER_SIZE] __aligned(4);
+
+/* Append a sub-command to batch_buf, returning the new params size. */
+static int batch_add(int size, uint16_t command, const void *params,
+		     int params_size, int response_max)
+{
+	struct ec_params_batch *b = (struct ec_params_batch *)batch_buf;
+	struct ec_params_batch_cmd *cmd =
+		(struct ec_params_batch_cmd *)(batch_buf + size);
+
+	if (!size) {
+		memset(batch_buf, 0, sizeof(batch_buf));
+		size = sizeof(*b);
+		cmd = (struct ec_params_batch_cmd *)(batch_buf + size);
+	}
+
+	cmd->command = command;
+	cmd->version = 0;
+	cmd->params_size = params_size;
+	cmd->response_max = response_max;
+	memcpy(cmd + 1, params, params_size);
+	b->num_cmds++;
+
+	return size + sizeof(*cmd) + EC_BATCH_ALIGN(params_size);
+}
+
+/* Return the n-th sub-response in batch_resp_buf. */
+static struct ec_response_batch_cmd *batch_response(int n)
+{
+	uint8_t *ptr = batch_resp_buf + sizeof(struct ec_response_batch);
+	struct ec_response_batch_cmd *resp;
+
+	for (;;) {
+		resp = (struct ec_response_batch_cmd *)ptr;
+		if (!n--)
+			return resp;
+		ptr += sizeof(*resp) + EC_BATCH_ALIGN(resp->response_size);
+	}
+}
+
+static int test_hostcmd_batch(void)
+{
+	struct ec_params_hello hello = { .in_data = 0x11223344 };
+	struct ec_response_batch *r =
+		(struct ec_response_batch *)batch_resp_buf;
+	struct ec_response_batch_cmd *resp;
+	int size = 0;
+
+	size = batch_add(size, EC_CMD_HELLO, &hello, sizeof(hello),
+			 sizeof(struct ec_response_hello));
+	size = batch_add(size, EC_CMD_BATCH, NULL, 0, 0);
+	size = batch_add(size, 0x7fff, NULL, 0, 0);
+	hello.in_data = 0x01020304;
+	size = batch_add(size, EC_CMD_HELLO, &hello, sizeof(hello),
+			 sizeof(struct ec_response_hello));
+
+	TEST_EQ(test_send_host_command(EC_CMD_BATCH, 0, batch_buf, size,
+				       batch_resp_buf, sizeof(batch_resp_buf)),
+		EC_RES_SUCCESS, "%d");
+	TEST_EQ(r->num_done, 4, "%d");
+
+	resp = batch_response(0);
+	TEST_EQ(resp->result, EC_RES_SUCCESS, "%d");
+	TEST_EQ(resp->response_size, (int)sizeof(struct ec_response_hello), "%d");
+	TEST_EQ(((struct ec_response_hello *)(resp + 1))->out_data,
+		0x12243648, "0x%x");
+
+	/* Nested batches are rejected, unknown commands fail as usual. */
+	TEST_EQ(batch_response(1)->result, EC_RES_INVALID_COMMAND, "%d");
+	TEST_EQ(batch_response(2)->result, EC_RES_INVALID_COMMAND, "%d");
+
+	resp = batch_response(3);
+	TEST_EQ(resp->result, EC_RES_SUCCESS, "%d");
+	TEST_EQ(((struct ec_response_hello *)(resp + 1))->out_data,
+		0x02040608, "0x%x");
+
+	return EC_SUCCESS;
+}
+
+static int test_hostcmd_batch_stop_on_error(void)
+{
+	struct ec_params_hello hello = { .in_data = 0 };
+	struct ec_response_batch *r =
+		(struct ec_response_batch *)batch_resp_buf;
+	int size = 0;
+
+	size = batch_add(size, 0x7fff, NULL, 0, 0);
+	size = batch_add(size, EC_CMD_HELLO, &hello, sizeof(hello),
+			 sizeof(struct ec_response_hello));
+	((struct ec_params_batch *)batch_buf)->flags =
+		EC_BATCH_FLAG_STOP_ON_ERROR;
+
+	TEST_EQ(test_send_host_command(EC_CMD_BATCH, 0, batch_buf, size,
+				       batch_resp_buf, sizeof(batch_resp_buf)),
+		EC_RES_SUCCESS, "%d");
+	TEST_EQ(r->num_done, 1, "%d");
+	TEST_EQ(batch_response(0)->result, EC_RES_INVALID_COMMAND, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_hostcmd_batch_response_full(void)
+{
+	struct ec_params_hello hello = { .in_data = 0 };
+	struct ec_response_batch *r =
+		(struct ec_response_batch *)batch_resp_buf;
+	int size = 0;
+	int i;
+
+	for (i = 0; i < 3; i++)
+		size = batch_add(size, EC_CMD_HELLO, &hello, sizeof(hello),
+				 sizeof(struct ec_response_hello));
+
+	/* Room for the batch header and two sub-responses only */
+	TEST_EQ(test_send_host_command(
+			EC_CMD_BATCH, 0, batch_buf, size, batch_resp_buf,
+			sizeof(*r) + 2 * (sizeof(struct ec_response_batch_cmd) +
+					  sizeof(struct ec_response_hello))),
+		EC_RES_SUCCESS, "%d");
+	TEST_EQ(r->num_done, 2, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_hostcmd_batch_malformed(void)
+{
+	struct ec_params_hello hello = { .in_data = 0 };
+	int size = 0;
+
+	size = batch_add(size, EC_CMD_HELLO, &hello, sizeof(hello),
+			 sizeof(struct ec_response_hello));
+
+	/* Truncated sub-command params */
+	TEST_EQ(test_send_host_command(EC_CMD_BATCH, 0, batch_buf, size - 1,
+				       batch_resp_buf, sizeof(batch_resp_buf)),
+		EC_RES_INVALID_PARAM, "%d");
+
+	/* More sub-commands announced than present */
+	size = batch_add(0, EC_CMD_HELLO, &hello, sizeof(hello),
+			 sizeof(struct ec_response_hello));
+	((struct ec_params_batch *)batch_buf)->num_cmds = 2;
+	TEST_EQ(test_send_host_command(EC_CMD_BATCH, 0, batch_buf, size,
+				       batch_resp_buf, sizeof(batch_resp_buf)),
+		EC_RES_INVALID_PARAM, "%d");
+
+	return EC_SUCCESS;
+}
+#endif /* CONFIG_HOSTCMD_BATCH */
+
 void run_test(int argc, const char **argv)
 {
 	wait_for_task_started();
@@ -321,6 +489,13 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_hostcmd_invalid_checksum);
 	RUN_TEST(test_hostcmd_reuse_response_buffer);
 	RUN_TEST(test_hostcmd_clears_unused_data);
+	RUN_TEST(test_hostcmd_table_sorted);
+#ifdef CONFIG_HOSTCMD_BATCH
+	RUN_TEST(test_hostcmd_batch);
+	RUN_TEST(test_hostcmd_batch_stop_on_error);
+	RUN_TEST(test_hostcmd_batch_response_full);
+	RUN_TEST(test_hostcmd_batch_malformed);
+#endif
 
 	test_print_result();
 }
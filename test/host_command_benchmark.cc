@@ -0,0 +1,90 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Measure the host command lookup on the sorted table compared to a linear
+ * scan of the same table.
+ */
+
+#include "benchmark.h"
+#include "ec_commands.h"
+#include "host_command.h"
+#include "link_defs.h"
+#include "test_util.h"
+
+#include <array>
+
+/* Commands polled at a high rate by the kernel driver */
+static constexpr std::array<uint16_t, 6> hot_commands = {
+	EC_CMD_GET_NEXT_EVENT,	  EC_CMD_MOTION_SENSE_CMD,
+	EC_CMD_CHARGE_STATE,	  EC_CMD_GET_CMD_VERSIONS,
+	EC_CMD_HOST_EVENT,	  EC_CMD_GET_PROTOCOL_INFO,
+};
+
+static constexpr int lookups_per_iteration = 10000;
+
+static const struct host_command *linear_find_host_command(int command)
+{
+	for (const struct host_command *cmd = __hcmds; cmd < __hcmds_end;
+	     cmd++) {
+		if (command == cmd->command)
+			return cmd;
+	}
+
+	return NULL;
+}
+
+test_static int test_lookup_results_match()
+{
+	for (const struct host_command *cmd = __hcmds; cmd < __hcmds_end;
+	     cmd++) {
+		TEST_EQ(find_host_command(cmd->command),
+			linear_find_host_command(cmd->command), "%p");
+	}
+
+	for (auto command : hot_commands)
+		TEST_EQ(find_host_command(command),
+			linear_find_host_command(command), "%p");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_lookup_benchmark()
+{
+	Benchmark benchmark({ .num_iterations = 100 });
+	volatile uintptr_t sink = 0;
+
+	ccprintf("Host command table: %d entries\n",
+		 static_cast<int>(__hcmds_end - __hcmds));
+
+	auto linear = benchmark.run("linear", [&sink]() {
+		for (int i = 0; i < lookups_per_iteration; ++i) {
+			uint16_t command = hot_commands[i % hot_commands.size()];
+			sink = sink + reinterpret_cast<uintptr_t>(
+					      linear_find_host_command(command));
+		}
+	});
+	TEST_ASSERT(linear.has_value());
+
+	auto sorted = benchmark.run("sorted", [&sink]() {
+		for (int i = 0; i < lookups_per_iteration; ++i) {
+			uint16_t command = hot_commands[i % hot_commands.size()];
+			sink = sink + reinterpret_cast<uintptr_t>(
+					      find_host_command(command));
+		}
+	});
+	TEST_ASSERT(sorted.has_value());
+
+	benchmark.print_results();
+	BenchmarkResult::compare(*linear, *sorted);
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+	RUN_TEST(test_lookup_results_match);
+	RUN_TEST(test_lookup_benchmark);
+	test_print_result();
+}
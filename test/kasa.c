@@ -63,12 +63,51 @@ static int test_kasa_calculate(void)
 	return EC_SUCCESS;
 }
 
+static int test_kasa_accumulate_batch(void)
+{
+	static const intv3_t v[] = {
+		{ -522, 5, -5 }, { 527, 3, -2 }, { -3, -519, -2 },
+		{ -5, 528, 4 },	 { -5, 0, -524 }, { 4, -2, 524 },
+		{ 1, 3, 520 },
+	};
+	struct kasa_fit scalar, batch;
+	fpv3_t scalar_bias, batch_bias;
+	fp_t scalar_radius, batch_radius;
+	int i;
+
+	kasa_reset(&scalar);
+	kasa_reset(&batch);
+	for (i = 0; i < ARRAY_SIZE(v); i++)
+		kasa_accumulate(&scalar, INT_TO_FP(v[i][X]), INT_TO_FP(v[i][Y]),
+				INT_TO_FP(v[i][Z]));
+	/* Split the batch, so that it is folded in more than once. */
+	kasa_accumulate_batch(&batch, v, 4);
+	kasa_accumulate_batch(&batch, v + 4, ARRAY_SIZE(v) - 4);
+
+	TEST_EQ(batch.nsamples, scalar.nsamples, "%u");
+	/* Integer sums are exact, the scalar float path is not. */
+	TEST_NEAR(batch.acc_x, scalar.acc_x, 0.001f, "%f");
+	TEST_NEAR(batch.acc_xx, scalar.acc_xx, 1.0f, "%f");
+	TEST_NEAR(batch.acc_yz, scalar.acc_yz, 1.0f, "%f");
+	TEST_NEAR(batch.acc_w / scalar.acc_w, 1.0f, 0.000001f, "%f");
+	TEST_NEAR(batch.acc_zw / scalar.acc_zw, 1.0f, 0.000001f, "%f");
+
+	kasa_compute(&scalar, scalar_bias, &scalar_radius);
+	kasa_compute(&batch, batch_bias, &batch_radius);
+	for (i = X; i <= Z; i++)
+		TEST_NEAR(batch_bias[i], scalar_bias[i], 0.01f, "%f");
+	TEST_NEAR(batch_radius, scalar_radius, 0.01f, "%f");
+
+	return EC_SUCCESS;
+}
+
 void run_test(int argc, const char **argv)
 {
 	test_reset();
 
 	RUN_TEST(test_kasa_reset);
 	RUN_TEST(test_kasa_calculate);
+	RUN_TEST(test_kasa_accumulate_batch);
 
 	test_print_result();
 }
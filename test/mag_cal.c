@@ -64,11 +64,75 @@ static int test_mag_cal_computes_bias(void)
 	return EC_SUCCESS;
 }
 
+static int test_mag_cal_update_batch(void)
+{
+	struct mag_cal_t scalar, batch;
+	int i;
+
+	init_mag_cal(&scalar);
+	init_mag_cal(&batch);
+	scalar.batch_size = batch.batch_size = ARRAY_SIZE(samples) - 4;
+
+	/*
+	 * A calibration batch boundary falls in the middle of the second FIFO
+	 * batch, the calibrations must match the per-sample path.
+	 */
+	for (i = 0; i < ARRAY_SIZE(samples); ++i)
+		mag_cal_update(&scalar, samples[i]);
+	TEST_EQ(0, mag_cal_update_batch(&batch, samples, 8), "%d");
+	TEST_EQ(1, mag_cal_update_batch(&batch, samples + 8, 16), "%d");
+	TEST_EQ(batch.kasa_fit.nsamples, scalar.kasa_fit.nsamples, "%u");
+	TEST_EQ(batch.kasa_fit.nsamples, 4, "%u");
+	TEST_EQ(FP_TO_INT(batch.radius), FP_TO_INT(scalar.radius), "%d");
+	for (i = X; i <= Z; i++)
+		TEST_EQ(batch.bias[i], scalar.bias[i], "%d");
+
+	/* The same samples as one batch give the reference calibration. */
+	init_mag_cal(&batch);
+	batch.batch_size = ARRAY_SIZE(samples);
+	TEST_EQ(1, mag_cal_update_batch(&batch, samples, ARRAY_SIZE(samples)),
+		"%d");
+	TEST_EQ(525, FP_TO_INT(batch.radius), "%d");
+	TEST_EQ(1, batch.bias[0], "%d");
+	TEST_EQ(-1, batch.bias[1], "%d");
+	TEST_EQ(2, batch.bias[2], "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_mag_cal_stage(void)
+{
+	struct mag_cal_t cal;
+	int i;
+
+	init_mag_cal(&cal);
+	cal.batch_size = ARRAY_SIZE(samples);
+
+	/* Nothing is accumulated until the stage is full. */
+	for (i = 0; i < MAG_CAL_STAGE_SIZE - 1; ++i)
+		TEST_EQ(0, mag_cal_stage(&cal, samples[i]), "%d");
+	TEST_EQ(cal.kasa_fit.nsamples, 0, "%u");
+	TEST_EQ(0, mag_cal_stage(&cal, samples[i++]), "%d");
+	TEST_EQ(cal.kasa_fit.nsamples, MAG_CAL_STAGE_SIZE, "%u");
+
+	for (; i < ARRAY_SIZE(samples) - 1; ++i)
+		TEST_EQ(0, mag_cal_stage(&cal, samples[i]), "%d");
+	TEST_EQ(1, mag_cal_stage(&cal, samples[i]), "%d");
+	TEST_EQ(525, FP_TO_INT(cal.radius), "%d");
+	TEST_EQ(1, cal.bias[0], "%d");
+	TEST_EQ(-1, cal.bias[1], "%d");
+	TEST_EQ(2, cal.bias[2], "%d");
+
+	return EC_SUCCESS;
+}
+
 void run_test(int argc, const char **argv)
 {
 	test_reset();
 
 	RUN_TEST(test_mag_cal_computes_bias);
+	RUN_TEST(test_mag_cal_update_batch);
+	RUN_TEST(test_mag_cal_stage);
 
 	test_print_result();
 }
@@ -46,6 +46,41 @@ static int test_acos(void)
 	return EC_SUCCESS;
 }
 
+/* Bound of the table interpolation, plus fixed point rounding. */
+#define ATAN2_TOLERANCE_DEG 0.02f
+
+static int test_atan2(void)
+{
+	float a, b, err, max_err = 0;
+	int x, y, i;
+
+	/* Go around the circle, at short and long vectors. */
+	for (i = 0; i < 36000; i++) {
+		x = (i % 2 ? 16384 : 300) * cos(i / 100.0f / RAD_TO_DEG);
+		y = (i % 2 ? 16384 : 300) * sin(i / 100.0f / RAD_TO_DEG);
+		a = FP_TO_FLOAT(arc_tan2(y, x));
+		b = atan2(y, x) * RAD_TO_DEG;
+		TEST_ASSERT(a >= 0.0f && a < 360.0f);
+
+		err = fabsf(a - b);
+		if (err > 180.0f)
+			err = 360.0f - err;
+		max_err = MAX(max_err, err);
+	}
+	ccprintf("atan2 max error %d.%04d degree\n", (int)max_err,
+		 (int)(max_err * 10000) % 10000);
+	TEST_ASSERT(max_err < ATAN2_TOLERANCE_DEG);
+
+	TEST_ASSERT(arc_tan2(0, 0) == FLOAT_TO_FP(0));
+	TEST_ASSERT(arc_tan2(0, 5) == FLOAT_TO_FP(0));
+	TEST_ASSERT(arc_tan2(5, 0) == FLOAT_TO_FP(90));
+	TEST_ASSERT(arc_tan2(0, -5) == FLOAT_TO_FP(180));
+	TEST_ASSERT(arc_tan2(-5, 0) == FLOAT_TO_FP(270));
+	TEST_ASSERT(arc_tan2(-5, 5) == FLOAT_TO_FP(315));
+
+	return EC_SUCCESS;
+}
+
 const mat33_fp_t test_matrices[] = {
 	{ { 0, FLOAT_TO_FP(-1), 0 },
 	  { FLOAT_TO_FP(-1), 0, 0 },
@@ -126,6 +161,7 @@ void run_test(int argc, const char **argv)
 	test_reset();
 
 	RUN_TEST(test_acos);
+	RUN_TEST(test_atan2);
 	RUN_TEST(test_rotate);
 	RUN_TEST(test_round_divide);
 	RUN_TEST(test_temp_conversion);
@@ -20,6 +20,7 @@
 
 #include <math.h>
 #include <stdio.h>
+#include <time.h>
 
 extern enum chipset_state_mask sensor_active;
 extern int wait_us;
@@ -396,11 +397,178 @@ static int test_lid_angle(void)
 	return EC_SUCCESS;
 }
 
+static int get_sched_stats(int sensor_num, bool reset,
+			   struct ec_response_motion_sense_sched_stats *stats)
+{
+	struct ec_params_motion_sense params = {
+		.cmd = MOTIONSENSE_CMD_SCHED_STATS,
+		.sched_stats = {
+			.sensor_num = sensor_num,
+			.reset = reset,
+		},
+	};
+	struct ec_response_motion_sense resp;
+	int rv;
+
+	rv = test_send_host_command(EC_CMD_MOTION_SENSE_CMD, 2, &params,
+				   sizeof(params), &resp, sizeof(resp));
+	memcpy(stats, &resp.sched_stats, sizeof(*stats));
+	return rv;
+}
+
+static int test_sched_stats(void)
+{
+	struct ec_response_motion_sense_sched_stats stats;
+
+	hook_notify(HOOK_CHIPSET_SUSPEND);
+	hook_notify(HOOK_CHIPSET_RESUME);
+	crec_msleep(50);
+	TEST_ASSERT(sensor_active == SENSOR_ACTIVE_S0);
+
+	/* Start from a clean slate, then let the task read the sensors. */
+	TEST_EQ(get_sched_stats(BASE, true, &stats), EC_RES_SUCCESS, "%d");
+	TEST_EQ(get_sched_stats(LID, true, &stats), EC_RES_SUCCESS, "%d");
+	crec_msleep(20 * TEST_LID_EC_RATE / MSEC);
+
+	TEST_EQ(get_sched_stats(LID, false, &stats), EC_RES_SUCCESS, "%d");
+	TEST_GE(stats.reads, 10U, "%u");
+	TEST_LE(stats.late_reads, stats.reads, "%u");
+	TEST_LE(stats.jitter_avg_us, stats.jitter_max_us, "%u");
+
+	/* Both sensors are read from the same deadline queue. */
+	TEST_EQ(get_sched_stats(BASE, true, &stats), EC_RES_SUCCESS, "%d");
+	TEST_GE(stats.reads, 10U, "%u");
+	TEST_EQ(get_sched_stats(BASE, false, &stats), EC_RES_SUCCESS, "%d");
+	TEST_LE(stats.reads, 1U, "%u");
+
+	TEST_EQ(get_sched_stats(motion_sensor_count, false, &stats),
+		EC_RES_INVALID_PARAM, "%d");
+
+	hook_notify(HOOK_CHIPSET_SHUTDOWN);
+	crec_msleep(1000);
+	TEST_ASSERT(wait_us == -1);
+
+	return EC_SUCCESS;
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* Worst error of the two hinge angle implementations, in degrees. */
+#define HINGE_ANGLE_ACOS_TOLERANCE_DEG 2.5
+#define HINGE_ANGLE_ATAN_TOLERANCE_DEG 0.04
+
+#define BENCH_STEPS 3600
+#define BENCH_ROUNDS 20
+
+struct hinge_angle_bench {
+	const char *name;
+	fp_t (*angle)(const intv3_t base, const intv3_t lid);
+	double max_err;
+	uint64_t ns;
+};
+
+/*
+ * Base and lid vectors projected on the hinge plane, as calculate_lid_angle()
+ * sees them: one of each lid angle, 0.1 degree apart, with the base rotated
+ * and the vectors shortened by a tilted hinge.
+ */
+static intv3_t bench_base[BENCH_STEPS], bench_lid[BENCH_STEPS];
+static double bench_expected[BENCH_STEPS];
+
+static void hinge_angle_bench_setup(void)
+{
+	const int u = (X + 1) % 3, v = (X + 2) % 3;
+	double base_phi, lid_phi, mag, exact;
+	int i;
+
+	for (i = 0; i < BENCH_STEPS; i++) {
+		base_phi = (i % 24) * 15.0 * M_PI / 180;
+		lid_phi = base_phi - i * 0.1 * M_PI / 180;
+		mag = MOTION_SCALING_FACTOR * (0.2 + 0.8 * (i % 5) / 4);
+
+		memset(bench_base[i], 0, sizeof(intv3_t));
+		memset(bench_lid[i], 0, sizeof(intv3_t));
+		bench_base[i][u] = lround(mag * cos(base_phi));
+		bench_base[i][v] = lround(mag * sin(base_phi));
+		bench_lid[i][u] = lround(mag * cos(lid_phi));
+		bench_lid[i][v] = lround(mag * sin(lid_phi));
+
+		/* Angle between the rounded vectors. */
+		exact = atan2(bench_base[i][v], bench_base[i][u]) -
+			atan2(bench_lid[i][v], bench_lid[i][u]);
+		exact *= 180 / M_PI;
+		bench_expected[i] = exact < 0 ? exact + 360 : exact;
+	}
+}
+
+static void hinge_angle_bench_run(struct hinge_angle_bench *bench)
+{
+	volatile fp_t sink;
+	uint64_t start;
+	double err;
+	int i, round;
+
+	bench->max_err = 0;
+	for (i = 0; i < BENCH_STEPS; i++) {
+		err = fabs(FP_TO_FLOAT(bench->angle(bench_base[i],
+						    bench_lid[i])) -
+			   bench_expected[i]);
+		if (err > 180)
+			err = 360 - err;
+		bench->max_err = MAX(bench->max_err, err);
+	}
+
+	start = now_ns();
+	for (round = 0; round < BENCH_ROUNDS; round++)
+		for (i = 0; i < BENCH_STEPS; i++)
+			sink = bench->angle(bench_base[i], bench_lid[i]);
+	bench->ns = now_ns() - start;
+	(void)sink;
+
+	ccprintf("%s: %d ns/angle, max error %d.%03d degree\n", bench->name,
+		 (int)(bench->ns / (BENCH_ROUNDS * BENCH_STEPS)),
+		 (int)bench->max_err, (int)(bench->max_err * 1000) % 1000);
+}
+
+/*
+ * Compare the table driven hinge angle with the arc cosine one, on the host
+ * a cycle is a ns.
+ */
+static int test_hinge_angle_benchmark(void)
+{
+	struct hinge_angle_bench acos_bench = {
+		.name = "hinge_angle_acos",
+		.angle = hinge_angle_acos,
+	};
+	struct hinge_angle_bench atan_bench = {
+		.name = "hinge_angle_atan",
+		.angle = hinge_angle_atan,
+	};
+
+	hinge_angle_bench_setup();
+	hinge_angle_bench_run(&acos_bench);
+	hinge_angle_bench_run(&atan_bench);
+
+	TEST_ASSERT(acos_bench.max_err < HINGE_ANGLE_ACOS_TOLERANCE_DEG);
+	TEST_ASSERT(atan_bench.max_err < HINGE_ANGLE_ATAN_TOLERANCE_DEG);
+	TEST_ASSERT(atan_bench.max_err < acos_bench.max_err);
+
+	return EC_SUCCESS;
+}
+
 void run_test(int argc, const char **argv)
 {
 	test_reset();
 
 	RUN_TEST(test_lid_angle);
+	RUN_TEST(test_sched_stats);
+	RUN_TEST(test_hinge_angle_benchmark);
 
 	test_print_result();
 }
@@ -9,6 +9,8 @@
 #include "ec_commands.h"
 #include "hwtimer.h"
 #include "motion_sense_fifo.h"
+#include "motion_sense_fifo_delta.h"
+#include "motion_sense_trace.h"
 #include "stdio.h"
 #include "task.h"
 #include "test_util.h"
@@ -493,6 +495,448 @@ static int test_check_ap_interval_set_multiple_sample(void)
 	return EC_SUCCESS;
 }
 
+static int test_batch_matches_stage_data(void)
+{
+	static struct ec_response_motion_sensor_data expected[18];
+	struct motion_sense_fifo_batch batch;
+	struct ec_response_motion_sensor_data vector;
+	uint16_t expected_bytes;
+	int v[3];
+	int i;
+
+	motion_sensors[0].oversampling_ratio = 1;
+	motion_sensors[1].oversampling_ratio = 2;
+	motion_sensors[0].oversampling = 0;
+	motion_sensors[1].oversampling = 0;
+
+	/* Reference: stage samples one at a time, alternating sensors. */
+	for (i = 0; i < 10; i++) {
+		vector.flags = 0;
+		vector.sensor_num = i & 1;
+		vector.data[X] = i;
+		vector.data[Y] = -i;
+		vector.data[Z] = 100 + i;
+		motion_sense_fifo_stage_data(&vector, motion_sensors + (i & 1),
+					     3, 1000);
+	}
+	motion_sense_fifo_commit_data();
+	TEST_EQ(motion_sense_fifo_read(sizeof(expected), ARRAY_SIZE(expected),
+				       expected, &expected_bytes),
+		18, "%d");
+
+	before_test();
+	motion_sensors[0].oversampling = 0;
+	motion_sensors[1].oversampling = 0;
+
+	/* Same samples through a batch. */
+	motion_sense_fifo_batch_init(&batch, 1000);
+	for (i = 0; i < 10; i++) {
+		v[X] = i;
+		v[Y] = -i;
+		v[Z] = 100 + i;
+		motion_sense_fifo_batch_add(&batch, motion_sensors + (i & 1),
+					    v);
+	}
+	motion_sense_fifo_batch_flush(&batch);
+	TEST_EQ(batch.count, 0, "%d");
+	motion_sense_fifo_commit_data();
+
+	motion_sense_fifo_read(sizeof(data), CONFIG_ACCEL_FIFO_SIZE, data,
+			       &data_bytes_read);
+	TEST_EQ(data_bytes_read, expected_bytes, "%d");
+	for (i = 0; i < ARRAY_SIZE(expected); i++) {
+		TEST_EQ(data[i].flags, expected[i].flags, "0x%x");
+		TEST_EQ(data[i].sensor_num, expected[i].sensor_num, "%d");
+		if (expected[i].flags & MOTIONSENSE_SENSOR_FLAG_TIMESTAMP) {
+			TEST_EQ(data[i].timestamp, expected[i].timestamp, "%u");
+		} else {
+			TEST_EQ(data[i].data[X], expected[i].data[X], "%d");
+			TEST_EQ(data[i].data[Y], expected[i].data[Y], "%d");
+			TEST_EQ(data[i].data[Z], expected[i].data[Z], "%d");
+		}
+	}
+	TEST_EQ(motion_sensors[0].xyz[X], 8, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_batch_flushes_when_full(void)
+{
+	struct motion_sense_fifo_batch batch;
+	int v[3] = { 1, 2, 3 };
+	int i;
+
+	motion_sensors[0].oversampling_ratio = 1;
+
+	motion_sense_fifo_batch_init(&batch, 1000);
+	for (i = 0; i < MOTION_SENSE_FIFO_BATCH_SIZE + 1; i++)
+		motion_sense_fifo_batch_add(&batch, motion_sensors, v);
+	TEST_EQ(batch.count, 1, "%d");
+
+	/* A full batch is staged, a timestamp and data per sample. */
+	motion_sense_fifo_commit_data();
+	TEST_EQ(motion_sense_fifo_read(sizeof(data), CONFIG_ACCEL_FIFO_SIZE,
+				       data, &data_bytes_read),
+		2 * MOTION_SENSE_FIFO_BATCH_SIZE, "%d");
+
+	motion_sense_fifo_batch_flush(&batch);
+	motion_sense_fifo_commit_data();
+	TEST_EQ(motion_sense_fifo_read(sizeof(data), CONFIG_ACCEL_FIFO_SIZE,
+				       data, &data_bytes_read),
+		2, "%d");
+
+	return EC_SUCCESS;
+}
+
+/*
+ * Motion task rounds every 5ms, reading both sensors at 200Hz. The AP asks
+ * for their data every 5ms.
+ */
+#define COALESCE_PERIOD_US 5000
+#define COALESCE_ROUNDS 100
+
+struct coalesce_result {
+	int interrupts;
+	/* Most events of a sensor in one interrupt. */
+	int max_events;
+	/* Longest time an event waited for an interrupt. */
+	uint32_t max_wait_us;
+	struct ec_response_motion_sense_fifo_coalesce stats;
+};
+
+static void coalesce_run(struct coalesce_result *result)
+{
+	/* Keep going forward, the EC remembers the last interrupt. */
+	static uint32_t now = 1000000;
+	uint32_t first = 0;
+	int i, round, events = 0;
+
+	memset(result, 0, sizeof(*result));
+	for (i = BASE; i <= LID; i++) {
+		motion_sensors[i].config[SENSOR_CONFIG_AP].odr = 200000;
+		motion_sensors[i].config[SENSOR_CONFIG_AP].ec_rate =
+			COALESCE_PERIOD_US;
+		motion_sensors[i].oversampling_ratio = 1;
+		motion_sense_set_data_period(i, COALESCE_PERIOD_US);
+	}
+
+	for (round = 0; round < COALESCE_ROUNDS; round++) {
+		now += COALESCE_PERIOD_US;
+		if (!events++)
+			first = now;
+		for (i = BASE; i <= LID; i++) {
+			data[0].flags = 0;
+			data[0].sensor_num = i;
+			motion_sense_fifo_stage_data(data, &motion_sensors[i],
+						     3, now);
+		}
+		motion_sense_fifo_commit_data();
+
+		if (!motion_sense_fifo_interrupt_needed()) {
+			motion_sense_fifo_interrupt_deferred();
+			continue;
+		}
+
+		/* The AP reads everything. */
+		motion_sense_fifo_interrupt_sent();
+		motion_sense_fifo_read(sizeof(data), CONFIG_ACCEL_FIFO_SIZE,
+				       data, &data_bytes_read);
+		motion_sense_fifo_reset_needed_flags();
+		result->interrupts++;
+		result->max_events = MAX(result->max_events, events);
+		result->max_wait_us = MAX(result->max_wait_us, now - first);
+		events = 0;
+	}
+	motion_sense_fifo_get_coalesce(BASE, &result->stats, true);
+}
+
+static int test_coalesce_none(void)
+{
+	struct coalesce_result result;
+
+	/* Every round interrupts the AP, nothing is saved. */
+	coalesce_run(&result);
+	TEST_EQ(result.interrupts, COALESCE_ROUNDS, "%d");
+	TEST_EQ(result.max_events, 1, "%d");
+	TEST_EQ(result.stats.max_latency_ms, 0, "%d");
+	TEST_EQ(result.stats.interrupts, (uint32_t)COALESCE_ROUNDS, "%u");
+	TEST_EQ(result.stats.interrupts_saved, 0U, "%u");
+
+	return EC_SUCCESS;
+}
+
+static int test_coalesce_max_latency(void)
+{
+	struct coalesce_result result;
+
+	/* Only the lid is coalesced, the base still interrupts every round. */
+	motion_sense_fifo_set_coalesce(LID, 20 * MSEC, 0);
+	coalesce_run(&result);
+	TEST_EQ(result.interrupts, COALESCE_ROUNDS, "%d");
+	TEST_EQ(result.stats.interrupts_saved, 0U, "%u");
+
+	/* Both coalesced, events wait up to 20ms and are sent together. */
+	motion_sense_fifo_set_coalesce(BASE, 20 * MSEC, 0);
+	coalesce_run(&result);
+	TEST_EQ(result.max_wait_us, 20U * MSEC, "%u");
+	TEST_EQ(result.max_events, 5, "%d");
+	TEST_EQ(result.interrupts, COALESCE_ROUNDS / 5, "%d");
+	TEST_EQ(result.stats.max_latency_ms, 20, "%d");
+	TEST_EQ(result.stats.interrupts, (uint32_t)result.interrupts, "%u");
+	TEST_EQ(result.stats.interrupts_saved,
+		(uint32_t)(COALESCE_ROUNDS - result.interrupts), "%u");
+
+	/* The shortest latency of the sensors wins. */
+	motion_sense_fifo_set_coalesce(LID, 10 * MSEC, 0);
+	coalesce_run(&result);
+	TEST_EQ(result.max_wait_us, 10U * MSEC, "%u");
+	TEST_EQ(result.interrupts, COALESCE_ROUNDS / 3, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_coalesce_max_events(void)
+{
+	struct coalesce_result result;
+
+	motion_sense_fifo_set_coalesce(BASE, 1000 * MSEC, 4);
+	motion_sense_fifo_set_coalesce(LID, 1000 * MSEC, 0);
+	coalesce_run(&result);
+	TEST_EQ(result.max_events, 4, "%d");
+	TEST_EQ(result.interrupts, COALESCE_ROUNDS / 4, "%d");
+	TEST_EQ(result.stats.max_events, 4, "%d");
+
+	/* Back to one interrupt every ec_rate. */
+	motion_sense_fifo_set_coalesce(BASE, 0, 4);
+	motion_sense_fifo_set_coalesce(LID, 0, 0);
+	coalesce_run(&result);
+	TEST_EQ(result.interrupts, COALESCE_ROUNDS, "%d");
+	TEST_EQ(result.stats.max_events, 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_coalesce_deadline(void)
+{
+	struct ec_response_motion_sense_fifo_coalesce stats;
+	uint32_t now;
+
+	motion_sensors[LID].config[SENSOR_CONFIG_AP].odr = 200000;
+	motion_sensors[LID].config[SENSOR_CONFIG_AP].ec_rate = 5000;
+	motion_sensors[LID].oversampling_ratio = 1;
+	motion_sense_set_data_period(LID, 5000);
+	motion_sense_fifo_set_coalesce(LID, 10 * MSEC, 0);
+
+	/* The sensor stops after one sample, the event still goes out. */
+	now = __hw_clock_source_read();
+	data[0].flags = 0;
+	data[0].sensor_num = LID;
+	motion_sense_fifo_stage_data(data, &motion_sensors[LID], 3, now);
+	motion_sense_fifo_commit_data();
+	TEST_EQ(motion_sense_fifo_interrupt_needed(), 0, "%d");
+	crec_msleep(11);
+	TEST_EQ(motion_sense_fifo_interrupt_needed(), 1, "%d");
+
+	/* No MKBP event was sent, no interrupt is counted. */
+	motion_sense_fifo_reset_needed_flags();
+	motion_sense_fifo_get_coalesce(LID, &stats, true);
+	TEST_EQ(stats.interrupts, 0U, "%u");
+
+	return EC_SUCCESS;
+}
+
+static int check_same_entries(const struct ec_response_motion_sensor_data *a,
+			      const struct ec_response_motion_sensor_data *b,
+			      int count)
+{
+	int i;
+
+	for (i = 0; i < count; i++) {
+		TEST_EQ(a[i].flags, b[i].flags, "0x%x");
+		TEST_EQ(a[i].sensor_num, b[i].sensor_num, "%d");
+		if (b[i].flags & MOTIONSENSE_SENSOR_FLAG_TIMESTAMP) {
+			TEST_EQ(a[i].timestamp, b[i].timestamp, "%u");
+		} else {
+			TEST_EQ(a[i].data[X], b[i].data[X], "%d");
+			TEST_EQ(a[i].data[Y], b[i].data[Y], "%d");
+			TEST_EQ(a[i].data[Z], b[i].data[Z], "%d");
+		}
+	}
+	return EC_SUCCESS;
+}
+
+/* Smooth samples from both sensors, with a few entries delta can not cover. */
+static void stage_delta_stream(void)
+{
+	struct ec_response_motion_sensor_data vector;
+	int i;
+
+	motion_sensors[0].oversampling_ratio = 1;
+	motion_sensors[1].oversampling_ratio = 1;
+	motion_sensors[0].oversampling = 0;
+	motion_sensors[1].oversampling = 0;
+	for (i = 0; i < 40; i++) {
+		/* Flagged entries are sent raw. */
+		vector.flags = i == 10 ? MOTIONSENSE_SENSOR_FLAG_WAKEUP : 0;
+		vector.sensor_num = i & 1;
+		vector.data[X] = 1000 + i * 3;
+		vector.data[Y] = -2000 - i * 5;
+		/* Large jump, encoded with full axes. */
+		vector.data[Z] = i == 20 ? INT16_MIN : 16384 - i;
+		/* Over 64ms between samples, needs a raw timestamp. */
+		motion_sense_fifo_stage_data(&vector, motion_sensors + (i & 1),
+					     3, 1000 + i * 2500 +
+						      (i >= 30 ? 100000 : 0));
+	}
+	motion_sense_fifo_commit_data();
+}
+
+static int test_read_delta_round_trip(void)
+{
+	static struct ec_response_motion_sensor_data expected[96];
+	static uint8_t encoded[sizeof(expected)];
+	struct ec_response_motion_sensor_data *decoded = data;
+	uint16_t expected_bytes;
+	uint16_t encoded_bytes;
+	int count;
+
+	stage_delta_stream();
+	count = motion_sense_fifo_read(sizeof(expected), ARRAY_SIZE(expected),
+				       expected, &expected_bytes);
+	TEST_EQ(count, 80, "%d");
+
+	before_test();
+	stage_delta_stream();
+	TEST_EQ(motion_sense_fifo_read_delta(sizeof(encoded),
+					     ARRAY_SIZE(expected), encoded,
+					     &encoded_bytes),
+		count, "%d");
+	TEST_EQ(motion_sense_fifo_delta_decode(encoded, encoded_bytes, count,
+					       decoded),
+		(int)encoded_bytes, "%d");
+	TEST_EQ(check_same_entries(decoded, expected, count), EC_SUCCESS,
+		"%d");
+
+	/*
+	 * A timestamp and a sample mostly take 7 bytes instead of 16, the
+	 * entries sent raw or with full axes cost a bit more.
+	 */
+	TEST_LE(encoded_bytes, expected_bytes * 6 / 10, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_read_delta_split_responses(void)
+{
+	static struct ec_response_motion_sensor_data expected[96];
+	uint8_t encoded[32];
+	uint16_t expected_bytes;
+	uint16_t encoded_bytes;
+	int total = 0;
+	int count;
+
+	stage_delta_stream();
+	TEST_EQ(motion_sense_fifo_read(sizeof(expected), ARRAY_SIZE(expected),
+				       expected, &expected_bytes),
+		80, "%d");
+
+	/* Every response decodes on its own, nothing is lost in between. */
+	before_test();
+	stage_delta_stream();
+	do {
+		count = motion_sense_fifo_read_delta(sizeof(encoded),
+						     CONFIG_ACCEL_FIFO_SIZE,
+						     encoded, &encoded_bytes);
+		TEST_LE((int)encoded_bytes, (int)sizeof(encoded), "%d");
+		TEST_EQ(motion_sense_fifo_delta_decode(encoded, encoded_bytes,
+						       count, &data[total]),
+			(int)encoded_bytes, "%d");
+		total += count;
+	} while (count);
+	TEST_EQ(total, 80, "%d");
+	TEST_EQ(check_same_entries(data, expected, total), EC_SUCCESS, "%d");
+
+	/* An entry never gets split. */
+	TEST_EQ(motion_sense_fifo_read_delta(
+			MOTIONSENSE_FIFO_DELTA_MAX_ENTRY_SIZE - 1,
+			CONFIG_ACCEL_FIFO_SIZE, encoded, &encoded_bytes),
+		0, "%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_trace_read_path(void)
+{
+	struct ec_motion_sense_trace_entry trace[8];
+	uint16_t lost;
+	int i;
+
+	motion_sensors[BASE].oversampling_ratio = 1;
+	motion_sensors[LID].oversampling_ratio = 1;
+	motion_sense_trace_reset();
+
+	motion_sense_trace_irq(BASE, 100);
+	for (i = 0; i < 3; i++) {
+		data[0].sensor_num = BASE;
+		motion_sense_fifo_stage_data(data, &motion_sensors[BASE], 3,
+					     100 + i);
+	}
+	data[0].sensor_num = LID;
+	motion_sense_fifo_stage_data(data, &motion_sensors[LID], 3, 110);
+	motion_sense_fifo_commit_data();
+	motion_sense_fifo_read(sizeof(data), CONFIG_ACCEL_FIFO_SIZE, &data,
+			       &data_bytes_read);
+
+	/* One stage and one commit per sensor, however many samples. */
+	TEST_EQ(motion_sense_trace_read(trace, ARRAY_SIZE(trace), &lost), 6,
+		"%d");
+	TEST_EQ(lost, 0, "%d");
+	TEST_EQ(trace[0].sensor_num, BASE, "%d");
+	TEST_EQ(trace[0].point, MOTIONSENSE_TRACE_IRQ, "%d");
+	TEST_EQ(trace[0].timestamp, 100, "%d");
+	TEST_EQ(trace[1].sensor_num, BASE, "%d");
+	TEST_EQ(trace[1].point, MOTIONSENSE_TRACE_STAGE, "%d");
+	TEST_EQ(trace[2].sensor_num, LID, "%d");
+	TEST_EQ(trace[2].point, MOTIONSENSE_TRACE_STAGE, "%d");
+	TEST_EQ(trace[3].point, MOTIONSENSE_TRACE_COMMIT, "%d");
+	TEST_EQ(trace[4].point, MOTIONSENSE_TRACE_COMMIT, "%d");
+	TEST_NE(trace[3].sensor_num, trace[4].sensor_num, "%d");
+	TEST_EQ(trace[5].sensor_num, MOTIONSENSE_TRACE_NO_SENSOR, "%d");
+	TEST_EQ(trace[5].point, MOTIONSENSE_TRACE_HOST_READ, "%d");
+	for (i = 1; i < 6; i++)
+		TEST_GE(trace[i].timestamp, trace[i - 1].timestamp, "%u");
+
+	/* Reading the trace removes the entries. */
+	TEST_EQ(motion_sense_trace_read(trace, ARRAY_SIZE(trace), &lost), 0,
+		"%d");
+
+	return EC_SUCCESS;
+}
+
+static int test_trace_drops_oldest(void)
+{
+	struct ec_motion_sense_trace_entry trace[4];
+	uint16_t lost;
+	int i;
+
+	motion_sense_trace_reset();
+	for (i = 0; i < CONFIG_ACCEL_TRACE_SIZE + 3; i++)
+		motion_sense_trace_irq(BASE, i);
+
+	TEST_EQ(motion_sense_trace_read(trace, ARRAY_SIZE(trace), &lost), 4,
+		"%d");
+	TEST_EQ(lost, 3, "%d");
+	TEST_EQ(trace[0].timestamp, 3, "%d");
+	TEST_EQ(trace[3].timestamp, 6, "%d");
+
+	/* The count of lost entries restarts at every read. */
+	TEST_EQ(motion_sense_trace_read(trace, 1, &lost), 1, "%d");
+	TEST_EQ(lost, 0, "%d");
+	TEST_EQ(trace[0].timestamp, 7, "%d");
+
+	return EC_SUCCESS;
+}
+
 void before_test(void)
 {
 	motion_sense_fifo_commit_data();
@@ -525,6 +969,16 @@ void run_test(int argc, const char **argv)
 	RUN_TEST(test_get_info_size);
 	RUN_TEST(test_check_ap_interval_set_one_sample);
 	RUN_TEST(test_check_ap_interval_set_multiple_sample);
+	RUN_TEST(test_batch_matches_stage_data);
+	RUN_TEST(test_batch_flushes_when_full);
+	RUN_TEST(test_coalesce_none);
+	RUN_TEST(test_coalesce_max_latency);
+	RUN_TEST(test_coalesce_max_events);
+	RUN_TEST(test_coalesce_deadline);
+	RUN_TEST(test_read_delta_round_trip);
+	RUN_TEST(test_read_delta_split_responses);
+	RUN_TEST(test_trace_read_path);
+	RUN_TEST(test_trace_drops_oldest);
 
 	test_print_result();
 }
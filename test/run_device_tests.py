@@ -90,6 +90,7 @@ ALL_TESTS_PASSED_REGEX_ZEPHYR = re.compile(r"PROJECT EXECUTION SUCCESSFUL")
 ALL_TESTS_FAILED_REGEX_ZEPHYR = re.compile(r"PROJECT EXECUTION FAILED")
 
 SINGLE_CHECK_PASSED_REGEX = re.compile(r"(Pass: .*)|(.* PASS - )")
+BENCHMARK_RESULT_REGEX = re.compile(r"^BENCHMARK name=\S+.*$")
 SINGLE_CHECK_FAILED_REGEX = re.compile(r"(.*failed:.*)|(.* FAIL - )")
 
 RW_IMAGE_BOOTED_REGEX = re.compile(r".*\[Image: RW.*")
@@ -1341,6 +1342,18 @@ def process_console_output_line(line: bytes, test: TestConfig):
         return None
 
 
+def write_benchmark_results(test_list: list[TestConfig], path: str) -> None:
+    """Write the machine-readable benchmark result lines of the tests."""
+    with open(path, "w", encoding="utf-8") as results:
+        for test in test_list:
+            for entry in test.logs:
+                lines = entry if isinstance(entry, list) else [entry]
+                for line in lines:
+                    line_str = line.decode(errors="ignore").strip()
+                    if BENCHMARK_RESULT_REGEX.match(line_str):
+                        results.write(f"{test.config_name} {line_str}\n")
+
+
 def run_test_ec(test: TestConfig) -> str:
     """Prepare a command to run test on CrosEC"""
     test_cmd = "runtest " + " ".join(test.test_args) + "\n"
@@ -1737,6 +1750,12 @@ def main():
         "--renode", help="Run tests with Renode emulator", action="store_true"
     )
 
+    parser.add_argument(
+        "--benchmark_results",
+        help="Write the BENCHMARK lines printed by the tests to this file, "
+        "so they can be diffed against a stored baseline.",
+    )
+
     args = parser.parse_args()
     logging.basicConfig(
         format="%(levelname)s:%(message)s", level=args.log_level
@@ -1769,6 +1788,9 @@ def main():
                 test, platform, board_config, args, executor
             )
 
+        if args.benchmark_results:
+            write_benchmark_results(test_list, args.benchmark_results)
+
         colorama.init()
         exit_code = 0
         for test in test_list:
@@ -0,0 +1,350 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Micro-benchmarks of the sensor math run on every sample or FIFO batch,
+ * comparing the straightforward paths with the optimized kernels.
+ */
+
+#include "als_process.h"
+#include "benchmark.h"
+#include "common.h"
+#include "kasa.h"
+#include "math_util.h"
+#include "mag_cal.h"
+#include "stillness_detector.h"
+#include "test_util.h"
+#include "timer.h"
+#include "vec3.h"
+#include "window_stats.h"
+
+#include <array>
+
+static constexpr BenchmarkOptions options = {
+	.num_iterations = 100,
+	.num_warmup_iterations = 5,
+};
+
+/* About a full hardware FIFO of magnetometer or accelerometer samples. */
+static std::array<intv3_t, 256> samples;
+
+static void init_samples()
+{
+	/* Noisy points around a 525 units sphere, like test/mag_cal.c. */
+	for (size_t i = 0; i < samples.size(); i++) {
+		int noise = (int)(i * 7 % 11) - 5;
+		int axis = i % 6 / 2;
+
+		samples[i][X] = noise;
+		samples[i][Y] = -noise;
+		samples[i][Z] = 3;
+		samples[i][axis] += i % 2 ? -525 : 525;
+	}
+}
+
+test_static int test_intv3_moments()
+{
+	Benchmark<2, 100> benchmark(options);
+	struct intv3_moments m;
+	volatile int64_t sink;
+
+	auto scalar = benchmark.run("moments_scalar", [&] {
+		intv3_moments_reset(&m);
+		for (const auto &v : samples)
+			intv3_moments_add(&m, &v, 1);
+		sink = m.sum_w[X];
+	});
+	TEST_ASSERT(scalar.has_value());
+
+	auto batch = benchmark.run("moments_batch", [&] {
+		intv3_moments_reset(&m);
+		intv3_moments_add(&m, samples.data(), samples.size());
+		sink = m.sum_w[X];
+	});
+	TEST_ASSERT(batch.has_value());
+	TEST_EQ(m.count, (uint32_t)samples.size(), "%u");
+
+	benchmark.print_results();
+	BenchmarkResult::compare(scalar.value(), batch.value());
+	return EC_SUCCESS;
+}
+
+test_static int test_kasa_accumulate()
+{
+	Benchmark<2, 100> benchmark(options);
+	struct kasa_fit kasa;
+	volatile fp_t sink;
+
+	auto scalar = benchmark.run("kasa_accumulate", [&] {
+		kasa_reset(&kasa);
+		for (const auto &v : samples)
+			kasa_accumulate(&kasa, INT_TO_FP(v[X]), INT_TO_FP(v[Y]),
+					INT_TO_FP(v[Z]));
+		sink = kasa.acc_zw;
+	});
+	TEST_ASSERT(scalar.has_value());
+
+	auto batch = benchmark.run("kasa_accumulate_batch", [&] {
+		kasa_reset(&kasa);
+		kasa_accumulate_batch(&kasa, samples.data(), samples.size());
+		sink = kasa.acc_zw;
+	});
+	TEST_ASSERT(batch.has_value());
+
+	benchmark.print_results();
+	BenchmarkResult::compare(scalar.value(), batch.value());
+	return EC_SUCCESS;
+}
+
+test_static int test_mag_cal_update()
+{
+	Benchmark<2, 100> benchmark(options);
+	struct mag_cal_t cal;
+	int scalar_bias = 0;
+	int batch_bias = 0;
+
+	/* The calibration batch boundaries do not line up with the FIFO. */
+	init_mag_cal(&cal);
+	cal.batch_size = MAG_CAL_MIN_BATCH_SIZE;
+	auto scalar = benchmark.run("mag_cal_update", [&] {
+		for (const auto &v : samples)
+			scalar_bias += mag_cal_update(&cal, v);
+	});
+	TEST_ASSERT(scalar.has_value());
+
+	init_mag_cal(&cal);
+	cal.batch_size = MAG_CAL_MIN_BATCH_SIZE;
+	auto batch = benchmark.run("mag_cal_update_batch", [&] {
+		batch_bias += mag_cal_update_batch(&cal, samples.data(),
+						   samples.size());
+	});
+	TEST_ASSERT(batch.has_value());
+	TEST_ASSERT(scalar_bias > 0);
+	TEST_ASSERT(batch_bias > 0);
+
+	benchmark.print_results();
+	BenchmarkResult::compare(scalar.value(), batch.value());
+	return EC_SUCCESS;
+}
+
+/* One second of data at 400Hz, the window body detection uses. */
+static constexpr int odr_hz = 400;
+
+static void print_cycles_per_sample(const BenchmarkResult &result)
+{
+	ccprintf("%s: %u cycles/sample at %dHz\n", result.name.data(),
+		 result.average_cycles / odr_hz, odr_hz);
+}
+
+test_static int test_window_stats()
+{
+	Benchmark<2, 100> benchmark(options);
+	static std::array<int32_t, odr_hz> history;
+	struct window_stats ws;
+	volatile uint64_t sink;
+
+	window_stats_init(&ws, history.data(), history.size());
+
+	/* Recompute the variance over the whole window for each sample. */
+	auto naive = benchmark.run("window_naive", [&] {
+		for (int i = 0; i < odr_hz; i++) {
+			int64_t sum = 0;
+			uint64_t n2_var = 0;
+
+			history[i] = samples[i % samples.size()][X];
+			for (int32_t x : history)
+				sum += x;
+			for (int32_t x : history) {
+				int64_t d = (int64_t)odr_hz * x - sum;
+
+				n2_var += d * d;
+			}
+			sink = n2_var / odr_hz;
+		}
+	});
+	TEST_ASSERT(naive.has_value());
+
+	auto sliding = benchmark.run("window_stats_push", [&] {
+		for (int i = 0; i < odr_hz; i++)
+			window_stats_push(&ws, samples[i % samples.size()][X]);
+		sink = window_stats_variance(&ws);
+	});
+	TEST_ASSERT(sliding.has_value());
+	TEST_ASSERT(window_stats_full(&ws));
+
+	benchmark.print_results();
+	BenchmarkResult::compare(naive.value(), sliding.value());
+	print_cycles_per_sample(naive.value());
+	print_cycles_per_sample(sliding.value());
+	return EC_SUCCESS;
+}
+
+test_static int test_still_det()
+{
+	Benchmark<2, 100> benchmark(options);
+	struct still_det sd = STILL_DET(100, SECOND / 2, SECOND, 10);
+	std::array<uint32_t, samples.size()> times;
+	uint32_t t = 0;
+	int still = 0;
+
+	auto result = benchmark.run("still_det_update", [&] {
+		for (int i = 0; i < odr_hz; i++, t += SECOND / odr_hz)
+			still += still_det_update(&sd, t,
+						  samples[i % samples.size()]);
+	});
+	TEST_ASSERT(result.has_value());
+
+	/* The same samples, one FIFO read at a time. */
+	auto batch = benchmark.run("still_det_update_batch", [&] {
+		for (int i = 0; i < odr_hz; i += samples.size()) {
+			size_t n = MIN(samples.size(), (size_t)(odr_hz - i));
+
+			for (size_t j = 0; j < n; j++, t += SECOND / odr_hz)
+				times[j] = t;
+			still += still_det_update_batch(&sd, times.data(),
+							samples.data(), n);
+		}
+	});
+	TEST_ASSERT(batch.has_value());
+
+	benchmark.print_results();
+	BenchmarkResult::compare(result.value(), batch.value());
+	print_cycles_per_sample(result.value());
+	print_cycles_per_sample(batch.value());
+	return EC_SUCCESS;
+}
+
+/* A batch of color light sensor samples, clear, red, green and blue. */
+static std::array<uint16_t, 64 * COEFF_CHANNEL_COUNT> crgb_raw;
+
+static const struct rgb_calibration_t rgb_cal = {
+	.rgb_cal = {
+		{
+			.scale = { .k_channel_scale = 0x8400,
+				   .cover_scale = 0x9000 },
+			.offset = 0,
+			.coeff = { FLOAT_TO_FP(0.01), FLOAT_TO_FP(0.2),
+				   FLOAT_TO_FP(0.3), FLOAT_TO_FP(-0.1) },
+		},
+		{
+			.scale = { .k_channel_scale = 0x7e00,
+				   .cover_scale = 0x9000 },
+			.offset = 2,
+			.coeff = { FLOAT_TO_FP(0.02), FLOAT_TO_FP(0.1),
+				   FLOAT_TO_FP(0.5), FLOAT_TO_FP(-0.2) },
+		},
+		{
+			.scale = { .k_channel_scale = 0x8800,
+				   .cover_scale = 0x9000 },
+			.offset = 1,
+			.coeff = { FLOAT_TO_FP(0.01), FLOAT_TO_FP(-0.1),
+				   FLOAT_TO_FP(0.2), FLOAT_TO_FP(0.7) },
+		},
+	},
+	.irt = FLOAT_TO_FP(0.5),
+};
+
+static const struct als_channel_scale_t clear_scale = {
+	.k_channel_scale = 0x8000,
+	.cover_scale = 0x9000,
+};
+
+/* Cover, integration time and gain scaling, one division per step. */
+static void als_scalar(const uint16_t *raw, int32_t *xyz, uint32_t norm_num,
+		       uint32_t norm_den)
+{
+	const struct als_channel_scale_t *csp;
+	int32_t crgb[COEFF_CHANNEL_COUNT];
+	int32_t prime[COEFF_CHANNEL_COUNT];
+	int32_t ir;
+	int i;
+
+	for (i = 0; i < COEFF_CHANNEL_COUNT; i++) {
+		csp = i ? &rgb_cal.rgb_cal[i - 1].scale : &clear_scale;
+		crgb[i] = SENSOR_APPLY_DIV_SCALE(raw[i], csp->k_channel_scale);
+		crgb[i] = SENSOR_APPLY_SCALE(crgb[i], csp->cover_scale);
+		crgb[i] = DIV_ROUND_NEAREST(crgb[i] * norm_num, norm_den);
+	}
+	ir = FP_TO_INT(fp_mul(INT_TO_FP(crgb[1] + crgb[2] + crgb[3] - crgb[0]),
+			      rgb_cal.irt) /
+		       2);
+	for (i = 0; i < COEFF_CHANNEL_COUNT; i++)
+		prime[i] = MAX(crgb[i] - ir, 0);
+	if (prime[0] == 0)
+		prime[3] = 0;
+	for (i = 0; i < 3; i++) {
+		const struct rgb_channel_calibration_t *p = &rgb_cal.rgb_cal[i];
+
+		xyz[i] = p->offset +
+			 FP_TO_INT((fp_inter_t)p->coeff[0] * prime[0] +
+				   (fp_inter_t)p->coeff[1] * prime[1] +
+				   (fp_inter_t)p->coeff[2] * prime[2] +
+				   (fp_inter_t)p->coeff[3] * prime[3]);
+		xyz[i] = MAX(xyz[i], 0);
+	}
+}
+
+test_static int test_als_crgb_to_xyz()
+{
+	Benchmark<2, 100> benchmark(options);
+	const struct als_channel_scale_t *const scale[COEFF_CHANNEL_COUNT] = {
+		&clear_scale,
+		&rgb_cal.rgb_cal[0].scale,
+		&rgb_cal.rgb_cal[1].scale,
+		&rgb_cal.rgb_cal[2].scale,
+	};
+	constexpr int count = crgb_raw.size() / COEFF_CHANNEL_COUNT;
+	/* Calibrated at atime 0x70, again 1; sampled at atime 0x40, again 2. */
+	constexpr uint32_t norm_num = (256 - 0x70) << 2;
+	constexpr uint32_t norm_den = (256 - 0x40) << 4;
+	std::array<int32_t, COEFF_CHANNEL_COUNT> crgb;
+	static std::array<int32_t, 3 * count> xyz_scalar;
+	static std::array<int32_t, 3 * count> xyz_batch;
+	struct als_crgb_gains gains = {};
+
+	for (size_t i = 0; i < crgb_raw.size(); i++)
+		crgb_raw[i] = 1000 + (i * 7919) % 20000;
+
+	auto scalar = benchmark.run("als_scalar", [&] {
+		for (int n = 0; n < count; n++)
+			als_scalar(&crgb_raw[n * COEFF_CHANNEL_COUNT],
+				   &xyz_scalar[n * 3], norm_num, norm_den);
+	});
+	TEST_ASSERT(scalar.has_value());
+
+	auto batch = benchmark.run("als_gains", [&] {
+		/* The driver caches both, they change with the settings. */
+		const uint32_t norm = als_norm_gain(norm_num, norm_den);
+
+		als_crgb_update_gains(&gains, scale);
+		for (int n = 0; n < count; n++) {
+			const uint16_t *raw = &crgb_raw[n * COEFF_CHANNEL_COUNT];
+
+			als_crgb_scale(&gains, raw, crgb.data());
+			als_crgb_to_xyz(&rgb_cal, norm, crgb.data(),
+					&xyz_batch[n * 3]);
+		}
+	});
+	TEST_ASSERT(batch.has_value());
+
+	/* The gains round once instead of at every step. */
+	for (size_t i = 0; i < xyz_batch.size(); i++)
+		TEST_NEAR(xyz_scalar[i], xyz_batch[i], 2, "%d");
+
+	benchmark.print_results();
+	BenchmarkResult::compare(scalar.value(), batch.value());
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+	init_samples();
+	RUN_TEST(test_intv3_moments);
+	RUN_TEST(test_kasa_accumulate);
+	RUN_TEST(test_mag_cal_update);
+	RUN_TEST(test_window_stats);
+	RUN_TEST(test_still_det);
+	RUN_TEST(test_als_crgb_to_xyz);
+	test_print_result();
+}
@@ -0,0 +1,406 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Replay the recorded traces of the body detection and lid angle tests, and
+ * any trace listed in SENSOR_REPLAY_TRACE, through the motion sense
+ * algorithms.
+ *
+ * To replay field data, see sensor_replay_engine.h for the formats:
+ *   make run-sensor_replay
+ *   SENSOR_REPLAY_TRACE=a.csv:b.bin util/run_host_test -v sensor_replay
+ */
+
+#include "accelgyro.h"
+#include "body_detection.h"
+#include "body_detection_test_data.h"
+#include "common.h"
+#include "driver/accelgyro_bmi_common.h"
+#include "gpio.h"
+#include "motion_common.h"
+#include "motion_lid.h"
+#include "motion_sense.h"
+#include "sensor_replay_engine.h"
+#include "tablet_mode.h"
+#include "test_util.h"
+#include "util.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Recorded rates of the traces. */
+#define BODY_TRACE_PERIOD_US (20 * MSEC)
+#define LID_TRACE_PERIOD_US (10 * MSEC)
+
+mutex_t g_sensor_mutex;
+
+static int test_data_rate[SENSOR_COUNT];
+
+static int replay_set_data_rate(const struct motion_sensor_t *s,
+				const int rate, const int rnd)
+{
+	test_data_rate[s - motion_sensors] = rate;
+	return EC_SUCCESS;
+}
+
+static int replay_get_data_rate(const struct motion_sensor_t *s)
+{
+	return test_data_rate[s - motion_sensors];
+}
+
+static int replay_get_rms_noise(const struct motion_sensor_t *s)
+{
+	/* Assume we are using BMI160, as test/body_detection.c does. */
+	fp_t rate = INT_TO_FP(replay_get_data_rate(s) / 1000);
+	fp_t noise_100hz = INT_TO_FP(BMI160_ACCEL_RMS_NOISE_100HZ);
+	fp_t sqrt_rate_ratio =
+		fp_sqrtf(fp_div(rate, INT_TO_FP(BMI_ACCEL_100HZ)));
+
+	return FP_TO_INT(fp_mul(noise_100hz, sqrt_rate_ratio));
+}
+
+static const struct accelgyro_drv replay_drv = {
+	.set_data_rate = replay_set_data_rate,
+	.get_data_rate = replay_get_data_rate,
+	.get_rms_noise = replay_get_rms_noise,
+};
+
+struct motion_sensor_t motion_sensors[] = {
+	[BASE] = {
+		.name = "base",
+		.type = MOTIONSENSE_TYPE_ACCEL,
+		.location = MOTIONSENSE_LOC_BASE,
+		.drv = &replay_drv,
+		.default_range = 2,
+		.current_range = 2,
+		.oversampling_ratio = 1,
+	},
+	[LID] = {
+		.name = "lid",
+		.type = MOTIONSENSE_TYPE_ACCEL,
+		.location = MOTIONSENSE_LOC_LID,
+		.drv = &replay_drv,
+		.default_range = 2,
+		.current_range = 2,
+		.oversampling_ratio = 1,
+	},
+	[MAG] = {
+		.name = "mag",
+		.type = MOTIONSENSE_TYPE_MAG,
+		.location = MOTIONSENSE_LOC_LID,
+		.drv = &replay_drv,
+		.oversampling_ratio = 1,
+	},
+};
+const unsigned int motion_sensor_count = ARRAY_SIZE(motion_sensors);
+
+/* Normally provided by the motion sense task, which does not run here. */
+enum sensor_config motion_sense_get_ec_config(void)
+{
+	return SENSOR_CONFIG_EC_S0;
+}
+
+int sensor_board_is_lid_angle_available(void)
+{
+	return 1;
+}
+
+/* Traces converted to sensor counts. */
+static struct sensor_replay_sample samples[8192];
+
+static int from_ms2(const struct motion_sensor_t *s, float v)
+{
+	int data_1g = MOTION_SCALING_FACTOR / s->current_range;
+
+	return (int)(v * data_1g / MOTION_ONE_G);
+}
+
+static int from_g(const struct motion_sensor_t *s, float v)
+{
+	return (int)(v * MOTION_SCALING_FACTOR / s->current_range);
+}
+
+/* Body detection traces, with a mark at the start of the action. */
+static size_t load_body_trace(const struct body_detect_test_data *data,
+			      size_t length)
+{
+	const struct motion_sensor_t *s = &motion_sensors[BASE];
+	bool marked = false;
+	size_t i;
+
+	for (i = 0; i < length && i < ARRAY_SIZE(samples); i++) {
+		samples[i].timestamp = i * BODY_TRACE_PERIOD_US;
+		samples[i].sensor = BASE;
+		samples[i].flags = 0;
+		if (data[i].action && !marked) {
+			samples[i].flags = SENSOR_REPLAY_MARK;
+			marked = true;
+		}
+		samples[i].v[X] = from_ms2(s, data[i].x);
+		samples[i].v[Y] = from_ms2(s, data[i].y);
+		samples[i].v[Z] = from_ms2(s, data[i].z);
+	}
+	return i;
+}
+
+/* Lid angle traces: base then lid vectors, in g, marked at the start. */
+static size_t load_lid_trace(const float *data, size_t length)
+{
+	size_t n = 0;
+	size_t i;
+	int j;
+
+	for (i = 0; i + TEST_LID_SAMPLE_SIZE <= length &&
+		    n + 2 <= ARRAY_SIZE(samples);
+	     i += TEST_LID_SAMPLE_SIZE) {
+		for (j = 0; j < 2; j++, n++) {
+			int id = j ? LID : BASE;
+			const float *v = &data[i + 3 * j];
+
+			samples[n].timestamp = i / TEST_LID_SAMPLE_SIZE *
+					       LID_TRACE_PERIOD_US;
+			samples[n].sensor = id;
+			samples[n].flags = n ? 0 : SENSOR_REPLAY_MARK;
+			samples[n].v[X] = from_g(&motion_sensors[id], v[X]);
+			samples[n].v[Y] = from_g(&motion_sensors[id], v[Y]);
+			samples[n].v[Z] = from_g(&motion_sensors[id], v[Z]);
+		}
+	}
+	return n;
+}
+
+static int replay_samples(const char *name, size_t n,
+			  struct sensor_replay_stats *stats)
+{
+	struct sensor_replay_source src = {
+		.samples = samples,
+		.count = n,
+	};
+	int rv;
+
+	sensor_replay_reset();
+	rv = sensor_replay_run(&src, stats);
+	sensor_replay_print(name, stats);
+	return rv;
+}
+
+static void setup_body_detect(void)
+{
+	struct motion_sensor_t *s = &motion_sensors[BASE];
+
+	/* The body detection traces are recorded at 50Hz. */
+	s->drv->set_data_rate(s, SECOND / BODY_TRACE_PERIOD_US * 1000, 0);
+	body_detect_set_enable(true);
+}
+
+test_static int test_replay_body_detect(void)
+{
+	struct sensor_replay_stats stats;
+	size_t n;
+
+	setup_body_detect();
+
+	n = load_body_trace(kBodyDetectOnBodyTestData,
+			    kBodyDetectOnBodyTestDataLength);
+	TEST_EQ(replay_samples("on_body", n, &stats), EC_SUCCESS, "%d");
+	TEST_EQ(stats.samples, (uint32_t)n, "%u");
+	/* Goes on body, and never back off body. */
+	TEST_LE(stats.decisions[SENSOR_REPLAY_BODY_DETECT], 1, "%u");
+	TEST_EQ(body_detect_get_state(), BODY_DETECTION_ON_BODY, "%d");
+
+	n = load_body_trace(kBodyDetectOffOnTestData,
+			    kBodyDetectOffOnTestDataLength);
+	TEST_EQ(replay_samples("off_on", n, &stats), EC_SUCCESS, "%d");
+	TEST_GE(stats.latency_us[SENSOR_REPLAY_BODY_DETECT], (int64_t)0,
+		"%" PRId64);
+	TEST_LT(stats.latency_us[SENSOR_REPLAY_BODY_DETECT],
+		(int64_t)(3 * SECOND), "%" PRId64);
+
+	n = load_body_trace(kBodyDetectOnOffTestData,
+			    kBodyDetectOnOffTestDataLength);
+	TEST_EQ(replay_samples("on_off", n, &stats), EC_SUCCESS, "%d");
+	TEST_EQ(body_detect_get_state(), BODY_DETECTION_OFF_BODY, "%d");
+	TEST_GE(stats.latency_us[SENSOR_REPLAY_BODY_DETECT],
+		(int64_t)(15 * SECOND), "%" PRId64);
+	TEST_LT(stats.latency_us[SENSOR_REPLAY_BODY_DETECT],
+		(int64_t)(20 * SECOND), "%" PRId64);
+
+	/* A minute of data takes far less than a minute to replay. */
+	TEST_GE(stats.sim_us, (uint64_t)(60 * SECOND), "%" PRIu64);
+	TEST_GE(stats.sim_us * 1000 / MAX(stats.wall_ns, 1), (uint64_t)10,
+		"%" PRIu64);
+	TEST_GT(stats.fifo_entries, 0, "%u");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_replay_lid_angle(void)
+{
+	struct sensor_replay_stats stats;
+	size_t n;
+
+	/* Open the lid, and let the lid switch debounce. */
+	gpio_set_level(GPIO_LID_OPEN, 1);
+	crec_msleep(1000);
+
+	n = load_lid_trace(kAccelerometerVerticalHingeTestData,
+			   kAccelerometerVerticalHingeTestDataLength);
+	TEST_EQ(replay_samples("vertical_hinge", n, &stats), EC_SUCCESS,
+		"%d");
+
+	/*
+	 * The hinge starts vertical, so the first angles are unreliable: once
+	 * in tablet mode, the device must stay there.
+	 */
+	TEST_EQ(stats.decisions[SENSOR_REPLAY_TABLET_MODE], 1, "%u");
+	TEST_EQ(tablet_get_mode(), 1, "%d");
+	TEST_GT(stats.latency_us[SENSOR_REPLAY_TABLET_MODE], (int64_t)0,
+		"%" PRId64);
+	TEST_LT(stats.latency_us[SENSOR_REPLAY_TABLET_MODE],
+		(int64_t)stats.sim_us, "%" PRId64);
+
+	return EC_SUCCESS;
+}
+
+/* The body detection trace, then magnetometer samples around a sphere. */
+static size_t load_mixed_trace(void)
+{
+	size_t n = load_body_trace(kBodyDetectOnOffTestData,
+				   kBodyDetectOnOffTestDataLength);
+	size_t i;
+
+	for (i = 0; i < n && n + i < ARRAY_SIZE(samples); i++) {
+		struct sensor_replay_sample *s = &samples[n + i];
+		int noise = (int)(i * 7 % 11) - 5;
+
+		s->timestamp = samples[n - 1].timestamp +
+			       (i + 1) * BODY_TRACE_PERIOD_US;
+		s->sensor = MAG;
+		s->flags = i ? 0 : SENSOR_REPLAY_MARK;
+		s->v[X] = noise;
+		s->v[Y] = -noise;
+		s->v[Z] = 3;
+		s->v[i % 6 / 2] += i % 2 ? -525 : 525;
+	}
+	return n + i;
+}
+
+static int replay_file(const char *path, struct sensor_replay_stats *stats)
+{
+	struct sensor_replay_source src;
+	int rv;
+
+	rv = sensor_replay_open(&src, path);
+	if (rv)
+		return rv;
+	sensor_replay_reset();
+	rv = sensor_replay_run(&src, stats);
+	sensor_replay_close(&src);
+	sensor_replay_print(path, stats);
+	return rv;
+}
+
+static int write_trace(char *path, int suffix_len, size_t n)
+{
+	bool csv = suffix_len > 0;
+	int fd = mkstemps(path, suffix_len);
+	FILE *file;
+	size_t i;
+
+	if (fd < 0)
+		return EC_ERROR_UNKNOWN;
+	file = fdopen(fd, "w");
+	if (!file)
+		return EC_ERROR_UNKNOWN;
+	if (csv)
+		fprintf(file, "# timestamp_us,sensor,x,y,z,mark\n");
+	for (i = 0; i < n; i++)
+		if (sensor_replay_write(file, csv, &samples[i]))
+			break;
+	fclose(file);
+	return i == n ? EC_SUCCESS : EC_ERROR_UNKNOWN;
+}
+
+test_static int test_replay_files(void)
+{
+	char csv_path[] = "/tmp/sensor_replay_XXXXXX.csv";
+	char bin_path[] = "/tmp/sensor_replay_XXXXXX";
+	struct sensor_replay_stats ref, csv, bin;
+	size_t n;
+	int i;
+
+	setup_body_detect();
+	n = load_mixed_trace();
+	TEST_EQ(replay_samples("mixed", n, &ref), EC_SUCCESS, "%d");
+	TEST_EQ(ref.decisions[SENSOR_REPLAY_MAG_BIAS],
+		(uint32_t)((n / 2) / MAG_CAL_MIN_BATCH_SIZE), "%u");
+	TEST_GE(ref.latency_us[SENSOR_REPLAY_MAG_BIAS], (int64_t)0, "%" PRId64);
+
+	TEST_EQ(write_trace(csv_path, 4, n), EC_SUCCESS, "%d");
+	TEST_EQ(write_trace(bin_path, 0, n), EC_SUCCESS, "%d");
+
+	/* Files give the same decisions as the in memory trace. */
+	TEST_EQ(replay_file(csv_path, &csv), EC_SUCCESS, "%d");
+	TEST_EQ(replay_file(bin_path, &bin), EC_SUCCESS, "%d");
+	for (i = 0; i < SENSOR_REPLAY_DECISION_COUNT; i++) {
+		TEST_EQ(csv.decisions[i], ref.decisions[i], "%u");
+		TEST_EQ(bin.decisions[i], ref.decisions[i], "%u");
+		TEST_EQ(csv.latency_us[i], ref.latency_us[i], "%" PRId64);
+		TEST_EQ(bin.latency_us[i], ref.latency_us[i], "%" PRId64);
+	}
+	TEST_EQ(csv.fifo_entries, ref.fifo_entries, "%u");
+	TEST_EQ(bin.fifo_entries, ref.fifo_entries, "%u");
+
+	/* Missing files and unknown sensors are errors. */
+	unlink(bin_path);
+	unlink(csv_path);
+	TEST_EQ(replay_file(bin_path, &bin), EC_ERROR_INVAL, "%d");
+	strcpy(csv_path, "/tmp/sensor_replay_XXXXXX.csv");
+	samples[0].sensor = SENSOR_COUNT;
+	TEST_EQ(write_trace(csv_path, 4, 1), EC_SUCCESS, "%d");
+	TEST_EQ(replay_file(csv_path, &csv), EC_ERROR_INVAL, "%d");
+	unlink(csv_path);
+
+	return EC_SUCCESS;
+}
+
+/* Replay the traces listed in SENSOR_REPLAY_TRACE, ':' separated. */
+test_static int test_replay_env(void)
+{
+	const char *env = getenv("SENSOR_REPLAY_TRACE");
+	struct sensor_replay_source src;
+	struct sensor_replay_stats stats;
+	char *paths, *path, *save;
+
+	if (!env)
+		return EC_SUCCESS;
+
+	setup_body_detect();
+	paths = strdup(env);
+	TEST_ASSERT(paths);
+	for (path = strtok_r(paths, ":", &save); path;
+	     path = strtok_r(NULL, ":", &save)) {
+		TEST_EQ(sensor_replay_open(&src, path), EC_SUCCESS, "%d");
+		sensor_replay_reset();
+		TEST_EQ(sensor_replay_run(&src, &stats), EC_SUCCESS, "%d");
+		sensor_replay_close(&src);
+		sensor_replay_print(path, &stats);
+	}
+	free(paths);
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+
+	RUN_TEST(test_replay_body_detect);
+	RUN_TEST(test_replay_lid_angle);
+	RUN_TEST(test_replay_files);
+	RUN_TEST(test_replay_env);
+
+	test_print_result();
+}
@@ -0,0 +1,311 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Host side replay of recorded sensor traces through the motion sense
+ * algorithms, faster than real time.
+ */
+
+#include "body_detection.h"
+#include "console.h"
+#include "mag_cal.h"
+#include "motion_lid.h"
+#include "motion_sense.h"
+#include "motion_sense_fifo.h"
+#include "sensor_replay_engine.h"
+#include "tablet_mode.h"
+#include "util.h"
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static struct mag_cal_t replay_mag_cal = {
+	.batch_size = MAG_CAL_MIN_BATCH_SIZE,
+};
+
+static struct ec_response_motion_sensor_data
+	fifo_out[CONFIG_ACCEL_FIFO_SIZE];
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int sensor_replay_open(struct sensor_replay_source *src, const char *path)
+{
+	const char *ext = strrchr(path, '.');
+	struct sensor_replay_header header;
+
+	memset(src, 0, sizeof(*src));
+	src->binary = !ext || strcasecmp(ext, ".csv");
+	src->file = fopen(path, src->binary ? "rb" : "r");
+	if (!src->file)
+		return EC_ERROR_INVAL;
+
+	if (src->binary &&
+	    (fread(&header, sizeof(header), 1, src->file) != 1 ||
+	     header.magic != SENSOR_REPLAY_MAGIC ||
+	     header.version != SENSOR_REPLAY_VERSION)) {
+		sensor_replay_close(src);
+		return EC_ERROR_INVAL;
+	}
+	return EC_SUCCESS;
+}
+
+void sensor_replay_close(struct sensor_replay_source *src)
+{
+	if (src->file)
+		fclose(src->file);
+	src->file = NULL;
+}
+
+static int next_csv(struct sensor_replay_source *src,
+		    struct sensor_replay_sample *sample)
+{
+	char line[128];
+	uint64_t timestamp;
+	int sensor, x, y, z, mark = 0;
+	int n;
+
+	while (fgets(line, sizeof(line), src->file)) {
+		src->line++;
+		if (line[0] == '#' || line[strspn(line, " \t\r\n")] == '\0')
+			continue;
+
+		n = sscanf(line, "%" SCNu64 ",%d,%d,%d,%d,%d", &timestamp,
+			   &sensor, &x, &y, &z, &mark);
+		if (n < 5 || sensor < 0 || sensor >= motion_sensor_count)
+			return -1;
+
+		sample->timestamp = timestamp;
+		sample->sensor = sensor;
+		sample->flags = mark ? SENSOR_REPLAY_MARK : 0;
+		sample->v[X] = x;
+		sample->v[Y] = y;
+		sample->v[Z] = z;
+		return 1;
+	}
+	return 0;
+}
+
+static int next_binary(struct sensor_replay_source *src,
+		       struct sensor_replay_sample *sample)
+{
+	struct sensor_replay_record record;
+	int i;
+
+	if (fread(&record, sizeof(record), 1, src->file) != 1)
+		return feof(src->file) ? 0 : -1;
+	if (record.sensor >= motion_sensor_count)
+		return -1;
+
+	sample->timestamp = record.timestamp;
+	sample->sensor = record.sensor;
+	sample->flags = record.flags;
+	for (i = X; i <= Z; i++)
+		sample->v[i] = record.data[i];
+	return 1;
+}
+
+int sensor_replay_next(struct sensor_replay_source *src,
+		       struct sensor_replay_sample *sample)
+{
+	if (!src->file) {
+		if (src->index >= src->count)
+			return 0;
+		*sample = src->samples[src->index++];
+		return 1;
+	}
+	return src->binary ? next_binary(src, sample) : next_csv(src, sample);
+}
+
+int sensor_replay_write(FILE *file, bool csv,
+			const struct sensor_replay_sample *sample)
+{
+	struct sensor_replay_header header = {
+		.magic = SENSOR_REPLAY_MAGIC,
+		.version = SENSOR_REPLAY_VERSION,
+	};
+	struct sensor_replay_record record;
+	int i;
+
+	if (csv)
+		return fprintf(file, "%" PRIu64 ",%d,%d,%d,%d,%d\n",
+			       sample->timestamp, sample->sensor,
+			       sample->v[X], sample->v[Y], sample->v[Z],
+			       !!(sample->flags & SENSOR_REPLAY_MARK)) < 0 ?
+			       EC_ERROR_UNKNOWN :
+			       EC_SUCCESS;
+
+	if (ftell(file) == 0 && fwrite(&header, sizeof(header), 1, file) != 1)
+		return EC_ERROR_UNKNOWN;
+
+	record.timestamp = sample->timestamp;
+	record.sensor = sample->sensor;
+	record.flags = sample->flags;
+	for (i = X; i <= Z; i++)
+		record.data[i] = sample->v[i];
+	return fwrite(&record, sizeof(record), 1, file) == 1 ?
+		       EC_SUCCESS :
+		       EC_ERROR_UNKNOWN;
+}
+
+/* Read the FIFO back once it reaches the AP wake up threshold. */
+static void drain_fifo(struct sensor_replay_stats *stats)
+{
+	uint16_t bytes;
+
+	if (!motion_sense_fifo_over_thres())
+		return;
+	stats->fifo_entries += motion_sense_fifo_read(
+		sizeof(fifo_out), ARRAY_SIZE(fifo_out), fifo_out, &bytes);
+}
+
+static void push_fifo(const struct sensor_replay_sample *sample)
+{
+	struct ec_response_motion_sensor_data vector = {
+		.flags = 0,
+		.sensor_num = sample->sensor,
+	};
+	int i;
+
+	for (i = X; i <= Z; i++)
+		vector.data[i] = sample->v[i];
+	motion_sense_fifo_stage_data(&vector, &motion_sensors[sample->sensor],
+				     3, sample->timestamp);
+	motion_sense_fifo_commit_data();
+}
+
+static void decide(struct sensor_replay_stats *stats,
+		   enum sensor_replay_decision decision, uint64_t timestamp,
+		   uint64_t *mark)
+{
+	stats->decisions[decision]++;
+	if (mark[decision] != UINT64_MAX) {
+		stats->latency_us[decision] = timestamp - mark[decision];
+		mark[decision] = UINT64_MAX;
+	}
+}
+
+void sensor_replay_reset(void)
+{
+	uint16_t bytes;
+
+	init_mag_cal(&replay_mag_cal);
+	body_detect_reset();
+	body_detect_change_state(BODY_DETECTION_OFF_BODY, false);
+	tablet_set_mode(0, TABLET_TRIGGER_LID);
+	while (motion_sense_fifo_read(sizeof(fifo_out), ARRAY_SIZE(fifo_out),
+				      fifo_out, &bytes))
+		;
+}
+
+int sensor_replay_run(struct sensor_replay_source *src,
+		      struct sensor_replay_stats *stats)
+{
+	struct sensor_replay_sample sample;
+	/* Time of the pending mark for each decision, UINT64_MAX if none. */
+	uint64_t mark[SENSOR_REPLAY_DECISION_COUNT];
+	uint32_t lid_updated = 0;
+	uint64_t first = 0;
+	uint64_t begin = now_ns();
+	int tablet, body;
+	int i, rv;
+
+	memset(stats, 0, sizeof(*stats));
+	for (i = 0; i < SENSOR_REPLAY_DECISION_COUNT; i++) {
+		stats->latency_us[i] = -1;
+		mark[i] = UINT64_MAX;
+	}
+	tablet = tablet_get_mode();
+	body = body_detect_get_state();
+
+	while ((rv = sensor_replay_next(src, &sample)) > 0) {
+		struct motion_sensor_t *s = &motion_sensors[sample.sensor];
+		uint64_t start = now_ns();
+		uint64_t elapsed;
+
+		if (stats->samples++ == 0)
+			first = sample.timestamp;
+		stats->sim_us = sample.timestamp - first;
+		if (sample.flags & SENSOR_REPLAY_MARK)
+			for (i = 0; i < SENSOR_REPLAY_DECISION_COUNT; i++)
+				mark[i] = sample.timestamp;
+
+		memcpy(s->xyz, sample.v, sizeof(intv3_t));
+		push_fifo(&sample);
+
+		/* The lid angle needs a fresh vector from both sensors. */
+		if (sample.sensor == CONFIG_LID_ANGLE_SENSOR_BASE ||
+		    sample.sensor == CONFIG_LID_ANGLE_SENSOR_LID) {
+			lid_updated |= BIT(sample.sensor);
+			if (lid_updated ==
+			    (BIT(CONFIG_LID_ANGLE_SENSOR_BASE) |
+			     BIT(CONFIG_LID_ANGLE_SENSOR_LID))) {
+				lid_updated = 0;
+				motion_lid_calc();
+			}
+		}
+		if (sample.sensor == CONFIG_BODY_DETECTION_SENSOR)
+			body_detect();
+		if (s->type == MOTIONSENSE_TYPE_MAG &&
+		    mag_cal_update(&replay_mag_cal, sample.v))
+			decide(stats, SENSOR_REPLAY_MAG_BIAS, sample.timestamp,
+			       mark);
+
+		if (tablet_get_mode() != tablet) {
+			tablet = !tablet;
+			decide(stats, SENSOR_REPLAY_TABLET_MODE,
+			       sample.timestamp, mark);
+		}
+		if (body_detect_get_state() != body) {
+			body = body_detect_get_state();
+			decide(stats, SENSOR_REPLAY_BODY_DETECT,
+			       sample.timestamp, mark);
+		}
+		drain_fifo(stats);
+
+		elapsed = now_ns() - start;
+		stats->max_sample_ns = MAX(stats->max_sample_ns, elapsed);
+	}
+	/* Parsing counts too, it is part of replaying hours of data. */
+	stats->wall_ns = now_ns() - begin;
+
+	if (rv < 0) {
+		ccprintf("replay: malformed sample %u (line %u)\n",
+			 stats->samples, src->line);
+		return EC_ERROR_INVAL;
+	}
+	return EC_SUCCESS;
+}
+
+void sensor_replay_print(const char *name,
+			 const struct sensor_replay_stats *stats)
+{
+	static const char *const decision_names[] = {
+		[SENSOR_REPLAY_TABLET_MODE] = "tablet_mode",
+		[SENSOR_REPLAY_BODY_DETECT] = "body_detect",
+		[SENSOR_REPLAY_MAG_BIAS] = "mag_bias",
+	};
+	uint64_t wall_us = MAX(stats->wall_ns / 1000, 1);
+	int i;
+
+	BUILD_ASSERT(ARRAY_SIZE(decision_names) ==
+		     SENSOR_REPLAY_DECISION_COUNT);
+
+	ccprintf("REPLAY name=%s samples=%u fifo_entries=%u sim_us=%" PRIu64
+		 " wall_us=%" PRIu64 " samples_per_s=%" PRIu64
+		 " speedup=%" PRIu64 " max_sample_ns=%" PRIu64 "\n",
+		 name, stats->samples, stats->fifo_entries, stats->sim_us,
+		 wall_us, stats->samples * (uint64_t)1000000 / wall_us,
+		 stats->sim_us / wall_us, stats->max_sample_ns);
+	for (i = 0; i < SENSOR_REPLAY_DECISION_COUNT; i++)
+		ccprintf("  %-12s decisions=%u latency_us=%" PRId64 "\n",
+			 decision_names[i], stats->decisions[i],
+			 stats->latency_us[i]);
+}
@@ -0,0 +1,153 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Host side replay of recorded sensor traces through the motion sense
+ * algorithms, faster than real time.
+ */
+#ifndef __CROS_EC_SENSOR_REPLAY_ENGINE_H
+#define __CROS_EC_SENSOR_REPLAY_ENGINE_H
+
+#include "common.h"
+#include "math_util.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Trace formats
+ *
+ * CSV: one sample per line, "timestamp_us,sensor,x,y,z[,mark]". Empty lines
+ * and lines starting with '#' are skipped. sensor is the index in
+ * motion_sensors[], x/y/z are in sensor counts, already in the standard
+ * reference frame. A non-zero mark flags the sample as a SENSOR_REPLAY_MARK.
+ *
+ * Binary: a struct sensor_replay_header followed by struct
+ * sensor_replay_record until the end of the file, little endian.
+ */
+#define SENSOR_REPLAY_MAGIC 0x52534345 /* "ECSR" */
+#define SENSOR_REPLAY_VERSION 1
+
+struct sensor_replay_header {
+	uint32_t magic;
+	uint32_t version;
+} __packed;
+
+struct sensor_replay_record {
+	uint64_t timestamp;
+	uint8_t sensor;
+	uint8_t flags;
+	int16_t data[3];
+} __packed;
+
+/*
+ * The sample is a ground truth event, for instance the start of the action in
+ * a labelled trace. Decision latencies are measured from the last mark.
+ */
+#define SENSOR_REPLAY_MARK BIT(0)
+
+struct sensor_replay_sample {
+	/* Simulated time, in us. */
+	uint64_t timestamp;
+	uint8_t sensor;
+	uint8_t flags;
+	intv3_t v;
+};
+
+/* Decisions the algorithms make on the replayed data. */
+enum sensor_replay_decision {
+	SENSOR_REPLAY_TABLET_MODE,
+	SENSOR_REPLAY_BODY_DETECT,
+	SENSOR_REPLAY_MAG_BIAS,
+	SENSOR_REPLAY_DECISION_COUNT,
+};
+
+struct sensor_replay_stats {
+	uint32_t samples;
+	/* Entries read back from the FIFO, as the AP would. */
+	uint32_t fifo_entries;
+	/* Simulated duration of the trace, in us. */
+	uint64_t sim_us;
+	/* Time spent replaying, parsing included, in ns. */
+	uint64_t wall_ns;
+	/* Slowest single sample through the algorithms, in ns. */
+	uint64_t max_sample_ns;
+
+	uint32_t decisions[SENSOR_REPLAY_DECISION_COUNT];
+	/*
+	 * Simulated time from the last mark to the first decision after it,
+	 * in us, -1 if there was none.
+	 */
+	int64_t latency_us[SENSOR_REPLAY_DECISION_COUNT];
+};
+
+/* Where samples come from: a file or an array. */
+struct sensor_replay_source {
+	FILE *file;
+	bool binary;
+	uint32_t line;
+
+	const struct sensor_replay_sample *samples;
+	size_t count;
+	size_t index;
+};
+
+/**
+ * Open a trace file, the format is picked from the ".csv" extension.
+ *
+ * @param src Source to initialize.
+ * @param path Path of the trace.
+ * @return EC_SUCCESS, or an error if the file can not be read.
+ */
+int sensor_replay_open(struct sensor_replay_source *src, const char *path);
+
+/**
+ * Close a trace opened with sensor_replay_open().
+ */
+void sensor_replay_close(struct sensor_replay_source *src);
+
+/**
+ * Read the next sample from a source.
+ *
+ * @return 1 if a sample was read, 0 at the end of the trace, -1 on a
+ *         malformed sample.
+ */
+int sensor_replay_next(struct sensor_replay_source *src,
+		       struct sensor_replay_sample *sample);
+
+/**
+ * Write a sample, in CSV when csv is set or in binary otherwise.
+ *
+ * The binary header is written before the first sample of an empty file.
+ *
+ * @return EC_SUCCESS or EC_ERROR_UNKNOWN on a write error.
+ */
+int sensor_replay_write(FILE *file, bool csv,
+			const struct sensor_replay_sample *sample);
+
+/**
+ * Put the algorithms back in their initial state: clamshell, off body, no
+ * magnetometer calibration in progress and an empty FIFO.
+ */
+void sensor_replay_reset(void);
+
+/**
+ * Stream a whole source through the FIFO, lid angle, tablet mode, body
+ * detection and magnetometer calibration.
+ *
+ * The algorithm state is not reset, so that traces can be chained.
+ *
+ * @param src Source of the samples.
+ * @param stats Where to accumulate the statistics, cleared first.
+ * @return EC_SUCCESS or EC_ERROR_INVAL on a malformed trace.
+ */
+int sensor_replay_run(struct sensor_replay_source *src,
+		      struct sensor_replay_stats *stats);
+
+/**
+ * Print throughput and decision latencies.
+ */
+void sensor_replay_print(const char *name,
+			 const struct sensor_replay_stats *stats);
+
+#endif /* __CROS_EC_SENSOR_REPLAY_ENGINE_H */
@@ -16,9 +16,6 @@
 #include <stdint.h>
 #endif
 
-/* Host commands are sorted. */
-#define CONFIG_HOSTCMD_SECTION_SORTED
-
 /* Don't compile features unless specifically testing for them */
 #undef CONFIG_VBOOT_HASH
 
@@ -63,6 +60,19 @@ enum battery_type {
 #define CONFIG_EEPROM_CBI_WP
 #endif
 
+#ifdef TEST_HOOKS
+#define CONFIG_HOOK_DEBUG
+#endif
+
+#ifdef TEST_HOOKS_TICKLESS
+#define CONFIG_HOOK_DEBUG
+#define CONFIG_HOOK_TICKLESS
+#endif
+
+#ifdef TEST_HOST_COMMAND
+#define CONFIG_HOSTCMD_BATCH
+#endif
+
 #ifdef TEST_KB_8042
 #define CONFIG_KEYBOARD_PROTOCOL_8042
 #define CONFIG_8042_AUX
@@ -97,7 +107,7 @@ enum battery_type {
 #define CONFIG_MAG_CALIBRATE
 #endif
 
-#ifdef TEST_FP
+#if defined(TEST_FP) || defined(TEST_FP_DSP)
 #undef CONFIG_FPU
 #define CONFIG_MAG_CALIBRATE
 #endif
@@ -145,6 +155,7 @@ enum battery_type {
 #define CONFIG_ACCEL_FIFO
 #define CONFIG_ACCEL_FIFO_SIZE 256
 #define CONFIG_ACCEL_FIFO_THRES 10
+#define CONFIG_ACCEL_TRACE
 #endif
 
 #ifdef TEST_KASA
@@ -164,10 +175,11 @@ enum battery_type {
 #define GPIO_NVIDIA_GPU_ACOFF_ODL 123
 #endif
 
-#if defined(TEST_BODY_DETECTION) || defined(TEST_KASA) ||                \
-	defined(TEST_BODY_DETECTION) || defined(TEST_MOTION_ANGLE) ||    \
-	defined(TEST_MOTION_ANGLE_TABLET) || defined(TEST_MOTION_LID) || \
-	defined(TEST_MOTION_SENSE_FIFO) || defined(TEST_TABLET_BROKEN_SENSOR)
+#if defined(TEST_BODY_DETECTION) || defined(TEST_KASA) ||                   \
+	defined(TEST_BODY_DETECTION) || defined(TEST_MOTION_ANGLE) ||       \
+	defined(TEST_MOTION_ANGLE_TABLET) || defined(TEST_MOTION_LID) ||    \
+	defined(TEST_MOTION_LID_ATAN) || defined(TEST_MOTION_SENSE_FIFO) || \
+	defined(TEST_TABLET_BROKEN_SENSOR)
 enum sensor_id {
 	BASE,
 	LID,
@@ -175,7 +187,8 @@ enum sensor_id {
 };
 
 #if defined(TEST_MOTION_ANGLE) || defined(TEST_MOTION_ANGLE_TABLET) || \
-	defined(TEST_MOTION_LID) || defined(TEST_TABLET_BROKEN_SENSOR)
+	defined(TEST_MOTION_LID) || defined(TEST_MOTION_LID_ATAN) ||     \
+	defined(TEST_TABLET_BROKEN_SENSOR)
 #define CONFIG_LID_ANGLE
 #define CONFIG_LID_ANGLE_SENSOR_BASE BASE
 #define CONFIG_LID_ANGLE_SENSOR_LID LID
@@ -193,14 +206,19 @@ enum sensor_id {
 #define CONFIG_ACCEL_STD_REF_FRAME_OLD
 #endif
 
-#if defined(TEST_MOTION_ANGLE_TABLET) || defined(TEST_MOTION_LID)
+#if defined(TEST_MOTION_ANGLE_TABLET) || defined(TEST_MOTION_LID) || \
+	defined(TEST_MOTION_LID_ATAN)
 #define CONFIG_ACCEL_FORCE_MODE_MASK           \
 	((1 << CONFIG_LID_ANGLE_SENSOR_BASE) | \
 	 (1 << CONFIG_LID_ANGLE_SENSOR_LID))
 #endif
 
+#ifdef TEST_MOTION_LID_ATAN
+#define CONFIG_LID_ANGLE_ATAN_TABLE
+#endif
+
 #if defined(TEST_TABLET_BROKEN_SENSOR) || defined(TEST_TABLET_NO_SENSOR) || \
-	defined(TEST_MOTION_LID)
+	defined(TEST_MOTION_LID) || defined(TEST_MOTION_LID_ATAN)
 #define CONFIG_TABLET_MODE
 #define CONFIG_GMR_TABLET_MODE
 #endif
@@ -214,11 +232,33 @@ enum sensor_id {
 #define CONFIG_BODY_DETECTION_SENSOR BASE
 #endif
 
+#ifdef TEST_CORE_KERNELS_BENCHMARK
+#define CONFIG_CRC8_CROS
+#define CONFIG_SW_CRC
+#undef CONFIG_SW_CRC_SLICES
+#define CONFIG_SW_CRC_SLICES 8
+#define CONFIG_CURVE25519
+#define CONFIG_RSA
+#define CONFIG_RWSIG_TYPE_RWSIG
+#define CONFIG_SHA256_SW
+#endif
+
 #ifdef TEST_CRC
 #define CONFIG_CRC8_CROS
 #define CONFIG_SW_CRC
 #endif
 
+#if defined(TEST_CRC_SLICE4) || defined(TEST_CRC_SLICE8)
+#define CONFIG_CRC8_CROS
+#define CONFIG_SW_CRC
+#undef CONFIG_SW_CRC_SLICES
+#ifdef TEST_CRC_SLICE4
+#define CONFIG_SW_CRC_SLICES 4
+#else
+#define CONFIG_SW_CRC_SLICES 8
+#endif
+#endif
+
 #ifdef TEST_RSA
 #define CONFIG_RSA
 #ifdef CONFIG_RSA_EXPONENT_3
@@ -233,6 +273,32 @@ enum sensor_id {
 #define CONFIG_RWSIG_TYPE_RWSIG
 #endif
 
+#ifdef TEST_SENSOR_MATH_BENCHMARK
+#define CONFIG_ALS_PROCESS
+#define CONFIG_FPU
+#define CONFIG_MAG_CALIBRATE
+#define CONFIG_STILLNESS_DETECTOR
+#endif
+
+#ifdef TEST_SENSOR_REPLAY
+enum sensor_id {
+	BASE,
+	LID,
+	MAG,
+	SENSOR_COUNT,
+};
+#define CONFIG_ACCEL_FIFO
+#define CONFIG_ACCEL_FIFO_SIZE 256
+#define CONFIG_ACCEL_FIFO_THRES 10
+#define CONFIG_BODY_DETECTION
+#define CONFIG_BODY_DETECTION_SENSOR BASE
+#define CONFIG_LID_ANGLE
+#define CONFIG_LID_ANGLE_SENSOR_BASE BASE
+#define CONFIG_LID_ANGLE_SENSOR_LID LID
+#define CONFIG_MAG_CALIBRATE
+#define CONFIG_TABLET_MODE
+#endif
+
 #ifdef TEST_SHA256
 /* Test whichever sha256 implementation the platform provides. */
 #endif
@@ -627,6 +693,10 @@ int ncp15wb_calculate_temp(uint16_t adc);
 	(CONFIG_RW_B_STORAGE_OFF + CONFIG_RW_SIZE - CONFIG_RW_SIG_SIZE)
 #endif
 
+#ifdef TEST_WINDOW_STATS
+#define CONFIG_STILLNESS_DETECTOR
+#endif
+
 #ifdef TEST_X25519
 #define CONFIG_CURVE25519
 #endif /* TEST_X25519 */
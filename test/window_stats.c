@@ -0,0 +1,247 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ *
+ * Test the windowed statistics and the stillness detector built on them.
+ */
+
+#include "common.h"
+#include "stillness_detector.h"
+#include "test_util.h"
+#include "timer.h"
+#include "util.h"
+#include "window_stats.h"
+
+#include <stdlib.h>
+
+#define WINDOW 50
+
+static int32_t samples[4 * WINDOW];
+
+static void init_samples(void)
+{
+	int i;
+
+	srand(0x5eed);
+	for (i = 0; i < ARRAY_SIZE(samples); i++)
+		samples[i] = (rand() % 65536) - 32768;
+	/* Extreme values, where the accumulators are the largest. */
+	samples[3] = INT16_MIN;
+	samples[4] = INT16_MAX;
+	samples[WINDOW + 7] = INT16_MIN;
+}
+
+/* n^2 * variance of samples[first..first + n), computed in two passes. */
+static uint64_t naive_n2_variance(int first, int n, int64_t *sum)
+{
+	int64_t s = 0;
+	uint64_t n2_var = 0;
+	int i;
+
+	for (i = first; i < first + n; i++)
+		s += samples[i];
+	for (i = first; i < first + n; i++) {
+		int64_t d = (int64_t)n * samples[i] - s;
+
+		n2_var += d * d;
+	}
+	*sum = s;
+	return n2_var / n;
+}
+
+test_static int test_window_stats_growing(void)
+{
+	struct window_stats ws;
+	int64_t sum;
+	int i;
+
+	window_stats_init(&ws, NULL, WINDOW);
+	TEST_EQ(window_stats_mean(&ws), 0, "%d");
+	TEST_EQ(window_stats_variance(&ws), (uint64_t)0, "%" PRIu64);
+
+	for (i = 0; i < WINDOW; i++) {
+		TEST_ASSERT(!window_stats_full(&ws));
+		window_stats_push(&ws, samples[i]);
+		TEST_EQ(ws.n2_variance, naive_n2_variance(0, i + 1, &sum),
+			"%" PRIu64);
+		TEST_EQ(ws.sum, sum, "%" PRId64);
+	}
+	TEST_ASSERT(window_stats_full(&ws));
+	TEST_EQ(window_stats_mean(&ws), (int32_t)(sum / WINDOW), "%d");
+
+	/* Without history, samples past the end are dropped. */
+	window_stats_push(&ws, samples[WINDOW]);
+	TEST_EQ(ws.count, WINDOW, "%u");
+	TEST_EQ(ws.sum, sum, "%" PRId64);
+
+	window_stats_reset(&ws);
+	TEST_EQ(ws.count, 0, "%u");
+	TEST_EQ(ws.n2_variance, (uint64_t)0, "%" PRIu64);
+
+	return EC_SUCCESS;
+}
+
+test_static int test_window_stats_sliding(void)
+{
+	int32_t history[WINDOW];
+	struct window_stats ws;
+	int64_t sum;
+	int i;
+
+	window_stats_init(&ws, history, WINDOW);
+	for (i = 0; i < ARRAY_SIZE(samples); i++) {
+		int first = MAX(0, i + 1 - WINDOW);
+
+		window_stats_push(&ws, samples[i]);
+		TEST_EQ(ws.count, MIN(i + 1, WINDOW), "%u");
+		TEST_EQ(ws.n2_variance,
+			naive_n2_variance(first, i + 1 - first, &sum),
+			"%" PRIu64);
+		TEST_EQ(ws.sum, sum, "%" PRId64);
+	}
+
+	/* A constant signal ends with no variance at all. */
+	for (i = 0; i < WINDOW; i++)
+		window_stats_push(&ws, -1234);
+	TEST_EQ(ws.n2_variance, (uint64_t)0, "%" PRIu64);
+	TEST_EQ(window_stats_mean(&ws), -1234, "%d");
+
+	/* Sizes are capped so the accumulators can not overflow. */
+	window_stats_init(&ws, NULL, UINT16_MAX);
+	TEST_EQ(ws.size, WINDOW_STATS_MAX_SIZE, "%u");
+
+	return EC_SUCCESS;
+}
+
+test_static int test_window_stats_add_sums(void)
+{
+	struct window_stats ws, ref;
+	int64_t sum;
+	uint64_t sum_sq;
+	int i, j;
+
+	window_stats_init(&ws, NULL, WINDOW);
+	window_stats_init(&ref, NULL, WINDOW);
+
+	/* Uneven chunks, starting from an empty window. */
+	for (i = 0; i < WINDOW; i += j) {
+		sum = 0;
+		sum_sq = 0;
+		for (j = 0; j < MIN(i % 7 + 1, WINDOW - i); j++) {
+			sum += samples[i + j];
+			sum_sq += (int64_t)samples[i + j] * samples[i + j];
+			window_stats_push(&ref, samples[i + j]);
+		}
+		window_stats_add_sums(&ws, j, sum, sum_sq);
+		TEST_EQ(ws.count, ref.count, "%u");
+		TEST_ASSERT(ws.sum == ref.sum);
+		TEST_ASSERT(ws.n2_variance == ref.n2_variance);
+	}
+
+	return EC_SUCCESS;
+}
+
+/* Feed a sample every 10ms, with noise of the given amplitude. */
+static int feed_still_det(struct still_det *sd, uint32_t *t, int count,
+			  int noise)
+{
+	int still = 0;
+	int i;
+
+	for (i = 0; i < count; i++, *t += 10 * MSEC) {
+		intv3_t v = { 100 + (i % 3 - 1) * noise, -50, 1000 - noise };
+
+		v[Y] += (i % 2) * noise;
+		if (still_det_update(sd, *t, v))
+			still++;
+	}
+	return still;
+}
+
+test_static int test_still_det(void)
+{
+	struct still_det sd = STILL_DET(10, SECOND, 2 * SECOND, 50);
+	uint32_t t = 0;
+
+	/* 1s of quiet samples, then one more to complete the batch. */
+	TEST_EQ(feed_still_det(&sd, &t, 101, 1), 1, "%d");
+	TEST_NEAR(sd.mean[X], 100, 2, "%d");
+	TEST_NEAR(sd.mean[Y], -50, 2, "%d");
+	TEST_EQ(sd.mean[Z], 999, "%d");
+
+	/* Moving: batches complete, but are not still. */
+	TEST_EQ(feed_still_det(&sd, &t, 505, 100), 0, "%d");
+
+	/* Quiet again. */
+	TEST_EQ(feed_still_det(&sd, &t, 101, 1), 1, "%d");
+
+	/* Too few samples in the batch window. */
+	sd = STILL_DET(10, SECOND, 2 * SECOND, 200);
+	TEST_EQ(feed_still_det(&sd, &t, 505, 1), 0, "%d");
+
+	return EC_SUCCESS;
+}
+
+/* Feed the samples of feed_still_det() in FIFO batches of 7. */
+static int feed_still_det_batch(struct still_det *sd, uint32_t *t, int count,
+				int noise)
+{
+	uint32_t times[7];
+	intv3_t v[7];
+	int still = 0;
+	int i, n = 0;
+
+	for (i = 0; i < count; i++, *t += 10 * MSEC) {
+		times[n] = *t;
+		v[n][X] = 100 + (i % 3 - 1) * noise;
+		v[n][Y] = -50 + (i % 2) * noise;
+		v[n][Z] = 1000 - noise;
+		if (++n == ARRAY_SIZE(v) || i == count - 1) {
+			if (still_det_update_batch(sd, times, v, n))
+				still++;
+			n = 0;
+		}
+	}
+	return still;
+}
+
+test_static int test_still_det_batch(void)
+{
+	struct still_det sd = STILL_DET(10, SECOND, 2 * SECOND, 50);
+	struct still_det ref = sd;
+	uint32_t t = 0, t_ref = 0;
+	int i;
+
+	/* The batches end in the middle of the FIFO reads. */
+	TEST_EQ(feed_still_det_batch(&sd, &t, 101, 1),
+		feed_still_det(&ref, &t_ref, 101, 1), "%d");
+	for (i = X; i <= Z; i++)
+		TEST_EQ(sd.mean[i], ref.mean[i], "%d");
+	TEST_EQ(feed_still_det_batch(&sd, &t, 505, 100),
+		feed_still_det(&ref, &t_ref, 505, 100), "%d");
+	TEST_EQ(feed_still_det_batch(&sd, &t, 135, 1),
+		feed_still_det(&ref, &t_ref, 135, 1), "%d");
+	for (i = X; i <= Z; i++) {
+		TEST_EQ(sd.mean[i], ref.mean[i], "%d");
+		TEST_EQ(sd.stats[i].count, ref.stats[i].count, "%u");
+		TEST_ASSERT(sd.stats[i].n2_variance ==
+			    ref.stats[i].n2_variance);
+	}
+	TEST_EQ(sd.window_start_time, ref.window_start_time, "%u");
+
+	return EC_SUCCESS;
+}
+
+void run_test(int argc, const char **argv)
+{
+	test_reset();
+	init_samples();
+
+	RUN_TEST(test_window_stats_growing);
+	RUN_TEST(test_window_stats_sliding);
+	RUN_TEST(test_window_stats_add_sums);
+	RUN_TEST(test_still_det);
+	RUN_TEST(test_still_det_batch);
+
+	test_print_result();
+}
@@ -38,6 +38,8 @@ ectool-objs+=ectool_i2c.o
 ectool-objs+=ectool_pdc_trace.o
 ectool-objs+=ectool_pdc_pcap.o
 ectool-objs+=../common/crc.o
+ectool-objs+=../common/sha256.o
+ectool-objs+=../common/motion_sense_fifo_delta.o
 ectool_servo-objs=$(ectool-objs) comm-servo-spi.o
 lbplay-objs=lbplay.o $(comm-objs)
 
@@ -79,6 +79,113 @@ int ec_command(int command, int version, const void *outdata, int outsize,
 				outsize, indata, insize);
 }
 
+/*
+ * Pack as many of the commands as fit in a single EC_CMD_BATCH and send it.
+ * Returns the number of commands that ran, or negative on error.
+ */
+static int send_batch(struct ec_batch_cmd *cmds, int count)
+{
+	uint8_t *out = (uint8_t *)ec_outbuf;
+	uint8_t *in = (uint8_t *)ec_inbuf;
+	struct ec_params_batch *p = (struct ec_params_batch *)out;
+	const struct ec_response_batch *r =
+		(const struct ec_response_batch *)in;
+	int outsize = sizeof(*p);
+	int insize = sizeof(*r);
+	int num_cmds, i, rv;
+
+	for (num_cmds = 0; num_cmds < MIN(count, UINT8_MAX); num_cmds++) {
+		const struct ec_batch_cmd *c = &cmds[num_cmds];
+		struct ec_params_batch_cmd *cmd =
+			(struct ec_params_batch_cmd *)(out + outsize);
+		int cmd_outsize = sizeof(*cmd) + EC_BATCH_ALIGN(c->outsize);
+		int cmd_insize = sizeof(struct ec_response_batch_cmd) +
+				 EC_BATCH_ALIGN(c->insize);
+
+		if (outsize + cmd_outsize > ec_max_outsize ||
+		    insize + cmd_insize > ec_max_insize ||
+		    c->insize > UINT16_MAX)
+			break;
+
+		memset(cmd, 0, cmd_outsize);
+		cmd->command = c->command;
+		cmd->version = c->version;
+		cmd->params_size = c->outsize;
+		cmd->response_max = c->insize;
+		if (c->outsize)
+			memcpy(cmd + 1, c->outdata, c->outsize);
+
+		outsize += cmd_outsize;
+		insize += cmd_insize;
+	}
+
+	if (!num_cmds)
+		return 0;
+
+	p->num_cmds = num_cmds;
+	p->flags = 0;
+	p->reserved = 0;
+
+	rv = ec_command(EC_CMD_BATCH, 0, out, outsize, in, insize);
+	if (rv < 0)
+		return rv;
+	if (rv < (int)sizeof(*r) || r->num_done > num_cmds)
+		return -EC_RES_INVALID_RESPONSE;
+
+	insize = sizeof(*r);
+	for (i = 0; i < r->num_done; i++) {
+		const struct ec_response_batch_cmd *resp =
+			(const struct ec_response_batch_cmd *)(in + insize);
+		struct ec_batch_cmd *c = &cmds[i];
+
+		if (insize + (int)sizeof(*resp) > rv ||
+		    insize + (int)sizeof(*resp) + resp->response_size > rv)
+			return -EC_RES_INVALID_RESPONSE;
+
+		if (resp->result != EC_RES_SUCCESS) {
+			c->result = -EECRESULT - resp->result;
+		} else if (resp->response_size > c->insize) {
+			c->result = -EC_RES_INVALID_RESPONSE;
+		} else {
+			memcpy(c->indata, resp + 1, resp->response_size);
+			c->result = resp->response_size;
+		}
+
+		insize += sizeof(*resp) + EC_BATCH_ALIGN(resp->response_size);
+	}
+
+	return r->num_done;
+}
+
+int ec_command_batch(struct ec_batch_cmd *cmds, int count)
+{
+	static bool batch_unsupported;
+	int i = 0;
+	int rv;
+
+	while (i < count) {
+		rv = batch_unsupported ? 0 : send_batch(cmds + i, count - i);
+		if (rv == -EECRESULT - EC_RES_INVALID_COMMAND) {
+			batch_unsupported = true;
+			continue;
+		}
+		if (rv < 0)
+			return rv;
+		if (rv > 0) {
+			i += rv;
+			continue;
+		}
+
+		/* The next command doesn't fit in a batch, send it alone. */
+		cmds[i].result = ec_command(cmds[i].command, cmds[i].version,
+					    cmds[i].outdata, cmds[i].outsize,
+					    cmds[i].indata, cmds[i].insize);
+		i++;
+	}
+
+	return 0;
+}
+
 int comm_init_alt(int interfaces, const char *device_name, int i2c_bus)
 {
 	bool dev_is_cros_ec;
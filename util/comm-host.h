@@ -86,6 +86,31 @@ int ec_command(int command, int version, const void *outdata,
  */
 void set_command_offset(int offset);
 
+/* One command of a batch sent with ec_command_batch(). */
+struct ec_batch_cmd {
+	int command;
+	int version;
+	const void *outdata;
+	int outsize;
+	void *indata;
+	int insize;
+	/* Set to what ec_command() would have returned for this command. */
+	int result;
+};
+
+/**
+ * Send several commands to the EC, using as few EC_CMD_BATCH round trips as
+ * the EC buffer sizes allow. Falls back to one ec_command() per command when
+ * the EC doesn't support EC_CMD_BATCH. The batch is built in ec_outbuf and
+ * ec_inbuf, so the commands must not use those for their own data.
+ *
+ * @param cmds	Commands to send; each result is filled in.
+ * @param count	Number of commands.
+ * @return 0 if every command was sent (check the individual results), or
+ *	   negative on a communication error.
+ */
+int ec_command_batch(struct ec_batch_cmd *cmds, int count);
+
 /**
  * Send a command to the EC.  Returns the length of output data returned (0 if
  * none), or negative on error.  This is the low-level interface implemented
@@ -4,7 +4,9 @@
  */
 
 #include "comm-host.h"
+#include "ec_flash.h"
 #include "misc_util.h"
+#include "sha256.h"
 #include "timer.h"
 
 #include <errno.h>
@@ -139,15 +141,16 @@ static int get_flash_write_size(void)
 	return write_size;
 }
 
-int ec_flash_write(const uint8_t *buf, int offset, int size)
+/**
+ * @return Largest multiple of the flash write size that fits in a single
+ *         EC_CMD_FLASH_WRITE on success, negative on failure
+ */
+static int get_flash_write_step(void)
 {
-	struct ec_params_flash_write *p =
-		(struct ec_params_flash_write *)ec_outbuf;
 	int write_size;
-	int pdata_max_size = (int)(ec_max_outsize - sizeof(*p));
+	int pdata_max_size =
+		(int)(ec_max_outsize - sizeof(struct ec_params_flash_write));
 	int step;
-	int rv;
-	int i;
 
 	/*
 	 * Determine whether we can use version 1 of the EC_CMD_FLASH_WRITE
@@ -175,8 +178,16 @@ int ec_flash_write(const uint8_t *buf, int offset, int size)
 		return -1;
 	}
 
-	/* Write data in chunks */
-	printf("Write size %d...\n", step);
+	return step;
+}
+
+static int flash_write_chunks(const uint8_t *buf, int offset, int size,
+			      int step)
+{
+	struct ec_params_flash_write *p =
+		(struct ec_params_flash_write *)ec_outbuf;
+	int rv;
+	int i;
 
 	for (i = 0; i < size; i += step) {
 		p->offset = offset + i;
@@ -185,7 +196,8 @@ int ec_flash_write(const uint8_t *buf, int offset, int size)
 		rv = ec_command(EC_CMD_FLASH_WRITE, 0, p, sizeof(*p) + p->size,
 				NULL, 0);
 		if (rv < 0) {
-			fprintf(stderr, "Write error at offset %d\n", i);
+			fprintf(stderr, "Write error at offset %d\n",
+				offset + i);
 			return rv;
 		}
 	}
@@ -193,6 +205,306 @@ int ec_flash_write(const uint8_t *buf, int offset, int size)
 	return 0;
 }
 
+int ec_flash_write(const uint8_t *buf, int offset, int size)
+{
+	int step;
+
+	step = get_flash_write_step();
+	if (step < 0)
+		return step;
+
+	/* Write data in chunks */
+	printf("Write size %d...\n", step);
+
+	return flash_write_chunks(buf, offset, size, step);
+}
+
+/**
+ * Ask the EC for the SHA-256 of a flash range.
+ *
+ * @param digest	Destination for the SHA256_DIGEST_SIZE byte digest
+ * @param offset	Offset in EC flash to hash
+ * @param size		Number of bytes to hash
+ *
+ * @return 0 if success, negative if error.
+ */
+static int ec_flash_hash(uint8_t *digest, int offset, int size)
+{
+	struct ec_params_vboot_hash p = { 0 };
+	struct ec_response_vboot_hash r;
+	int rv;
+
+	p.cmd = EC_VBOOT_HASH_RECALC;
+	p.hash_type = EC_VBOOT_HASH_TYPE_SHA256;
+	p.offset = offset;
+	p.size = size;
+
+	rv = ec_command(EC_CMD_VBOOT_HASH, 0, &p, sizeof(p), &r, sizeof(r));
+	if (rv < 0)
+		return rv;
+
+	if (r.status != EC_VBOOT_HASH_STATUS_DONE ||
+	    r.hash_type != EC_VBOOT_HASH_TYPE_SHA256 ||
+	    r.digest_size != SHA256_DIGEST_SIZE ||
+	    r.offset != (uint32_t)offset ||
+	    r.size != (uint32_t)size)
+		return -1;
+
+	memcpy(digest, r.hash_digest, SHA256_DIGEST_SIZE);
+	return 0;
+}
+
+/**
+ * Check whether a range of EC flash already holds the given data.
+ *
+ * The EC hashes the range so only the digest crosses the bus. If the EC
+ * cannot hash (no vboot hash support, or a hash already in progress) the
+ * range is read back instead.
+ *
+ * @return 1 if the flash matches, 0 if it differs, negative if error.
+ */
+static int ec_flash_matches(const uint8_t *buf, int offset, int size,
+			    bool use_hash, uint8_t *rbuf)
+{
+	uint8_t digest[SHA256_DIGEST_SIZE];
+	struct sha256_ctx ctx;
+	int rv;
+
+	if (use_hash && ec_flash_hash(digest, offset, size) == 0) {
+		SHA256_init(&ctx);
+		SHA256_update(&ctx, buf, size);
+		return !memcmp(SHA256_final(&ctx), digest, sizeof(digest));
+	}
+
+	rv = ec_flash_read(rbuf, offset, size);
+	if (rv < 0)
+		return rv;
+
+	return !memcmp(rbuf, buf, size);
+}
+
+/*
+ * Largest range hashed in one EC_CMD_VBOOT_HASH, in bytes. The EC hashes
+ * synchronously, and a slow EC hashes a few hundred KB per second, so this
+ * keeps the host command well below the 1 s timeout of the LPC transport
+ * whatever the erase block size. A range is never smaller than one block.
+ */
+#define DIFF_HASH_MAX_BYTES (64 * 1024)
+
+/**
+ * Mark the erase blocks of a range that differ from buf.
+ *
+ * The range is compared as a whole, and only split in halves where it
+ * differs, so an unchanged image costs a single hash.
+ *
+ * @param known_diff	The range is already known to differ
+ *
+ * @return 0 if success, negative if error.
+ */
+static int find_changed_blocks(const uint8_t *buf, int offset, int first,
+			       int count, int erase_size, bool use_hash,
+			       bool known_diff, uint8_t *rbuf, uint8_t *changed)
+{
+	bool second_diff = true;
+	int half;
+	int rv;
+	int i;
+
+	if (!known_diff) {
+		rv = ec_flash_matches(buf + first * erase_size,
+				      offset + first * erase_size,
+				      count * erase_size, use_hash, rbuf);
+		if (rv)
+			return rv < 0 ? rv : 0;
+	}
+
+	if (count == 1) {
+		changed[first] = 1;
+		return 0;
+	}
+
+	half = count / 2;
+	rv = find_changed_blocks(buf, offset, first, half, erase_size, use_hash,
+				 false, rbuf, changed);
+	if (rv < 0)
+		return rv;
+
+	/* If the first half matches, the second half must be what differs. */
+	for (i = first; i < first + half; i++)
+		if (changed[i])
+			second_diff = false;
+	return find_changed_blocks(buf, offset, first + half, count - half,
+				   erase_size, use_hash, second_diff, rbuf,
+				   changed);
+}
+
+/**
+ * Get the range of the hash the EC holds for verified boot.
+ *
+ * @return true if the EC has a hash, false if it has none or is computing it.
+ */
+static bool ec_flash_get_vboot_hash(uint32_t *offset, uint32_t *size)
+{
+	struct ec_params_vboot_hash p = { 0 };
+	struct ec_response_vboot_hash r;
+
+	p.cmd = EC_VBOOT_HASH_GET;
+	if (ec_command(EC_CMD_VBOOT_HASH, 0, &p, sizeof(p), &r, sizeof(r)) < 0)
+		return false;
+	if (r.status != EC_VBOOT_HASH_STATUS_DONE)
+		return false;
+
+	*offset = r.offset;
+	*size = r.size;
+	return true;
+}
+
+/**
+ * Have the EC recompute the hash used by verified boot, which
+ * ec_flash_matches() replaced. The hash runs in the background.
+ */
+static void ec_flash_restart_vboot_hash(bool valid, uint32_t offset,
+					uint32_t size)
+{
+	struct ec_params_vboot_hash p = { 0 };
+	struct ec_response_vboot_hash r;
+
+	p.cmd = EC_VBOOT_HASH_START;
+	p.hash_type = EC_VBOOT_HASH_TYPE_SHA256;
+	p.offset = valid ? offset : EC_VBOOT_HASH_OFFSET_ACTIVE;
+	p.size = valid ? size : 0;
+
+	if (ec_command(EC_CMD_VBOOT_HASH, 0, &p, sizeof(p), &r, sizeof(r)) < 0)
+		fprintf(stderr, "Unable to restart the EC vboot hash\n");
+}
+
+int ec_flash_write_diff(const uint8_t *buf, int offset, int size)
+{
+	struct ec_response_flash_info info = { 0 };
+	int erase_size;
+	int num_blocks;
+	int max_blocks;
+	int step;
+	bool use_hash;
+	bool vboot_hash_valid = false;
+	uint32_t vboot_hash_offset = 0;
+	uint32_t vboot_hash_size = 0;
+	uint8_t *rbuf = NULL;
+	uint8_t *changed = NULL;
+	int num_changed = 0;
+	int start;
+	int end;
+	int block;
+	int rv;
+
+	rv = get_flash_info_v0(&info);
+	if (rv < 0)
+		return rv;
+
+	erase_size = info.erase_block_size;
+	if (erase_size <= 0)
+		return -1;
+
+	if (offset % erase_size || size % erase_size) {
+		fprintf(stderr,
+			"Offset and size must be multiples of the erase "
+			"block size %d\n",
+			erase_size);
+		return -1;
+	}
+
+	step = get_flash_write_step();
+	if (step < 0)
+		return step;
+
+	num_blocks = size / erase_size;
+	use_hash = ec_cmd_version_supported(EC_CMD_VBOOT_HASH, 0);
+	/* Reading back more than a block at once saves nothing. */
+	max_blocks = use_hash ? MAX(DIFF_HASH_MAX_BYTES / erase_size, 1) : 1;
+
+	/* The read back buffer is also used when the EC is busy hashing. */
+	rbuf = (uint8_t *)malloc(MIN(num_blocks, max_blocks) * erase_size);
+	changed = (uint8_t *)calloc(num_blocks, 1);
+	if (!rbuf || !changed) {
+		fprintf(stderr, "Unable to allocate buffer.\n");
+		rv = -1;
+		goto out;
+	}
+
+	if (use_hash)
+		vboot_hash_valid = ec_flash_get_vboot_hash(&vboot_hash_offset,
+							   &vboot_hash_size);
+
+	printf("Comparing %d blocks of %d bytes%s...\n", num_blocks,
+	       erase_size, use_hash ? "" : " (no EC hash, reading back)");
+
+	for (block = 0; block < num_blocks; block += max_blocks) {
+		rv = find_changed_blocks(buf, offset, block,
+					 MIN(num_blocks - block, max_blocks),
+					 erase_size, use_hash, false, rbuf,
+					 changed);
+		if (rv < 0)
+			goto out;
+	}
+
+	/*
+	 * Erase, write and verify each run of consecutive changed blocks as a
+	 * whole so unchanged blocks are never touched.
+	 */
+	for (start = 0; start < num_blocks; start = end) {
+		end = start + 1;
+		if (!changed[start])
+			continue;
+		while (end < num_blocks && changed[end])
+			end++;
+
+		printf("Updating 0x%x-0x%x...\n", offset + start * erase_size,
+		       offset + end * erase_size - 1);
+
+		rv = ec_flash_erase(offset + start * erase_size,
+				    (end - start) * erase_size);
+		if (rv < 0) {
+			fprintf(stderr, "Erase error at offset %d\n",
+				offset + start * erase_size);
+			goto out;
+		}
+
+		rv = flash_write_chunks(buf + start * erase_size,
+					offset + start * erase_size,
+					(end - start) * erase_size, step);
+		if (rv < 0)
+			goto out;
+
+		for (block = start; block < end; block += max_blocks) {
+			int count = MIN(end - block, max_blocks);
+
+			rv = ec_flash_matches(buf + block * erase_size,
+					      offset + block * erase_size,
+					      count * erase_size, use_hash,
+					      rbuf);
+			if (rv < 0)
+				goto out;
+			if (!rv) {
+				fprintf(stderr, "Verify error at offset %d\n",
+					offset + block * erase_size);
+				rv = -1;
+				goto out;
+			}
+		}
+		num_changed += end - start;
+	}
+
+	printf("%d of %d blocks updated.\n", num_changed, num_blocks);
+	rv = 0;
+out:
+	if (use_hash && changed)
+		ec_flash_restart_vboot_hash(vboot_hash_valid, vboot_hash_offset,
+					    vboot_hash_size);
+	free(changed);
+	free(rbuf);
+	return rv;
+}
+
 int ec_flash_erase(int offset, int size)
 {
 	struct ec_params_flash_erase p;
@@ -39,6 +39,24 @@ int ec_flash_verify(const uint8_t *buf, int offset, int size);
  */
 int ec_flash_write(const uint8_t *buf, int offset, int size);
 
+/**
+ * Write only the erase blocks of EC flash that differ from buf
+ *
+ * The image is compared against the EC using hashes computed on the EC,
+ * over large ranges first and then only where they differ, so unchanged
+ * blocks are neither erased nor rewritten. Changed blocks are erased,
+ * written and then verified. The EC hash used by verified boot is
+ * recomputed in the background when done.
+ *
+ * @param buf		Source buffer
+ * @param offset	Offset in EC flash to write; must be erase block aligned
+ * @param size		Number of bytes to write; must be a multiple of the
+ *			erase block size
+ *
+ * @return 0 if success, negative if error.
+ */
+int ec_flash_write_diff(const uint8_t *buf, int offset, int size);
+
 /**
  * Erase EC flash memory
  *
@@ -17,6 +17,7 @@
 #include "lightbar.h"
 #include "lock/gec_lock.h"
 #include "misc_util.h"
+#include "motion_sense_fifo_delta.h"
 #include "panic.h"
 #include "tablet_mode.h"
 #include "usb_pd.h"
@@ -1445,8 +1446,11 @@ int cmd_flash_write(int argc, char *argv[])
 
 	printf("Writing to offset %d...\n", offset);
 
-	/* Write data in chunks */
-	rv = ec_flash_write((const uint8_t *)(buf), offset, size);
+	if (strcmp(argv[0], "flashwritediff") == 0)
+		rv = ec_flash_write_diff((const uint8_t *)(buf), offset, size);
+	else
+		/* Write data in chunks */
+		rv = ec_flash_write((const uint8_t *)(buf), offset, size);
 
 	free(buf);
 
@@ -3086,16 +3090,39 @@ int cmd_temp_sensor_info(int argc, char *argv[])
 	}
 
 	if (strcmp(argv[1], "all") == 0) {
+		struct ec_params_temp_sensor_get_info
+			params[EC_MAX_TEMP_SENSOR_ENTRIES];
+		struct ec_response_temp_sensor_get_info
+			resps[EC_MAX_TEMP_SENSOR_ENTRIES];
+		struct ec_batch_cmd cmds[EC_MAX_TEMP_SENSOR_ENTRIES];
+		int count = 0;
+
+		/* Query all the sensors in as few round trips as possible. */
 		for (p.id = 0; p.id < EC_MAX_TEMP_SENSOR_ENTRIES; p.id++) {
 			if (read_mapped_temperature(p.id) ==
 			    EC_TEMP_SENSOR_NOT_PRESENT)
 				continue;
-			rv = ec_command(EC_CMD_TEMP_SENSOR_GET_INFO, 0, &p,
-					sizeof(p), &r, sizeof(r));
-			if (rv < 0)
+			params[count] = p;
+			cmds[count] = {
+				.command = EC_CMD_TEMP_SENSOR_GET_INFO,
+				.version = 0,
+				.outdata = &params[count],
+				.outsize = sizeof(params[count]),
+				.indata = &resps[count],
+				.insize = sizeof(resps[count]),
+			};
+			count++;
+		}
+
+		rv = ec_command_batch(cmds, count);
+		if (rv < 0)
+			return rv;
+
+		for (int i = 0; i < count; i++) {
+			if (cmds[i].result < 0)
 				continue;
-			printf("%d: %d %s\n", p.id, r.sensor_type,
-			       r.sensor_name);
+			printf("%d: %d %s\n", params[i].id, resps[i].sensor_type,
+			       resps[i].sensor_name);
 		}
 		return 0;
 	}
@@ -5026,6 +5053,10 @@ static const struct {
 	ST_BOTH_SIZES(sensor_scale),
 	ST_BOTH_SIZES(online_calib_read),
 	ST_BOTH_SIZES(get_activity),
+	{ ST_PRM_SIZE(fifo_read), ST_RSP_SIZE(fifo_read_delta) },
+	ST_BOTH_SIZES(sched_stats),
+	ST_BOTH_SIZES(fifo_coalesce),
+	{ ST_PRM_SIZE(fifo_read), ST_RSP_SIZE(trace_read) },
 };
 BUILD_ASSERT(ARRAY_SIZE(ms_command_sizes) == MOTIONSENSE_NUM_CMDS);
 
@@ -5055,6 +5086,9 @@ static int ms_help(const char *cmd)
 	       "interrupt status\n",
 	       cmd);
 	printf("  %s fifo_read MAX_DATA           - read fifo data\n", cmd);
+	printf("  %s fifo_read_delta MAX_DATA     - read delta encoded fifo "
+	       "data\n",
+	       cmd);
 	printf("  %s fifo_flush NUM               - trigger fifo interrupt\n",
 	       cmd);
 	printf("  %s list_activities              - list supported "
@@ -5075,6 +5109,18 @@ static int ms_help(const char *cmd)
 	       cmd);
 	printf("  %s calibrate NUM                - run sensor calibration\n",
 	       cmd);
+	printf("  %s sched_stats NUM [reset]      - print/reset read "
+	       "schedule statistics\n",
+	       cmd);
+	printf("  %s fifo_coalesce NUM [LAT_MS [MAX_EVENTS]] - set/get fifo "
+	       "interrupt coalescing\n",
+	       cmd);
+	printf("  %s fifo_coalesce NUM reset      - print/reset fifo "
+	       "interrupt statistics\n",
+	       cmd);
+	printf("  %s trace [raw]                  - print read path latency "
+	       "histograms\n",
+	       cmd);
 
 	return 0;
 }
@@ -5093,6 +5139,169 @@ static void motionsense_display_activities(uint32_t activities)
 		       MOTIONSENSE_ACTIVITY_BODY_DETECTION);
 }
 
+static void ms_print_fifo_vector(
+	const struct ec_response_motion_sensor_data *vector)
+{
+	if (vector->flags & (MOTIONSENSE_SENSOR_FLAG_TIMESTAMP |
+			     MOTIONSENSE_SENSOR_FLAG_FLUSH)) {
+		printf("Timestamp:%" PRIx32 "%s\n", vector->timestamp,
+		       (vector->flags & MOTIONSENSE_SENSOR_FLAG_FLUSH ?
+				" - Flush" :
+				""));
+	} else {
+		printf("Sensor %d: %d\t%d\t%d "
+		       "(as uint16: %u\t%u\t%u)\n",
+		       vector->sensor_num, vector->data[0], vector->data[1],
+		       vector->data[2], vector->data[0], vector->data[1],
+		       vector->data[2]);
+	}
+}
+
+/*
+ * Latency histogram of one stage of the sensor read path. Bucket i counts the
+ * latencies below MS_TRACE_BUCKET_US(i), the last one counts all the others.
+ */
+#define MS_TRACE_BUCKETS 10
+#define MS_TRACE_BUCKET_US(i) (128u << (i))
+
+struct ms_trace_hist {
+	uint32_t count;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t sum_us;
+	uint32_t buckets[MS_TRACE_BUCKETS];
+};
+
+enum ms_trace_stage {
+	MS_TRACE_TO_FIFO,
+	MS_TRACE_TO_AP,
+	MS_TRACE_TOTAL,
+	MS_TRACE_STAGE_COUNT,
+};
+
+/* Note: depends on enum ms_trace_stage */
+static const char *const ms_trace_stage_names[] = { "irq->fifo", "fifo->ap",
+						    "irq->ap" };
+BUILD_ASSERT(ARRAY_SIZE(ms_trace_stage_names) == MS_TRACE_STAGE_COUNT);
+
+/* Note: depends on enum motionsense_trace_point */
+static const char *const ms_trace_point_names[] = { "irq", "task", "stage",
+						    "commit", "host_read" };
+BUILD_ASSERT(ARRAY_SIZE(ms_trace_point_names) ==
+	     MOTIONSENSE_TRACE_POINT_COUNT);
+
+/*
+ * Read path of one sensor while replaying the trace.
+ * start: when the sensor interrupted, or the motion task started to read it
+ *        for sensors without interrupt.
+ * commit: when the oldest data not read by the AP yet was committed.
+ * commit_start: start of that data.
+ */
+struct ms_trace_sensor {
+	bool has_start;
+	bool has_commit;
+	bool has_commit_start;
+	uint32_t start;
+	uint32_t commit;
+	uint32_t commit_start;
+	struct ms_trace_hist hist[MS_TRACE_STAGE_COUNT];
+};
+
+static void ms_trace_hist_add(struct ms_trace_hist *hist, uint32_t latency_us)
+{
+	int i;
+
+	for (i = 0; i < MS_TRACE_BUCKETS - 1; i++)
+		if (latency_us < MS_TRACE_BUCKET_US(i))
+			break;
+	hist->buckets[i]++;
+	if (!hist->count || latency_us < hist->min_us)
+		hist->min_us = latency_us;
+	if (latency_us > hist->max_us)
+		hist->max_us = latency_us;
+	hist->sum_us += latency_us;
+	hist->count++;
+}
+
+static void ms_trace_replay(const struct ec_motion_sense_trace_entry *entry,
+			    struct ms_trace_sensor *sensors)
+{
+	struct ms_trace_sensor *s;
+	int i;
+
+	if (entry->point == MOTIONSENSE_TRACE_HOST_READ) {
+		/* The AP reads the data of all the sensors. */
+		for (i = 0; i < ECTOOL_MAX_SENSOR; i++) {
+			s = &sensors[i];
+			if (!s->has_commit)
+				continue;
+			ms_trace_hist_add(&s->hist[MS_TRACE_TO_AP],
+					  entry->timestamp - s->commit);
+			if (s->has_commit_start)
+				ms_trace_hist_add(&s->hist[MS_TRACE_TOTAL],
+						  entry->timestamp -
+							  s->commit_start);
+			s->has_commit = false;
+		}
+		return;
+	}
+	if (entry->sensor_num >= ECTOOL_MAX_SENSOR)
+		return;
+
+	s = &sensors[entry->sensor_num];
+	switch (entry->point) {
+	case MOTIONSENSE_TRACE_TASK:
+	case MOTIONSENSE_TRACE_IRQ:
+		/* The driver reports the interrupt after the task starts. */
+		s->start = entry->timestamp;
+		s->has_start = true;
+		break;
+	case MOTIONSENSE_TRACE_COMMIT:
+		if (s->has_start)
+			ms_trace_hist_add(&s->hist[MS_TRACE_TO_FIFO],
+					  entry->timestamp - s->start);
+		if (!s->has_commit) {
+			s->commit = entry->timestamp;
+			s->commit_start = s->start;
+			s->has_commit_start = s->has_start;
+			s->has_commit = true;
+		}
+		s->has_start = false;
+		break;
+	default:
+		break;
+	}
+}
+
+static void ms_trace_print(const struct ms_trace_sensor *sensors)
+{
+	const struct ms_trace_hist *hist;
+	int i, j, k;
+
+	printf("%-6s %-9s %7s %7s %7s %7s", "sensor", "stage", "count",
+	       "min", "avg", "max");
+	for (k = 0; k < MS_TRACE_BUCKETS - 1; k++)
+		printf(" <%-6u", MS_TRACE_BUCKET_US(k));
+	printf(" >=%-5u\n", MS_TRACE_BUCKET_US(MS_TRACE_BUCKETS - 2));
+
+	for (i = 0; i < ECTOOL_MAX_SENSOR; i++) {
+		for (j = 0; j < MS_TRACE_STAGE_COUNT; j++) {
+			hist = &sensors[i].hist[j];
+			if (!hist->count)
+				continue;
+			printf("%-6d %-9s %7" PRIu32 " %7" PRIu32 " %7" PRIu64
+			       " %7" PRIu32,
+			       i, ms_trace_stage_names[j], hist->count,
+			       hist->min_us, hist->sum_us / hist->count,
+			       hist->max_us);
+			for (k = 0; k < MS_TRACE_BUCKETS; k++)
+				printf(" %7" PRIu32, hist->buckets[k]);
+			printf("\n");
+		}
+	}
+	printf("Latencies in us.\n");
+}
+
 static int cmd_motionsense(int argc, char **argv)
 {
 	int i, rv, status_only = (argc == 2);
@@ -5613,7 +5822,6 @@ static int cmd_motionsense(int argc, char **argv)
 		}
 		while (fifo_read_buffer.number_data != 0 &&
 		       print_data < max_data) {
-			struct ec_response_motion_sensor_data *vector;
 			param.cmd = MOTIONSENSE_CMD_FIFO_READ;
 			param.fifo_read.max_data_vector =
 				MIN(ARRAY_SIZE(fifo_read_buffer.data),
@@ -5626,26 +5834,50 @@ static int cmd_motionsense(int argc, char **argv)
 				return rv;
 
 			print_data += fifo_read_buffer.number_data;
-			for (i = 0; i < fifo_read_buffer.number_data; i++) {
-				vector = &fifo_read_buffer.data[i];
-				if (vector->flags &
-				    (MOTIONSENSE_SENSOR_FLAG_TIMESTAMP |
-				     MOTIONSENSE_SENSOR_FLAG_FLUSH)) {
-					printf("Timestamp:%" PRIx32 "%s\n",
-					       vector->timestamp,
-					       (vector->flags & MOTIONSENSE_SENSOR_FLAG_FLUSH ?
-							" - Flush" :
-							""));
-				} else {
-					printf("Sensor %d: %d\t%d\t%d "
-					       "(as uint16: %u\t%u\t%u)\n",
-					       vector->sensor_num,
-					       vector->data[0], vector->data[1],
-					       vector->data[2], vector->data[0],
-					       vector->data[1],
-					       vector->data[2]);
-				}
+			for (i = 0; i < fifo_read_buffer.number_data; i++)
+				ms_print_fifo_vector(&fifo_read_buffer.data[i]);
+		}
+		return 0;
+	}
+
+	if (argc == 3 && !strcasecmp(argv[1], "fifo_read_delta")) {
+		struct ec_response_motion_sense_fifo_delta *delta;
+		struct ec_response_motion_sensor_data vectors[512];
+		int print_data = 0, max_data = strtol(argv[2], &e, 0);
+		int count = -1;
+
+		if (e && *e) {
+			fprintf(stderr, "Bad %s arg.\n", argv[2]);
+			return -1;
+		}
+		delta = (struct ec_response_motion_sense_fifo_delta *)ec_inbuf;
+		while (count != 0 && print_data < max_data) {
+			param.cmd = MOTIONSENSE_CMD_FIFO_READ_DELTA;
+			param.fifo_read.max_data_vector =
+				MIN(ARRAY_SIZE(vectors), max_data - print_data);
+
+			rv = ec_command(EC_CMD_MOTION_SENSE_CMD, 2, &param,
+					ms_command_sizes[param.cmd].outsize,
+					delta, ec_max_insize);
+			if (rv < 0)
+				return rv;
+			if (rv < (int)sizeof(*delta) ||
+			    rv < (int)sizeof(*delta) + delta->size) {
+				fprintf(stderr, "Truncated response.\n");
+				return -1;
+			}
+
+			count = delta->number_data;
+			if (count > (int)ARRAY_SIZE(vectors) ||
+			    motion_sense_fifo_delta_decode(delta->data,
+							   delta->size, count,
+							   vectors) < 0) {
+				fprintf(stderr, "Malformed response.\n");
+				return -1;
 			}
+			print_data += count;
+			for (i = 0; i < count; i++)
+				ms_print_fifo_vector(&vectors[i]);
 		}
 		return 0;
 	}
@@ -5796,6 +6028,145 @@ static int cmd_motionsense(int argc, char **argv)
 		printf("State: %d\n", resp->get_activity.state);
 		return 0;
 	}
+	if ((argc == 3 || argc == 4) && !strcasecmp(argv[1], "sched_stats")) {
+		param.cmd = MOTIONSENSE_CMD_SCHED_STATS;
+		param.sched_stats.sensor_num = strtol(argv[2], &e, 0);
+		if (e && *e) {
+			fprintf(stderr, "Bad %s arg.\n", argv[2]);
+			return -1;
+		}
+		if (argc == 4 && strcasecmp(argv[3], "reset")) {
+			fprintf(stderr, "Bad %s arg.\n", argv[3]);
+			return -1;
+		}
+		param.sched_stats.reset = argc == 4;
+
+		rv = ec_command(EC_CMD_MOTION_SENSE_CMD, 2, &param,
+				ms_command_sizes[param.cmd].outsize, resp,
+				ms_command_sizes[param.cmd].insize);
+		if (rv < 0)
+			return rv;
+
+		printf("Reads:        %" PRIu32 "\n", resp->sched_stats.reads);
+		printf("Late reads:   %" PRIu32 "\n",
+		       resp->sched_stats.late_reads);
+		printf("Missed reads: %" PRIu32 "\n",
+		       resp->sched_stats.missed_reads);
+		printf("Jitter:       avg %" PRIu32 " us, max %" PRIu32
+		       " us\n",
+		       resp->sched_stats.jitter_avg_us,
+		       resp->sched_stats.jitter_max_us);
+		return 0;
+	}
+
+	if ((argc == 2 || argc == 3) && !strcasecmp(argv[1], "trace")) {
+		struct ec_response_motion_sense_trace *trace;
+		std::unique_ptr<struct ms_trace_sensor[]> sensors =
+			std::make_unique<struct ms_trace_sensor[]>(
+				ECTOOL_MAX_SENSOR);
+		bool raw = argc == 3;
+		uint32_t total = 0, lost = 0;
+		const struct ec_motion_sense_trace_entry *entry;
+
+		if (raw && strcasecmp(argv[2], "raw")) {
+			fprintf(stderr, "Bad %s arg.\n", argv[2]);
+			return -1;
+		}
+		trace = (struct ec_response_motion_sense_trace *)ec_inbuf;
+		param.cmd = MOTIONSENSE_CMD_TRACE_READ;
+		param.fifo_read.max_data_vector =
+			(ec_max_insize - sizeof(*trace)) /
+			sizeof(trace->entries[0]);
+		/* The EC keeps tracing while we read, stop at some point. */
+		do {
+			rv = ec_command(EC_CMD_MOTION_SENSE_CMD, 2, &param,
+					ms_command_sizes[param.cmd].outsize,
+					trace, ec_max_insize);
+			if (rv < 0)
+				return rv;
+			if (rv < (int)sizeof(*trace) ||
+			    rv < (int)(sizeof(*trace) +
+				       trace->count * sizeof(trace->entries[0]))) {
+				fprintf(stderr, "Truncated response.\n");
+				return -1;
+			}
+
+			lost += trace->lost;
+			for (i = 0; i < trace->count; i++) {
+				entry = &trace->entries[i];
+				if (raw)
+					printf("%10" PRIu32 " %3d %s\n",
+					       entry->timestamp,
+					       entry->sensor_num,
+					       entry->point <
+							       MOTIONSENSE_TRACE_POINT_COUNT ?
+						       ms_trace_point_names
+							       [entry->point] :
+						       "?");
+				ms_trace_replay(entry, sensors.get());
+			}
+			total += trace->count;
+		} while (trace->count && total < 65536);
+
+		if (!raw)
+			ms_trace_print(sensors.get());
+		printf("Entries: %" PRIu32 ", lost: %" PRIu32 "\n", total,
+		       lost);
+		return 0;
+	}
+
+	if (argc >= 3 && argc <= 5 && !strcasecmp(argv[1], "fifo_coalesce")) {
+		param.cmd = MOTIONSENSE_CMD_FIFO_COALESCE;
+		param.fifo_coalesce.sensor_num = strtol(argv[2], &e, 0);
+		if (e && *e) {
+			fprintf(stderr, "Bad %s arg.\n", argv[2]);
+			return -1;
+		}
+		param.fifo_coalesce.flags = 0;
+		if (argc == 4 && !strcasecmp(argv[3], "reset")) {
+			param.fifo_coalesce.flags =
+				MOTIONSENSE_FIFO_COALESCE_RESET;
+		} else if (argc >= 4) {
+			param.fifo_coalesce.flags =
+				MOTIONSENSE_FIFO_COALESCE_SET;
+			param.fifo_coalesce.max_latency_ms =
+				strtol(argv[3], &e, 0);
+			if (e && *e) {
+				fprintf(stderr, "Bad %s arg.\n", argv[3]);
+				return -1;
+			}
+			param.fifo_coalesce.max_events = 0;
+			if (argc == 5) {
+				param.fifo_coalesce.max_events =
+					strtol(argv[4], &e, 0);
+				if (e && *e) {
+					fprintf(stderr, "Bad %s arg.\n",
+						argv[4]);
+					return -1;
+				}
+			}
+		}
+
+		rv = ec_command(EC_CMD_MOTION_SENSE_CMD, 2, &param,
+				ms_command_sizes[param.cmd].outsize, resp,
+				ms_command_sizes[param.cmd].insize);
+		if (rv < 0)
+			return rv;
+
+		if (resp->fifo_coalesce.max_latency_ms)
+			printf("Max latency:      %d ms\n",
+			       resp->fifo_coalesce.max_latency_ms);
+		else
+			printf("Max latency:      ec_rate\n");
+		printf("Max events:       %d\n",
+		       resp->fifo_coalesce.max_events);
+		printf("Interrupts:       %" PRIu32 "\n",
+		       resp->fifo_coalesce.interrupts);
+		printf("Interrupts saved: %" PRIu32 "\n",
+		       resp->fifo_coalesce.interrupts_saved);
+		return 0;
+	}
+
 	if (argc == 2 && !strcasecmp(argv[1], "lid_angle")) {
 		param.cmd = MOTIONSENSE_CMD_LID_ANGLE;
 		rv = ec_command(EC_CMD_MOTION_SENSE_CMD, 2, &param,
@@ -12800,6 +13171,9 @@ const struct command commands[] = {
 	{ "flashwrite", cmd_flash_write,
 	  "<offset> <infile>\n"
 	  "\tWrites to EC flash from a file." },
+	{ "flashwritediff", cmd_flash_write,
+	  "<offset> <infile>\n"
+	  "\tWrites to EC flash from a file, skipping unchanged blocks." },
 	{ "forcelidopen", cmd_force_lid_open,
 	  "<enable>\n"
 	  "\tForces the lid switch to open position." },
@@ -12846,6 +13220,10 @@ const struct command commands[] = {
 	{ "i2cspeed", cmd_i2c_speed,
 	  "<port> [speed]\n"
 	  "\tGet or set EC's I2C bus speed." },
+	{ "i2cstats", cmd_i2c_stats,
+	  "[reset]\n"
+	  "\tShow or reset EC's I2C bus utilization and latency statistics." },
+	{ "i2ctrace", cmd_i2c_trace, cmd_i2c_trace_usage },
 	{ "i2cwrite", cmd_i2c_write, "\n\tWrite I2C bus." },
 	{ "i2cxfer", cmd_i2c_xfer,
 	  "<port> <peripheral_addr> <read_count> [write bytes...]\n"
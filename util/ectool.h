@@ -51,8 +51,12 @@ int cmd_keyscan(int argc, char *argv[]);
 /* ASCII mode for printing, default off */
 extern int ascii_mode;
 
+extern const char cmd_i2c_trace_usage[];
+
 int cmd_i2c_protect(int argc, char *argv[]);
 int cmd_i2c_read(int argc, char *argv[]);
 int cmd_i2c_speed(int argc, char *argv[]);
+int cmd_i2c_stats(int argc, char *argv[]);
+int cmd_i2c_trace(int argc, char *argv[]);
 int cmd_i2c_write(int argc, char *argv[]);
 int cmd_i2c_xfer(int argc, char *argv[]);
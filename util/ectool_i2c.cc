@@ -5,6 +5,7 @@
 
 #include "comm-host.h"
 #include "ectool.h"
+#include "misc_util.h"
 
 #include <ctype.h>
 #include <stdint.h>
@@ -14,6 +15,7 @@
 
 #include <endian.h>
 #include <libec/i2c_passthru_command.h>
+#include <unistd.h>
 #include <vector>
 
 int cmd_i2c_protect(int argc, char *argv[])
@@ -396,3 +398,229 @@ int cmd_i2c_speed(int argc, char *argv[])
 
 	return i2c_set(port, speed);
 }
+
+/* clang-format off */
+const char cmd_i2c_trace_usage[] =
+	"[-f] [-s] [-w <file>]\n"
+	"\tRead the I2C trace enabled by the EC console command i2ctrace.\n"
+	"\t-f         follow: keep reading new records until interrupted\n"
+	"\t-s         print to stdout (default if no other destination)\n"
+	"\t-w <file>  write to pcap <file>";
+/* clang-format on */
+
+/*
+ * I2C trace records get a 10 byte header in pcap files, followed by the
+ * bytes written then the bytes read. This is ec_i2c_trace_record without
+ * the timestamp, since pcap records have their own.
+ */
+struct pcap_i2c_trace_header {
+	uint8_t port;
+	uint8_t addr;
+	uint16_t out_size;
+	uint16_t in_size;
+	int16_t result;
+	uint16_t duration;
+} __packed;
+
+BUILD_ASSERT(sizeof(struct pcap_i2c_trace_header) == 10);
+
+static void i2c_trace_print(const struct ec_i2c_trace_record *r)
+{
+	int out_count = MIN(r->out_size, EC_I2C_TRACE_DATA_SIZE);
+	int in_count = MIN(r->in_size, EC_I2C_TRACE_DATA_SIZE - out_count);
+	int i;
+
+	printf("%10u %5uus %u:0x%02x", r->timestamp, r->duration, r->port,
+	       r->addr);
+	if (r->out_size) {
+		printf(" wr");
+		for (i = 0; i < out_count; i++)
+			printf(" 0x%02x", r->data[i]);
+		if (r->out_size > out_count)
+			printf(" ... (%u bytes)", r->out_size);
+	}
+	if (r->result) {
+		printf("  error: %d", r->result);
+	} else if (r->in_size) {
+		printf("  rd");
+		for (i = 0; i < in_count; i++)
+			printf(" 0x%02x", r->data[out_count + i]);
+		if (r->in_size > in_count)
+			printf(" ... (%u bytes)", r->in_size);
+	}
+	printf("\n");
+}
+
+static void i2c_trace_pcap(FILE *pcap, const struct ec_i2c_trace_record *r)
+{
+	uint8_t buf[sizeof(struct pcap_i2c_trace_header) +
+		    EC_I2C_TRACE_DATA_SIZE];
+	struct pcap_i2c_trace_header th = {
+		.port = r->port,
+		.addr = r->addr,
+		.out_size = htole16(r->out_size),
+		.in_size = htole16(r->in_size),
+		.result = (int16_t)htole16(r->result),
+		.duration = htole16(r->duration),
+	};
+	int out_count = MIN(r->out_size, EC_I2C_TRACE_DATA_SIZE);
+	int in_count = r->result ? 0 :
+				   MIN(r->in_size,
+				       EC_I2C_TRACE_DATA_SIZE - out_count);
+	struct timeval tv;
+
+	memcpy(buf, &th, sizeof(th));
+	memcpy(&buf[sizeof(th)], r->data, out_count + in_count);
+
+	tv.tv_sec = r->timestamp / 1000000;
+	tv.tv_usec = r->timestamp % 1000000;
+	pdc_pcap_append(pcap, tv, buf, sizeof(th) + out_count + in_count);
+}
+
+int cmd_i2c_trace(int argc, char *argv[])
+{
+	struct ec_response_i2c_trace_read *r =
+		(struct ec_response_i2c_trace_read *)ec_inbuf;
+	bool follow = false;
+	bool with_stdout = true;
+	bool s_flag = false;
+	FILE *pcap = NULL;
+	int rv, c, i;
+
+	optind = 0; /* reset previous getopt */
+
+	while ((c = getopt(argc, argv, "fsw:")) != -1) {
+		switch (c) {
+		case 'f':
+			follow = true;
+			break;
+		case 's':
+			s_flag = true;
+			break;
+		case 'w':
+			if (pcap)
+				pdc_pcap_close(pcap);
+			pcap = pdc_pcap_open(optarg);
+			if (pcap == NULL)
+				return -1;
+			with_stdout = false;
+			break;
+		default:
+			pdc_pcap_close(pcap);
+			fprintf(stderr, "Usage: %s %s\n", argv[0],
+				cmd_i2c_trace_usage);
+			return -1;
+		}
+	}
+	if (optind != argc) {
+		pdc_pcap_close(pcap);
+		fprintf(stderr, "Usage: %s %s\n", argv[0], cmd_i2c_trace_usage);
+		return -1;
+	}
+	if (s_flag)
+		with_stdout = true;
+
+	while (1) {
+		rv = ec_command(EC_CMD_I2C_TRACE_READ, 0, NULL, 0, r,
+				ec_max_insize);
+		if (rv < 0)
+			break;
+
+		if (r->lost)
+			fprintf(stderr, "%u records lost\n", r->lost);
+		for (i = 0; i < r->count; i++) {
+			if (with_stdout)
+				i2c_trace_print(&r->records[i]);
+			if (pcap)
+				i2c_trace_pcap(pcap, &r->records[i]);
+		}
+
+		if (r->count == 0) {
+			if (!follow) {
+				rv = 0;
+				break;
+			}
+			if (pcap)
+				fflush(pcap);
+			usleep(100 * 1000); /* 100 ms */
+		}
+	}
+
+	pdc_pcap_close(pcap);
+
+	return rv < 0 ? rv : 0;
+}
+
+static void i2c_stats_print(const struct ec_response_i2c_stats *r)
+{
+	const struct ec_i2c_stats *st = &r->stats;
+	int i;
+
+	if (r->addr == EC_I2C_STATS_NO_ADDR)
+		printf("%4u     ", r->port);
+	else
+		printf("%4u 0x%02x", r->port, r->addr);
+	printf(" %9u %7u %7u %7u %10u %10u %9u", st->xfers, st->errors,
+	       st->nacks, st->retries, st->bytes_out, st->bytes_in,
+	       st->busy_us / 1000);
+	/* Share of the time since the last reset spent in transfers */
+	if (r->elapsed_ms)
+		printf(" %6.2f", st->busy_us / (r->elapsed_ms * 10.0));
+	else
+		printf(" %6s", "-");
+	if (r->addr == EC_I2C_STATS_NO_ADDR)
+		printf(" %9u", st->lock_wait_us / 1000);
+	printf("\n          latency us:");
+	for (i = 0; i < EC_I2C_STATS_HIST_BUCKETS - 1; i++)
+		printf(" <%u:%u", EC_I2C_STATS_HIST_BASE_US << i, st->hist[i]);
+	printf(" >=%u:%u\n",
+	       EC_I2C_STATS_HIST_BASE_US << (EC_I2C_STATS_HIST_BUCKETS - 2),
+	       st->hist[EC_I2C_STATS_HIST_BUCKETS - 1]);
+}
+
+static int i2c_stats_print_all(enum ec_i2c_stats_cmd cmd)
+{
+	struct ec_params_i2c_stats p;
+	struct ec_response_i2c_stats r;
+	int rv;
+
+	p.cmd = cmd;
+	p.index = 0;
+	do {
+		rv = ec_command(EC_CMD_I2C_STATS, 0, &p, sizeof(p), &r,
+				sizeof(r));
+		if (rv < 0)
+			return rv;
+		if (p.index >= r.count)
+			break;
+		/* Skip the ports not used. */
+		if (r.stats.xfers || r.stats.lock_wait_us)
+			i2c_stats_print(&r);
+	} while (++p.index < r.count);
+
+	return 0;
+}
+
+int cmd_i2c_stats(int argc, char *argv[])
+{
+	struct ec_params_i2c_stats p;
+	int rv;
+
+	if (argc == 2 && !strcmp(argv[1], "reset")) {
+		p.cmd = EC_I2C_STATS_RESET;
+		p.index = 0;
+		rv = ec_command(EC_CMD_I2C_STATS, 0, &p, sizeof(p), NULL, 0);
+		return rv < 0 ? rv : 0;
+	}
+	if (argc != 1) {
+		fprintf(stderr, "Usage: %s [reset]\n", argv[0]);
+		return -1;
+	}
+
+	printf("port addr     xfers  errors   nacks retries  bytes_out"
+	       "   bytes_in   busy_ms  busy%%   lock_ms\n");
+	rv = i2c_stats_print_all(EC_I2C_STATS_GET_PORT);
+	if (rv < 0)
+		return rv;
+	return i2c_stats_print_all(EC_I2C_STATS_GET_ADDR);
+}
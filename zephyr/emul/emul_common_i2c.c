@@ -285,6 +285,7 @@ int i2c_common_emul_transfer_workhorse(const struct emul *target,
 	}
 
 	i2c_dump_msgs(target->dev, msgs, num_msgs, addr);
+	data->transfer_count++;
 
 	for (; num_msgs > 0; num_msgs--, msgs++) {
 		read = msgs->flags & I2C_MSG_READ;
@@ -303,6 +304,22 @@ int i2c_common_emul_transfer_workhorse(const struct emul *target,
 				if (ret) {
 					return ret;
 				}
+			} else if (msgs->flags & I2C_MSG_RESTART) {
+				/* Repeated start, begin a new write */
+				data->msg_state = I2C_COMMON_EMUL_NONE_MSG;
+				ret = i2c_common_emul_finish_write(target,
+								   data);
+				if (ret) {
+					return ret;
+				}
+				if (msgs->len == 0) {
+					continue;
+				}
+				data->cur_reg = msgs->buf[0];
+				ret = i2c_common_emul_start_write(target, data);
+				if (ret) {
+					return ret;
+				}
 			}
 			break;
 		case I2C_COMMON_EMUL_IN_READ:
@@ -423,6 +440,7 @@ void i2c_common_emul_init(struct i2c_common_emul_data *data)
 	data->msg_state = I2C_COMMON_EMUL_NONE_MSG;
 	data->msg_byte = 0;
 	data->cur_reg = 0;
+	data->transfer_count = 0;
 
 	data->write_func = NULL;
 	data->read_func = NULL;
@@ -237,6 +237,8 @@ struct i2c_common_emul_data {
 	int msg_byte;
 	/** Register selected in last write command */
 	uint8_t cur_reg;
+	/** Number of transfers (i2c_transfer() calls) handled */
+	int transfer_count;
 
 	/** Custom write function called on I2C write opperation */
 	i2c_common_emul_write_func write_func;
@@ -799,6 +799,11 @@ extern char mock_jump_data[CONFIG_PLATFORM_EC_PRESERVED_END_OF_RAM_SIZE];
 #define CONFIG_I2C_DEBUG
 #endif
 
+#undef CONFIG_I2C_TRACE_SIZE
+#ifdef CONFIG_PLATFORM_EC_I2C_TRACE_SIZE
+#define CONFIG_I2C_TRACE_SIZE CONFIG_PLATFORM_EC_I2C_TRACE_SIZE
+#endif
+
 #undef CONFIG_I2C_DEBUG_PASSTHRU
 #ifdef CONFIG_PLATFORM_EC_I2C_DEBUG_PASSTHRU
 #define CONFIG_I2C_DEBUG_PASSTHRU
@@ -819,6 +824,26 @@ extern char mock_jump_data[CONFIG_PLATFORM_EC_PRESERVED_END_OF_RAM_SIZE];
 #define CONFIG_I2C_UPDATE_IF_CHANGED
 #endif
 
+#undef CONFIG_I2C_XFER_ASYNC
+#ifdef CONFIG_PLATFORM_EC_I2C_XFER_ASYNC
+#define CONFIG_I2C_XFER_ASYNC
+#endif
+
+#undef CONFIG_I2C_REGCACHE
+#ifdef CONFIG_PLATFORM_EC_I2C_REGCACHE
+#define CONFIG_I2C_REGCACHE
+#endif
+
+#undef CONFIG_I2C_STATS
+#ifdef CONFIG_PLATFORM_EC_I2C_STATS
+#define CONFIG_I2C_STATS
+#endif
+
+#undef CONFIG_I2C_STATS_ADDRS
+#ifdef CONFIG_PLATFORM_EC_I2C_STATS_ADDRS
+#define CONFIG_I2C_STATS_ADDRS CONFIG_PLATFORM_EC_I2C_STATS_ADDRS
+#endif
+
 #undef CONFIG_KEYBOARD_PROTOCOL_8042
 #ifdef CONFIG_PLATFORM_EC_KEYBOARD_PROTOCOL_8042
 #define CONFIG_KEYBOARD_PROTOCOL_8042
@@ -1092,6 +1117,11 @@ extern char mock_jump_data[CONFIG_PLATFORM_EC_PRESERVED_END_OF_RAM_SIZE];
 #define CONFIG_POWERSEQ_S0IX_COUNTER
 #endif
 
+#undef CONFIG_HOOK_TICKLESS
+#ifdef CONFIG_PLATFORM_EC_HOOK_TICKLESS
+#define CONFIG_HOOK_TICKLESS
+#endif
+
 #undef CONFIG_HOSTCMD_AP_RESET
 #ifdef CONFIG_PLATFORM_EC_HOSTCMD_AP_RESET
 #define CONFIG_HOSTCMD_AP_RESET
@@ -2413,6 +2443,18 @@ extern char mock_jump_data[CONFIG_PLATFORM_EC_PRESERVED_END_OF_RAM_SIZE];
 #define CONFIG_ACCEL_FIFO_THRES CONFIG_PLATFORM_EC_ACCEL_FIFO_THRES
 #endif /* CONFIG_PLATFORM_EC_ACCEL_FIFO */
 
+#undef CONFIG_ACCEL_TRACE
+#undef CONFIG_ACCEL_TRACE_SIZE
+#ifdef CONFIG_PLATFORM_EC_ACCEL_TRACE
+#define CONFIG_ACCEL_TRACE
+#define CONFIG_ACCEL_TRACE_SIZE CONFIG_PLATFORM_EC_ACCEL_TRACE_SIZE
+#endif /* CONFIG_PLATFORM_EC_ACCEL_TRACE */
+
+#undef CONFIG_STILLNESS_DETECTOR
+#ifdef CONFIG_PLATFORM_EC_STILLNESS_DETECTOR
+#define CONFIG_STILLNESS_DETECTOR
+#endif
+
 #undef CONFIG_BODY_DETECTION
 #undef CONFIG_BODY_DETECTION_SENSOR
 #undef CONFIG_BODY_DETECTION_MAX_WINDOW_SIZE
@@ -2526,6 +2568,11 @@ BUILD_ASSERT(!DT_NODE_EXISTS(DT_ALIAS(on_body_sensor)),
 #define CONFIG_LID_ANGLE_UPDATE
 #endif
 
+#undef CONFIG_LID_ANGLE_ATAN_TABLE
+#ifdef CONFIG_PLATFORM_EC_LID_ANGLE_ATAN_TABLE
+#define CONFIG_LID_ANGLE_ATAN_TABLE
+#endif
+
 #undef CONFIG_TABLET_MODE
 #ifdef CONFIG_PLATFORM_EC_TABLET_MODE
 #define CONFIG_TABLET_MODE
@@ -2616,6 +2663,11 @@ BUILD_ASSERT(!DT_NODE_EXISTS(DT_ALIAS(on_body_sensor)),
 #define CONFIG_ALS_TCS3400
 #endif
 
+#undef CONFIG_ALS_PROCESS
+#ifdef CONFIG_PLATFORM_EC_ALS_PROCESS
+#define CONFIG_ALS_PROCESS
+#endif
+
 #undef CONFIG_ALS_VEML3328
 #ifdef CONFIG_PLATFORM_EC_ALS_VEML3328
 #define CONFIG_ALS_VEML3328
@@ -2665,6 +2717,11 @@ BUILD_ASSERT((DT_NUM_INST_STATUS_OKAY(maxim_max695x)) == 1,
 #define CONFIG_CMD_SEVEN_SEG_DISPLAY
 #endif
 
+#undef CONFIG_HOSTCMD_BATCH
+#ifdef CONFIG_PLATFORM_EC_HOSTCMD_BATCH
+#define CONFIG_HOSTCMD_BATCH
+#endif
+
 #undef CONFIG_HOSTCMD_GET_UPTIME_INFO
 #ifdef CONFIG_PLATFORM_EC_HOSTCMD_GET_UPTIME_INFO
 #define CONFIG_HOSTCMD_GET_UPTIME_INFO
@@ -2871,6 +2928,11 @@ BUILD_ASSERT(DT_REG_SIZE(DT_NODELABEL(rollback0)) ==
 #define CONFIG_SHA256_UNROLLED
 #endif
 
+#undef CONFIG_SW_CRC_SLICES
+#ifdef CONFIG_PLATFORM_EC_SW_CRC_SLICES
+#define CONFIG_SW_CRC_SLICES CONFIG_PLATFORM_EC_SW_CRC_SLICES
+#endif
+
 #undef CONFIG_RO_HDR_MEM_OFF
 #ifdef CONFIG_PLATFORM_EC_RO_HEADER_OFFSET
 #define CONFIG_RO_HDR_MEM_OFF CONFIG_PLATFORM_EC_RO_HEADER_OFFSET
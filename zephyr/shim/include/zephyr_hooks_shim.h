@@ -67,6 +67,14 @@ struct zephyr_shim_hook_list {
 		.priority = _priority,                                     \
 	}
 
+/*
+ * Hooks run from the system work queue, which has no hook task tick to
+ * coalesce, so the allowed jitter is ignored. CONFIG_HOOK_TICKLESS only skips
+ * the periodic hook types without routines.
+ */
+#define DECLARE_HOOK_WITH_JITTER(_hooktype, _routine, _priority, _jitter_ms) \
+	DECLARE_HOOK(_hooktype, _routine, _priority)
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -50,12 +50,18 @@ k_tid_t get_hostcmd_thread(void);
 
 #else
 
-#define DECLARE_HOST_COMMAND(_command, _routine, _version_mask)         \
-	static const STRUCT_SECTION_ITERABLE(host_command,              \
-					     _cros_hcmd_##_command) = { \
-		.handler = _routine,                                    \
-		.command = _command,                                    \
-		.version_mask = _version_mask,                          \
+/*
+ * The section is named after the expanded command number rather than the
+ * variable name, so the iterable section (sorted by name at link time) ends up
+ * ordered by command and can be binary searched. As with the legacy
+ * .rodata.hcmds section, commands must be 4-digit upper case hex values.
+ */
+#define DECLARE_HOST_COMMAND(_command, _routine, _version_mask)           \
+	static const STRUCT_SECTION_ITERABLE_NAMED(host_command, _command, \
+						   _cros_hcmd_##_command) = { \
+		.handler = _routine,                                      \
+		.command = _command,                                      \
+		.version_mask = _version_mask,                            \
 	}
 
 #endif /* CONFIG_EC_HOST_CMD */
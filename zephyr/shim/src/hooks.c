@@ -52,6 +52,16 @@ static K_WORK_DELAYABLE_DEFINE(hook_seconds_work_data, hook_second_work);
 #endif /* CONFIG_PLATFORM_EC_HOOK_SECOND */
 static K_WORK_DELAYABLE_DEFINE(hook_ticks_work_data, hook_tick_work);
 
+/*
+ * With CONFIG_HOOK_TICKLESS, the work of a periodic hook type without routines
+ * is never scheduled.
+ */
+static bool periodic_hook_needed(enum hook_type type)
+{
+	return !IS_ENABLED(CONFIG_HOOK_TICKLESS) ||
+	       hook_registry[type].start != hook_registry[type].end;
+}
+
 /* LCOV_EXCL_START informational only; should never happen */
 static void work_queue_error(const void *data, int rv)
 {
@@ -104,20 +114,24 @@ static int zephyr_shim_setup_hooks(void)
 
 #ifdef CONFIG_PLATFORM_EC_HOOK_SECOND
 	/* Startup the HOOK_SECOND recurring work */
-	rv = k_work_reschedule(&hook_seconds_work_data, K_SECONDS(1));
-	/* LCOV_EXCL_START cannot fail unless delay = K_NO_WAIT */
-	if (rv < 0)
-		work_queue_error(&hook_seconds_work_data, rv);
-	/* LCOV_EXCL_STOP */
+	if (periodic_hook_needed(HOOK_SECOND)) {
+		rv = k_work_reschedule(&hook_seconds_work_data, K_SECONDS(1));
+		/* LCOV_EXCL_START cannot fail unless delay = K_NO_WAIT */
+		if (rv < 0)
+			work_queue_error(&hook_seconds_work_data, rv);
+		/* LCOV_EXCL_STOP */
+	}
 #endif /* CONFIG_PLATFORM_EC_HOOK_SECOND */
 
 	/* Startup the HOOK_TICK recurring work */
-	rv = k_work_reschedule(&hook_ticks_work_data,
-			       K_USEC(HOOK_TICK_INTERVAL));
-	/* LCOV_EXCL_START cannot fail unless delay = K_NO_WAIT */
-	if (rv < 0)
-		work_queue_error(&hook_ticks_work_data, rv);
-	/* LCOV_EXCL_STOP */
+	if (periodic_hook_needed(HOOK_TICK)) {
+		rv = k_work_reschedule(&hook_ticks_work_data,
+				       K_USEC(HOOK_TICK_INTERVAL));
+		/* LCOV_EXCL_START cannot fail unless delay = K_NO_WAIT */
+		if (rv < 0)
+			work_queue_error(&hook_ticks_work_data, rv);
+		/* LCOV_EXCL_STOP */
+	}
 
 	return 0;
 }
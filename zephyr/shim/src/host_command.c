@@ -90,13 +90,20 @@ BUILD_ASSERT(offsetof(struct ec_host_response, reserved) ==
 
 struct host_command *zephyr_find_host_command(int command)
 {
-	STRUCT_SECTION_FOREACH(host_command, cmd)
-	{
-		if (cmd->command == command)
-			return cmd;
-	}
+	struct host_command *table;
+	int count;
+
+	/*
+	 * DECLARE_HOST_COMMAND() names each entry's section after its command
+	 * number, so the linker emits the section sorted by command.
+	 */
+	STRUCT_SECTION_COUNT(host_command, &count);
+	if (count == 0)
+		return NULL;
+	STRUCT_SECTION_GET(host_command, 0, &table);
 
-	return NULL;
+	return (struct host_command *)host_command_find_sorted(table, count,
+							       command);
 }
 
 #ifdef CONFIG_EC_HOST_CMD
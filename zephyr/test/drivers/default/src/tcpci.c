@@ -172,6 +172,58 @@ ZTEST(tcpci, test_generic_tcpci_alert)
 	test_tcpci_alert(emul, common_data, USBC_PORT_C0);
 }
 
+/** Test the I2C transactions of a TCPCI alert */
+ZTEST(tcpci, test_generic_tcpci_alert_transfers)
+{
+	const struct emul *emul = EMUL_DT_GET(TCPCI_EMUL_NODE);
+	struct i2c_common_emul_data *common_data =
+		emul_tcpci_generic_get_i2c_common_data(emul);
+
+	tcpci_emul_set_reg(emul, TCPC_REG_ALERT,
+			   TCPC_REG_ALERT_ALERT_EXT | TCPC_REG_ALERT_FAULT);
+	tcpci_emul_set_reg(emul, TCPC_REG_ALERT_EXT,
+			   TCPC_REG_ALERT_EXT_TIMER_EXPIRED);
+	tcpci_emul_set_reg(emul, TCPC_REG_FAULT_STATUS,
+			   TCPC_REG_FAULT_STATUS_VCONN_OVER_CURRENT);
+	common_data->transfer_count = 0;
+	tcpci_tcpc_alert(USBC_PORT_C0);
+
+	/*
+	 * Read ALERT, read ALERT_EXT and FAULT_STATUS, clear the fault (2),
+	 * read TCPC_CTRL, clear ALERT_EXT and ALERT, read the masks. One
+	 * transaction per register would take 10.
+	 */
+	zassert_equal(common_data->transfer_count, 7, "got %d",
+		      common_data->transfer_count);
+	check_tcpci_reg(emul, TCPC_REG_ALERT, 0x0);
+	check_tcpci_reg(emul, TCPC_REG_FAULT_STATUS, 0x0);
+}
+
+/** Test a failed read of ALERT_EXT does not lose FAULT_STATUS */
+ZTEST(tcpci, test_generic_tcpci_alert_ext_read_fail)
+{
+	const struct emul *emul = EMUL_DT_GET(TCPCI_EMUL_NODE);
+	struct i2c_common_emul_data *common_data =
+		emul_tcpci_generic_get_i2c_common_data(emul);
+
+	tcpci_emul_set_reg(emul, TCPC_REG_ALERT,
+			   TCPC_REG_ALERT_ALERT_EXT | TCPC_REG_ALERT_FAULT);
+	tcpci_emul_set_reg(emul, TCPC_REG_ALERT_EXT,
+			   TCPC_REG_ALERT_EXT_TIMER_EXPIRED);
+	tcpci_emul_set_reg(emul, TCPC_REG_FAULT_STATUS,
+			   TCPC_REG_FAULT_STATUS_VCONN_OVER_CURRENT);
+	i2c_common_emul_set_read_fail_reg(common_data, TCPC_REG_ALERT_EXT);
+	tcpci_tcpc_alert(USBC_PORT_C0);
+	i2c_common_emul_set_read_fail_reg(common_data,
+					  I2C_COMMON_EMUL_NO_FAIL_REG);
+
+	/* The fault was still read, handled and cleared. */
+	check_tcpci_reg(emul, TCPC_REG_FAULT_STATUS, 0x0);
+
+	tcpci_emul_set_reg(emul, TCPC_REG_ALERT_EXT, 0);
+	tcpci_emul_set_reg(emul, TCPC_REG_ALERT, 0);
+}
+
 /** Test TCPCI alert RX message */
 ZTEST(tcpci, test_generic_tcpci_alert_rx_message)
 {
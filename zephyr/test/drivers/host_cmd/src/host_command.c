@@ -10,6 +10,7 @@
 #include "uart.h"
 
 #include <zephyr/shell/shell_dummy.h>
+#include <zephyr/sys/iterable_sections.h>
 #include <zephyr/ztest.h>
 
 ZTEST(host_cmd_host_commands, test_get_command_versions__v1)
@@ -74,6 +75,22 @@ ZTEST(host_cmd_host_commands, test_resend_response)
 	 */
 }
 
+ZTEST(host_cmd_host_commands, test_host_command_table_sorted)
+{
+	int last_command = -1;
+
+	/* zephyr_find_host_command() binary searches the section */
+	STRUCT_SECTION_FOREACH(host_command, cmd)
+	{
+		zassert_true(cmd->command > last_command,
+			     "0x%04x is out of order", cmd->command);
+		zassert_equal_ptr(cmd, find_host_command(cmd->command));
+		last_command = cmd->command;
+	}
+
+	zassert_is_null(find_host_command(UINT16_MAX));
+}
+
 #else
 ZTEST(host_cmd_host_commands, test_resend_response)
 {
@@ -0,0 +1,305 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "emul/emul_common_i2c.h"
+#include "emul/i2c_mock.h"
+#include "hooks.h"
+#include "i2c.h"
+#include "i2c/i2c.h"
+#include "test/drivers/test_state.h"
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#define MOCK_EMUL EMUL_DT_GET(DT_NODELABEL(i2c_mock))
+#define COMMON_DATA emul_i2c_mock_get_i2c_common_data(MOCK_EMUL)
+#define MOCK_PORT I2C_PORT_BY_DEV(DT_NODELABEL(i2c_mock))
+
+/* Register written by each source of transfers */
+#define REG_ASYNC_A 0x10
+#define REG_ASYNC_B 0x11
+#define REG_BLOCKING 0x20
+
+#define XFER_COUNT 16
+
+/* Writes seen by the mock, in bus order */
+static struct {
+	uint8_t reg;
+	uint8_t val;
+} writes[3 * XFER_COUNT];
+static atomic_t write_count;
+
+static K_SEM_DEFINE(xfer_done, 0, 3 * XFER_COUNT);
+
+static int mock_write_fn(const struct emul *emul, int reg, uint8_t val,
+			 int bytes, void *data)
+{
+	int i = atomic_inc(&write_count);
+
+	if (i < ARRAY_SIZE(writes)) {
+		writes[i].reg = reg;
+		writes[i].val = val;
+	}
+	return 0;
+}
+
+static void xfer_done_cb(struct i2c_xfer_desc *desc)
+{
+	k_sem_give(&xfer_done);
+}
+
+struct async_source {
+	uint8_t buf[XFER_COUNT][2];
+	struct i2c_xfer_desc desc[XFER_COUNT];
+};
+
+static struct async_source source_a, source_b;
+
+static void submit_all(struct async_source *src, uint8_t reg)
+{
+	for (int i = 0; i < XFER_COUNT; i++) {
+		struct i2c_xfer_desc *desc = &src->desc[i];
+
+		src->buf[i][0] = reg;
+		src->buf[i][1] = i;
+		*desc = (struct i2c_xfer_desc){
+			.port = MOCK_PORT,
+			.addr_flags = i2c_mock_get_addr(MOCK_EMUL),
+			.out = src->buf[i],
+			.out_size = sizeof(src->buf[i]),
+			.done = xfer_done_cb,
+		};
+		zassert_ok(i2c_xfer_submit(desc));
+		/* Let the other sources interleave with this one. */
+		k_yield();
+	}
+}
+
+/* Check the writes of one source reached the bus in submission order. */
+static void check_order(uint8_t reg)
+{
+	int expected = 0;
+
+	for (int i = 0; i < atomic_get(&write_count); i++) {
+		if (writes[i].reg != reg)
+			continue;
+		zassert_equal(writes[i].val, expected, "reg %02x: got %d at %d",
+			      reg, writes[i].val, i);
+		expected++;
+	}
+	zassert_equal(expected, XFER_COUNT, "reg %02x: %d writes", reg,
+		      expected);
+}
+
+ZTEST(i2c_async, test_submit_in_order)
+{
+	submit_all(&source_a, REG_ASYNC_A);
+
+	for (int i = 0; i < XFER_COUNT; i++)
+		zassert_ok(k_sem_take(&xfer_done, K_SECONDS(1)));
+	for (int i = 0; i < XFER_COUNT; i++)
+		zassert_ok(source_a.desc[i].result);
+	check_order(REG_ASYNC_A);
+}
+
+ZTEST(i2c_async, test_busy_while_queued)
+{
+	struct i2c_xfer_desc *desc = &source_a.desc[0];
+	uint8_t buf[2] = { REG_ASYNC_A, 0 };
+
+	*desc = (struct i2c_xfer_desc){
+		.port = MOCK_PORT,
+		.addr_flags = i2c_mock_get_addr(MOCK_EMUL),
+		.out = buf,
+		.out_size = sizeof(buf),
+		.done = xfer_done_cb,
+	};
+
+	/* Hold the port, as a blocking transfer would. */
+	i2c_lock(MOCK_PORT, 1);
+	zassert_ok(i2c_xfer_submit(desc));
+	k_msleep(10);
+	zassert_equal(atomic_get(&write_count), 0);
+	zassert_equal(desc->state, I2C_XFER_QUEUED);
+	zassert_equal(i2c_xfer_submit(desc), EC_ERROR_BUSY);
+	i2c_lock(MOCK_PORT, 0);
+
+	zassert_ok(k_sem_take(&xfer_done, K_SECONDS(1)));
+	zassert_equal(desc->state, I2C_XFER_DONE);
+	zassert_ok(desc->result);
+	zassert_equal(atomic_get(&write_count), 1);
+
+	/* Once done, the descriptor can be submitted again. */
+	zassert_ok(i2c_xfer_submit(desc));
+	zassert_ok(k_sem_take(&xfer_done, K_SECONDS(1)));
+	zassert_equal(atomic_get(&write_count), 2);
+}
+
+ZTEST(i2c_async, test_error_result)
+{
+	struct i2c_xfer_desc *desc = &source_a.desc[0];
+	uint8_t buf[2] = { REG_ASYNC_A, 0 };
+
+	*desc = (struct i2c_xfer_desc){
+		.port = MOCK_PORT,
+		.addr_flags = i2c_mock_get_addr(MOCK_EMUL),
+		.out = buf,
+		.out_size = sizeof(buf),
+		.done = xfer_done_cb,
+	};
+	i2c_common_emul_set_write_fail_reg(COMMON_DATA,
+					   I2C_COMMON_EMUL_FAIL_ALL_REG);
+
+	zassert_ok(i2c_xfer_submit(desc));
+	zassert_ok(k_sem_take(&xfer_done, K_SECONDS(1)));
+	zassert_equal(desc->result, EC_ERROR_INVAL, "got %d", desc->result);
+}
+
+ZTEST(i2c_async, test_busy_result_is_final)
+{
+	struct i2c_xfer_desc *desc = &source_a.desc[0];
+	uint8_t buf[2] = { REG_ASYNC_A, 0 };
+
+	/* A finished transfer that failed with a busy bus. */
+	*desc = (struct i2c_xfer_desc){
+		.port = MOCK_PORT,
+		.addr_flags = i2c_mock_get_addr(MOCK_EMUL),
+		.out = buf,
+		.out_size = sizeof(buf),
+		.done = xfer_done_cb,
+		.state = I2C_XFER_DONE,
+		.result = EC_ERROR_BUSY,
+	};
+
+	/* The result does not keep the descriptor from being submitted. */
+	zassert_ok(i2c_xfer_submit(desc));
+	zassert_ok(k_sem_take(&xfer_done, K_SECONDS(1)));
+	zassert_ok(desc->result);
+	zassert_equal(atomic_get(&write_count), 1);
+}
+
+static atomic_t deferred_ran;
+
+static void async_deferred(void)
+{
+	atomic_set(&deferred_ran, 1);
+}
+DECLARE_DEFERRED(async_deferred);
+
+ZTEST(i2c_async, test_waiting_port_does_not_block_hooks)
+{
+	struct i2c_xfer_desc *desc = &source_a.desc[0];
+	uint8_t buf[2] = { REG_ASYNC_A, 0 };
+
+	*desc = (struct i2c_xfer_desc){
+		.port = MOCK_PORT,
+		.addr_flags = i2c_mock_get_addr(MOCK_EMUL),
+		.out = buf,
+		.out_size = sizeof(buf),
+		.done = xfer_done_cb,
+	};
+
+	/* The transfer waits for the port in the port's own thread. */
+	i2c_lock(MOCK_PORT, 1);
+	zassert_ok(i2c_xfer_submit(desc));
+	zassert_ok(hook_call_deferred(&async_deferred_data, 0));
+	k_msleep(10);
+	zassert_equal(atomic_get(&deferred_ran), 1);
+	zassert_equal(atomic_get(&write_count), 0);
+	i2c_lock(MOCK_PORT, 0);
+
+	zassert_ok(k_sem_take(&xfer_done, K_SECONDS(1)));
+	zassert_ok(desc->result);
+}
+
+ZTEST(i2c_async, test_invalid_port)
+{
+	struct i2c_xfer_desc desc = {
+		.port = I2C_PORT_COUNT,
+	};
+
+	zassert_equal(i2c_xfer_submit(&desc), EC_ERROR_INVAL);
+	zassert_equal(desc.state, I2C_XFER_IDLE);
+}
+
+#define CONTENDER_STACK_SIZE 1024
+
+static K_THREAD_STACK_DEFINE(contender_a_stack, CONTENDER_STACK_SIZE);
+static K_THREAD_STACK_DEFINE(contender_b_stack, CONTENDER_STACK_SIZE);
+static K_THREAD_STACK_DEFINE(blocking_stack, CONTENDER_STACK_SIZE);
+static struct k_thread contender_a, contender_b, blocking;
+static int blocking_errors;
+
+static void async_contender(void *src, void *reg, void *unused)
+{
+	submit_all(src, POINTER_TO_UINT(reg));
+}
+
+static void blocking_contender(void *unused1, void *unused2, void *unused3)
+{
+	for (int i = 0; i < XFER_COUNT; i++) {
+		uint8_t buf[2] = { REG_BLOCKING, i };
+
+		if (i2c_xfer(MOCK_PORT, i2c_mock_get_addr(MOCK_EMUL), buf,
+			     sizeof(buf), NULL, 0))
+			blocking_errors++;
+		k_yield();
+	}
+}
+
+ZTEST(i2c_async, test_contention)
+{
+	k_tid_t tids[3];
+
+	tids[0] = k_thread_create(&contender_a, contender_a_stack,
+				  K_THREAD_STACK_SIZEOF(contender_a_stack),
+				  async_contender, &source_a,
+				  UINT_TO_POINTER(REG_ASYNC_A), NULL, -1, 0,
+				  K_NO_WAIT);
+	tids[1] = k_thread_create(&contender_b, contender_b_stack,
+				  K_THREAD_STACK_SIZEOF(contender_b_stack),
+				  async_contender, &source_b,
+				  UINT_TO_POINTER(REG_ASYNC_B), NULL, -1, 0,
+				  K_NO_WAIT);
+	tids[2] = k_thread_create(&blocking, blocking_stack,
+				  K_THREAD_STACK_SIZEOF(blocking_stack),
+				  blocking_contender, NULL, NULL, NULL, -1, 0,
+				  K_NO_WAIT);
+
+	for (int i = 0; i < ARRAY_SIZE(tids); i++)
+		zassert_ok(k_thread_join(tids[i], K_SECONDS(1)));
+	for (int i = 0; i < 2 * XFER_COUNT; i++)
+		zassert_ok(k_sem_take(&xfer_done, K_SECONDS(1)));
+
+	zassert_equal(blocking_errors, 0);
+	for (int i = 0; i < XFER_COUNT; i++) {
+		zassert_ok(source_a.desc[i].result);
+		zassert_ok(source_b.desc[i].result);
+	}
+	zassert_equal(atomic_get(&write_count), 3 * XFER_COUNT);
+	check_order(REG_ASYNC_A);
+	check_order(REG_ASYNC_B);
+	check_order(REG_BLOCKING);
+}
+
+static void i2c_async_before(void *fixture)
+{
+	i2c_mock_reset(MOCK_EMUL);
+	i2c_common_emul_set_write_func(COMMON_DATA, mock_write_fn, NULL);
+	atomic_set(&write_count, 0);
+	k_sem_reset(&xfer_done);
+	atomic_set(&deferred_ran, 0);
+	blocking_errors = 0;
+}
+
+static void i2c_async_after(void *fixture)
+{
+	i2c_common_emul_set_write_func(COMMON_DATA, NULL, NULL);
+	i2c_common_emul_set_write_fail_reg(COMMON_DATA,
+					   I2C_COMMON_EMUL_NO_FAIL_REG);
+}
+
+ZTEST_SUITE(i2c_async, drivers_predicate_post_main, NULL, i2c_async_before,
+	    i2c_async_after, NULL);
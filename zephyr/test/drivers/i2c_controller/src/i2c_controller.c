@@ -389,6 +389,67 @@ ZTEST_F(i2c_controller, test_i2c_xfer_unlocked__error_paths)
 		      fixture->port);
 }
 
+ZTEST_F(i2c_controller, test_i2c_xfer_vec)
+{
+	const uint8_t reg_a = 0x10;
+	const uint8_t reg_b = 0x40;
+	const uint8_t write[] = { 0x20, 0xAA, 0xBB };
+	uint8_t in_a[2];
+	uint8_t in_b[1];
+	const struct i2c_xfer_seg segs[] = {
+		{ .out = &reg_a, .out_size = 1, .in = in_a, .in_size = 2 },
+		{ .out = &reg_b, .out_size = 1, .in = in_b, .in_size = 1 },
+		{ .out = write, .out_size = sizeof(write) },
+	};
+
+	fixture->emul_data->regs[0x10] = 0x12;
+	fixture->emul_data->regs[0x11] = 0x34;
+	fixture->emul_data->regs[0x40] = 0x56;
+
+	/* Non-contiguous reads and a write, in one transaction */
+	zassert_ok(i2c_xfer_vec(fixture->port, fixture->addr, segs,
+				ARRAY_SIZE(segs)));
+
+	zassert_equal(in_a[0], 0x12);
+	zassert_equal(in_a[1], 0x34);
+	zassert_equal(in_b[0], 0x56);
+	zassert_equal(fixture->emul_data->regs[0x20], 0xAA);
+	zassert_equal(fixture->emul_data->regs[0x21], 0xBB);
+}
+
+ZTEST_F(i2c_controller, test_i2c_xfer_vec__error_paths)
+{
+	const uint8_t reg = 0;
+	uint8_t in;
+	struct i2c_xfer_seg segs[I2C_XFER_VEC_MAX_SEGS + 1];
+
+	for (int i = 0; i < ARRAY_SIZE(segs); i++)
+		segs[i] = (struct i2c_xfer_seg){
+			.out = &reg, .out_size = 1, .in = &in, .in_size = 1
+		};
+
+	/* Segment count limits */
+	zassert_equal(i2c_xfer_vec(fixture->port, fixture->addr, segs, 0),
+		      EC_ERROR_INVAL);
+	zassert_equal(i2c_xfer_vec(fixture->port, fixture->addr, segs,
+				   ARRAY_SIZE(segs)),
+		      EC_ERROR_INVAL);
+
+	/* PEC is not supported */
+	zassert_equal(i2c_xfer_vec(fixture->port, fixture->addr | I2C_FLAG_PEC,
+				   segs, 1),
+		      EC_ERROR_INVAL);
+
+	/* No lock */
+	zassert_equal(i2c_xfer_vec_unlocked(fixture->port, fixture->addr, segs,
+					    1),
+		      EC_ERROR_INVAL);
+
+	/* Fail by reading from wrong address */
+	zassert_equal(i2c_xfer_vec(fixture->port, fixture->addr + 1, segs, 2),
+		      EC_ERROR_INVAL);
+}
+
 static struct i2c_controller_fixture i2c_controller_fixture;
 
 static void *setup(void)
@@ -0,0 +1,213 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "emul/emul_common_i2c.h"
+#include "emul/i2c_mock.h"
+#include "i2c.h"
+#include "i2c/i2c.h"
+#include "i2c_regcache.h"
+#include "test/drivers/test_state.h"
+
+#include <string.h>
+
+#include <zephyr/device.h>
+#include <zephyr/ztest.h>
+
+#define MOCK_EMUL EMUL_DT_GET(DT_NODELABEL(i2c_mock))
+#define COMMON_DATA emul_i2c_mock_get_i2c_common_data(MOCK_EMUL)
+#define MOCK_PORT I2C_PORT_BY_DEV(DT_NODELABEL(i2c_mock))
+#define MOCK_ADDR i2c_mock_get_addr(MOCK_EMUL)
+
+#define NUM_REGS 16
+#define REG_CTRL 0x01
+#define REG_CONFIG 0x02
+#define REG_STATUS 0x05
+
+static const uint32_t volatile_regs[] = { BIT(REG_STATUS) };
+
+I2C_REGCACHE_DEFINE(test_cache, NUM_REGS, 1, volatile_regs, 0);
+
+/* Register file of the mock */
+static uint8_t regs[NUM_REGS + 2];
+static int bus_reads;
+
+static int mock_read_fn(const struct emul *emul, int reg, uint8_t *val,
+			int bytes, void *data)
+{
+	if (bytes == 0)
+		bus_reads++;
+	*val = regs[reg + bytes];
+	return 0;
+}
+
+static int mock_write_fn(const struct emul *emul, int reg, uint8_t val,
+			 int bytes, void *data)
+{
+	regs[reg + bytes - 1] = val;
+	return 0;
+}
+
+ZTEST(i2c_regcache, test_update_reads_once)
+{
+	int val;
+
+	regs[REG_CTRL] = 0x10;
+
+	zassert_ok(i2c_update8(MOCK_PORT, MOCK_ADDR, REG_CTRL, BIT(0),
+			       MASK_SET));
+	zassert_ok(i2c_field_update8(MOCK_PORT, MOCK_ADDR, REG_CTRL, 0x06,
+				     0x04));
+	zassert_ok(i2c_update8(MOCK_PORT, MOCK_ADDR, REG_CTRL, BIT(4),
+			       MASK_CLR));
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_CTRL, &val));
+
+	zassert_equal(regs[REG_CTRL], 0x05);
+	zassert_equal(val, 0x05);
+	zassert_equal(bus_reads, 1);
+	zassert_equal(test_cache.misses, 1);
+	zassert_equal(test_cache.hits, 3);
+}
+
+ZTEST(i2c_regcache, test_write_then_read)
+{
+	int val;
+
+	zassert_ok(i2c_write8(MOCK_PORT, MOCK_ADDR, REG_CONFIG, 0xa5));
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_CONFIG, &val));
+
+	zassert_equal(val, 0xa5);
+	zassert_equal(bus_reads, 0);
+}
+
+ZTEST(i2c_regcache, test_volatile_not_cached)
+{
+	int val;
+
+	regs[REG_STATUS] = 1;
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_STATUS, &val));
+	zassert_equal(val, 1);
+
+	regs[REG_STATUS] = 2;
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_STATUS, &val));
+	zassert_equal(val, 2);
+
+	zassert_equal(bus_reads, 2);
+	zassert_equal(test_cache.hits + test_cache.misses, 0);
+}
+
+ZTEST(i2c_regcache, test_other_size_not_cached)
+{
+	int val;
+
+	regs[REG_CTRL] = 0x34;
+	regs[REG_CTRL + 1] = 0x12;
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_CTRL, &val));
+
+	/* A 16-bit read goes to the bus. */
+	zassert_ok(i2c_read16(MOCK_PORT, MOCK_ADDR, REG_CTRL, &val));
+	zassert_equal(val, 0x1234);
+	zassert_equal(bus_reads, 2);
+
+	/* A 16-bit write invalidates both registers it wrote. */
+	zassert_ok(i2c_write16(MOCK_PORT, MOCK_ADDR, REG_CTRL, 0x5678));
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_CTRL, &val));
+	zassert_equal(val, 0x78);
+	zassert_equal(bus_reads, 3);
+}
+
+ZTEST(i2c_regcache, test_failed_write_invalidates)
+{
+	int val;
+
+	regs[REG_CTRL] = 0x10;
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_CTRL, &val));
+
+	i2c_common_emul_set_write_fail_reg(COMMON_DATA,
+					   I2C_COMMON_EMUL_FAIL_ALL_REG);
+	zassert_not_equal(i2c_write8(MOCK_PORT, MOCK_ADDR, REG_CTRL, 0x20),
+			  EC_SUCCESS);
+	i2c_common_emul_set_write_fail_reg(COMMON_DATA,
+					   I2C_COMMON_EMUL_NO_FAIL_REG);
+
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_CTRL, &val));
+	zassert_equal(val, 0x10);
+	zassert_equal(bus_reads, 2);
+}
+
+ZTEST(i2c_regcache, test_invalidate)
+{
+	int val;
+
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_CTRL, &val));
+
+	/* The peripheral was reset. */
+	regs[REG_CTRL] = 0x42;
+	i2c_regcache_invalidate(&test_cache);
+
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_CTRL, &val));
+	zassert_equal(val, 0x42);
+	zassert_equal(bus_reads, 2);
+}
+
+ZTEST(i2c_regcache, test_detach)
+{
+	int val;
+
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_CONFIG, &val));
+	i2c_regcache_detach(&test_cache);
+
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_CONFIG, &val));
+	zassert_equal(bus_reads, 2);
+
+	/* Detaching a cache which is not attached does nothing. */
+	i2c_regcache_detach(&test_cache);
+}
+
+ZTEST(i2c_regcache, test_sync)
+{
+	int val;
+
+	regs[REG_CONFIG] = 0x33;
+	zassert_ok(i2c_write8(MOCK_PORT, MOCK_ADDR, REG_CTRL, 0x81));
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_CONFIG, &val));
+
+	/* The peripheral lost its power. */
+	memset(regs, 0, sizeof(regs));
+	zassert_ok(i2c_regcache_sync(&test_cache));
+
+	/* The register written by the EC is restored... */
+	zassert_equal(regs[REG_CTRL], 0x81);
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_CTRL, &val));
+	zassert_equal(val, 0x81);
+	zassert_equal(bus_reads, 1);
+
+	/* ...and the one it only read is read again. */
+	zassert_ok(i2c_read8(MOCK_PORT, MOCK_ADDR, REG_CONFIG, &val));
+	zassert_equal(val, 0);
+	zassert_equal(bus_reads, 2);
+}
+
+static void i2c_regcache_before(void *fixture)
+{
+	i2c_mock_reset(MOCK_EMUL);
+	i2c_common_emul_set_read_func(COMMON_DATA, mock_read_fn, NULL);
+	i2c_common_emul_set_write_func(COMMON_DATA, mock_write_fn, NULL);
+	memset(regs, 0, sizeof(regs));
+	bus_reads = 0;
+
+	i2c_regcache_attach(&test_cache, MOCK_PORT, MOCK_ADDR);
+	test_cache.hits = 0;
+	test_cache.misses = 0;
+}
+
+static void i2c_regcache_after(void *fixture)
+{
+	/* Stop caching the mock, for the other suites. */
+	i2c_regcache_detach(&test_cache);
+	i2c_common_emul_set_read_func(COMMON_DATA, NULL, NULL);
+	i2c_common_emul_set_write_func(COMMON_DATA, NULL, NULL);
+}
+
+ZTEST_SUITE(i2c_regcache, drivers_predicate_post_main, NULL,
+	    i2c_regcache_before, i2c_regcache_after, NULL);
@@ -0,0 +1,187 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "ec_commands.h"
+#include "emul/emul_common_i2c.h"
+#include "emul/i2c_mock.h"
+#include "host_command.h"
+#include "i2c.h"
+#include "i2c/i2c.h"
+#include "test/drivers/test_state.h"
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#define MOCK_EMUL EMUL_DT_GET(DT_NODELABEL(i2c_mock))
+#define COMMON_DATA emul_i2c_mock_get_i2c_common_data(MOCK_EMUL)
+#define MOCK_PORT I2C_PORT_BY_DEV(DT_NODELABEL(i2c_mock))
+#define MOCK_ADDR i2c_mock_get_addr(MOCK_EMUL)
+
+static int i2c_stats(uint8_t cmd, uint8_t index,
+		     struct ec_response_i2c_stats *response)
+{
+	struct ec_params_i2c_stats params = {
+		.cmd = cmd,
+		.index = index,
+	};
+	struct host_cmd_handler_args args =
+		BUILD_HOST_COMMAND(EC_CMD_I2C_STATS, 0, *response, params);
+
+	return host_command_process(&args);
+}
+
+/* Get the statistics of the mock peripheral. */
+static void get_mock_stats(struct ec_response_i2c_stats *r)
+{
+	for (int i = 0;; i++) {
+		zassert_ok(i2c_stats(EC_I2C_STATS_GET_ADDR, i, r));
+		zassert_true(i < r->count, "mock address not found");
+		if (r->port == MOCK_PORT && r->addr == MOCK_ADDR)
+			return;
+	}
+}
+
+static uint32_t hist_sum(const struct ec_i2c_stats *s)
+{
+	uint32_t sum = 0;
+
+	for (int i = 0; i < EC_I2C_STATS_HIST_BUCKETS; i++)
+		sum += s->hist[i];
+	return sum;
+}
+
+ZTEST(i2c_stats, test_xfer)
+{
+	const uint8_t out[] = { 0x12, 0x34 };
+	uint8_t in[3];
+	struct ec_response_i2c_stats r;
+
+	zassert_ok(i2c_xfer(MOCK_PORT, MOCK_ADDR, out, sizeof(out), NULL, 0));
+	zassert_ok(i2c_xfer(MOCK_PORT, MOCK_ADDR, out, 1, in, sizeof(in)));
+
+	get_mock_stats(&r);
+	zassert_equal(r.stats.xfers, 2);
+	zassert_equal(r.stats.errors, 0);
+	zassert_equal(r.stats.nacks, 0);
+	zassert_equal(r.stats.retries, 0);
+	zassert_equal(r.stats.bytes_out, 3);
+	zassert_equal(r.stats.bytes_in, 3);
+	zassert_equal(hist_sum(&r.stats), 2);
+	zassert_equal(r.stats.lock_wait_us, 0);
+
+	/* The port statistics include the transfers to the mock. */
+	zassert_ok(i2c_stats(EC_I2C_STATS_GET_PORT, MOCK_PORT, &r));
+	zassert_true(MOCK_PORT < r.count);
+	zassert_equal(r.port, MOCK_PORT);
+	zassert_equal(r.addr, EC_I2C_STATS_NO_ADDR);
+	zassert_true(r.stats.xfers >= 2);
+	zassert_true(r.stats.bytes_out >= 3);
+}
+
+ZTEST(i2c_stats, test_nack)
+{
+	const uint8_t out[] = { 0x12, 0x34 };
+	struct ec_response_i2c_stats r;
+
+	i2c_common_emul_set_write_fail_reg(COMMON_DATA,
+					   I2C_COMMON_EMUL_FAIL_ALL_REG);
+	zassert_not_equal(
+		i2c_xfer(MOCK_PORT, MOCK_ADDR, out, sizeof(out), NULL, 0),
+		EC_SUCCESS);
+
+	get_mock_stats(&r);
+	zassert_equal(r.stats.xfers, 1);
+	zassert_equal(r.stats.errors, 1);
+	zassert_equal(r.stats.nacks, CONFIG_I2C_NACK_RETRY_COUNT + 1);
+	zassert_equal(r.stats.retries, CONFIG_I2C_NACK_RETRY_COUNT);
+}
+
+ZTEST(i2c_stats, test_vec)
+{
+	const uint8_t reg_a = 0x10, reg_b = 0x20;
+	uint8_t val_a[2], val_b;
+	const struct i2c_xfer_seg segs[] = {
+		{ .out = &reg_a, .out_size = 1, .in = val_a, .in_size = 2 },
+		{ .out = &reg_b, .out_size = 1, .in = &val_b, .in_size = 1 },
+	};
+	struct ec_response_i2c_stats r;
+
+	zassert_ok(i2c_xfer_vec(MOCK_PORT, MOCK_ADDR, segs, ARRAY_SIZE(segs)));
+
+	get_mock_stats(&r);
+	zassert_equal(r.stats.xfers, 1);
+	zassert_equal(r.stats.bytes_out, 2);
+	zassert_equal(r.stats.bytes_in, 3);
+}
+
+ZTEST(i2c_stats, test_reset)
+{
+	const uint8_t out[] = { 0x12 };
+	struct ec_response_i2c_stats r;
+
+	zassert_ok(i2c_xfer(MOCK_PORT, MOCK_ADDR, out, sizeof(out), NULL, 0));
+	zassert_ok(i2c_stats(EC_I2C_STATS_RESET, 0, &r));
+
+	zassert_ok(i2c_stats(EC_I2C_STATS_GET_ADDR, 0, &r));
+	zassert_equal(r.count, 0);
+	zassert_ok(i2c_stats(EC_I2C_STATS_GET_PORT, MOCK_PORT, &r));
+	zassert_equal(r.stats.xfers, 0);
+}
+
+ZTEST(i2c_stats, test_reset_no_response)
+{
+	const uint8_t out[] = { 0x12 };
+	struct ec_params_i2c_stats params = {
+		.cmd = EC_I2C_STATS_RESET,
+	};
+	struct host_cmd_handler_args args =
+		BUILD_HOST_COMMAND_PARAMS(EC_CMD_I2C_STATS, 0, params);
+	struct ec_response_i2c_stats r;
+
+	/* As ectool sends it, without room for a response. */
+	zassert_ok(i2c_xfer(MOCK_PORT, MOCK_ADDR, out, sizeof(out), NULL, 0));
+	zassert_ok(host_command_process(&args));
+	zassert_equal(args.response_size, 0);
+
+	zassert_ok(i2c_stats(EC_I2C_STATS_GET_ADDR, 0, &r));
+	zassert_equal(r.count, 0);
+}
+
+ZTEST(i2c_stats, test_invalid_cmd)
+{
+	struct ec_response_i2c_stats r;
+
+	zassert_equal(i2c_stats(0xff, 0, &r), EC_RES_INVALID_PARAM);
+}
+
+ZTEST(i2c_stats, test_elapsed)
+{
+	struct ec_response_i2c_stats r;
+
+	k_msleep(50);
+	zassert_ok(i2c_stats(EC_I2C_STATS_GET_PORT, MOCK_PORT, &r));
+	zassert_between_inclusive(r.elapsed_ms, 50, 1000);
+
+	zassert_ok(i2c_stats(EC_I2C_STATS_RESET, 0, &r));
+	zassert_ok(i2c_stats(EC_I2C_STATS_GET_PORT, MOCK_PORT, &r));
+	zassert_true(r.elapsed_ms < 50, "elapsed %u ms", r.elapsed_ms);
+}
+
+static void i2c_stats_before(void *fixture)
+{
+	struct ec_response_i2c_stats r;
+
+	i2c_mock_reset(MOCK_EMUL);
+	zassert_ok(i2c_stats(EC_I2C_STATS_RESET, 0, &r));
+}
+
+static void i2c_stats_after(void *fixture)
+{
+	i2c_common_emul_set_write_fail_reg(COMMON_DATA,
+					   I2C_COMMON_EMUL_NO_FAIL_REG);
+}
+
+ZTEST_SUITE(i2c_stats, drivers_predicate_post_main, NULL, i2c_stats_before,
+	    i2c_stats_after, NULL);
@@ -0,0 +1,181 @@
+/* Copyright 2026 The ChromiumOS Authors
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "console.h"
+#include "ec_commands.h"
+#include "emul/emul_common_i2c.h"
+#include "emul/i2c_mock.h"
+#include "host_command.h"
+#include "i2c.h"
+#include "i2c/i2c.h"
+#include "test/drivers/test_state.h"
+
+#include <stdio.h>
+
+#include <zephyr/device.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/ztest.h>
+
+#define MOCK_EMUL EMUL_DT_GET(DT_NODELABEL(i2c_mock))
+#define COMMON_DATA emul_i2c_mock_get_i2c_common_data(MOCK_EMUL)
+#define MOCK_PORT I2C_PORT_BY_DEV(DT_NODELABEL(i2c_mock))
+#define MOCK_ADDR i2c_mock_get_addr(MOCK_EMUL)
+
+static uint8_t response_buf[sizeof(struct ec_response_i2c_trace_read) +
+			    8 * sizeof(struct ec_i2c_trace_record)];
+static struct ec_response_i2c_trace_read *response =
+	(struct ec_response_i2c_trace_read *)response_buf;
+
+static int trace_read(void)
+{
+	struct host_cmd_handler_args args =
+		BUILD_HOST_COMMAND_SIMPLE(EC_CMD_I2C_TRACE_READ, 0);
+
+	args.response = response_buf;
+	args.response_max = sizeof(response_buf);
+	zassert_ok(host_command_process(&args));
+	zassert_equal(args.response_size,
+		      sizeof(*response) +
+			      response->count * sizeof(response->records[0]));
+
+	return response->count;
+}
+
+static int mock_read_fn(const struct emul *emul, int reg, uint8_t *val,
+			int bytes, void *data)
+{
+	*val = 0xa0 + bytes;
+	return 0;
+}
+
+ZTEST(i2c_trace, test_write_read)
+{
+	const uint8_t out[] = { 0x12 };
+	uint8_t in[3];
+	struct ec_i2c_trace_record *rec = &response->records[0];
+
+	zassert_ok(i2c_xfer(MOCK_PORT, MOCK_ADDR, out, sizeof(out), in,
+			    sizeof(in)));
+
+	zassert_equal(trace_read(), 1);
+	zassert_equal(response->lost, 0);
+	zassert_equal(rec->port, MOCK_PORT);
+	zassert_equal(rec->addr, MOCK_ADDR);
+	zassert_equal(rec->out_size, 1);
+	zassert_equal(rec->in_size, 3);
+	zassert_equal(rec->result, EC_SUCCESS);
+	zassert_equal(rec->data[0], 0x12);
+	zassert_mem_equal(&rec->data[1], in, sizeof(in));
+
+	/* The records were removed. */
+	zassert_equal(trace_read(), 0);
+}
+
+ZTEST(i2c_trace, test_vec)
+{
+	const uint8_t reg_a = 0x10, reg_b = 0x20;
+	uint8_t val_a[2], val_b;
+	const struct i2c_xfer_seg segs[] = {
+		{ .out = &reg_a, .out_size = 1, .in = val_a, .in_size = 2 },
+		{ .out = &reg_b, .out_size = 1, .in = &val_b, .in_size = 1 },
+	};
+	struct ec_i2c_trace_record *rec = &response->records[0];
+
+	zassert_ok(i2c_xfer_vec(MOCK_PORT, MOCK_ADDR, segs, ARRAY_SIZE(segs)));
+
+	/* One record for the whole transaction. */
+	zassert_equal(trace_read(), 1);
+	zassert_equal(rec->out_size, 2);
+	zassert_equal(rec->in_size, 3);
+	zassert_equal(rec->result, EC_SUCCESS);
+	zassert_equal(rec->data[0], reg_a);
+	zassert_equal(rec->data[1], reg_b);
+	zassert_mem_equal(&rec->data[2], val_a, sizeof(val_a));
+	zassert_equal(rec->data[4], val_b);
+}
+
+ZTEST(i2c_trace, test_long_write)
+{
+	uint8_t out[EC_I2C_TRACE_DATA_SIZE + 4];
+	struct ec_i2c_trace_record *rec = &response->records[0];
+
+	for (int i = 0; i < sizeof(out); i++)
+		out[i] = i;
+	zassert_ok(i2c_xfer(MOCK_PORT, MOCK_ADDR, out, sizeof(out), NULL, 0));
+
+	zassert_equal(trace_read(), 1);
+	zassert_equal(rec->out_size, sizeof(out));
+	zassert_equal(rec->in_size, 0);
+	zassert_mem_equal(rec->data, out, EC_I2C_TRACE_DATA_SIZE);
+}
+
+ZTEST(i2c_trace, test_error)
+{
+	const uint8_t out[] = { 0x12, 0x34 };
+
+	i2c_common_emul_set_write_fail_reg(COMMON_DATA,
+					   I2C_COMMON_EMUL_FAIL_ALL_REG);
+	zassert_not_equal(
+		i2c_xfer(MOCK_PORT, MOCK_ADDR, out, sizeof(out), NULL, 0),
+		EC_SUCCESS);
+
+	zassert_true(trace_read() > 0);
+	zassert_not_equal(response->records[0].result, EC_SUCCESS);
+	zassert_equal(response->records[0].out_size, sizeof(out));
+}
+
+ZTEST(i2c_trace, test_full)
+{
+	const uint8_t out[] = { 0x12 };
+	int total = 0, count;
+
+	for (int i = 0; i < CONFIG_I2C_TRACE_SIZE + 3; i++)
+		zassert_ok(i2c_xfer(MOCK_PORT, MOCK_ADDR, out, sizeof(out),
+				    NULL, 0));
+
+	/* The oldest records were dropped, and counted once. */
+	zassert_true(trace_read() > 0);
+	zassert_equal(response->lost, 3);
+	total = response->count;
+	while ((count = trace_read()) > 0) {
+		zassert_equal(response->lost, 0);
+		total += count;
+	}
+	zassert_equal(total, CONFIG_I2C_TRACE_SIZE);
+}
+
+ZTEST(i2c_trace, test_other_address_not_traced)
+{
+	const uint8_t out[] = { 0x12 };
+
+	zassert_ok(shell_execute_cmd(get_ec_shell(), "i2ctrace disable 0"));
+	zassert_ok(i2c_xfer(MOCK_PORT, MOCK_ADDR, out, sizeof(out), NULL, 0));
+
+	zassert_equal(trace_read(), 0);
+}
+
+static void i2c_trace_before(void *fixture)
+{
+	char cmd[32];
+
+	i2c_mock_reset(MOCK_EMUL);
+	i2c_common_emul_set_read_func(COMMON_DATA, mock_read_fn, NULL);
+
+	snprintf(cmd, sizeof(cmd), "i2ctrace enable %d 0x%x", MOCK_PORT,
+		 MOCK_ADDR);
+	zassert_ok(shell_execute_cmd(get_ec_shell(), cmd));
+	while (trace_read())
+		;
+}
+
+static void i2c_trace_after(void *fixture)
+{
+	shell_execute_cmd(get_ec_shell(), "i2ctrace disable 0");
+	i2c_common_emul_set_read_func(COMMON_DATA, NULL, NULL);
+	i2c_common_emul_set_write_fail_reg(COMMON_DATA,
+					   I2C_COMMON_EMUL_NO_FAIL_REG);
+}
+
+ZTEST_SUITE(i2c_trace, drivers_predicate_post_main, NULL, i2c_trace_before,
+	    i2c_trace_after, NULL);
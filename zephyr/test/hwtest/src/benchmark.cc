@@ -135,3 +135,82 @@ ZTEST(benchmark, test_min_max_time)
 
 	benchmark.print_results();
 }
+
+ZTEST(benchmark, test_warmup_iterations)
+{
+	Benchmark benchmark({ .num_iterations = 5, .num_warmup_iterations = 2 });
+	int num_calls = 0;
+
+	auto result = benchmark.run("call_counter", [&] { ++num_calls; });
+	zassert_true(result.has_value());
+	zassert_equal(num_calls, 7);
+}
+
+ZTEST(benchmark, test_percentile_math)
+{
+	const uint32_t ten[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+	uint32_t hundred[100];
+	const uint32_t one[] = { 42 };
+
+	for (int i = 0; i < 100; i++)
+		hundred[i] = i + 1;
+
+	// Nearest rank: the smallest sample with at least p% of the samples
+	// at or below it.
+	zassert_equal(Benchmark<>::percentile(ten, 10, 50), 5U);
+	zassert_equal(Benchmark<>::percentile(ten, 10, 99), 10U);
+	zassert_equal(Benchmark<>::percentile(ten, 10, 10), 1U);
+	zassert_equal(Benchmark<>::percentile(ten, 10, 11), 2U);
+	zassert_equal(Benchmark<>::percentile(hundred, 100, 50), 50U);
+	zassert_equal(Benchmark<>::percentile(hundred, 100, 99), 99U);
+	zassert_equal(Benchmark<>::percentile(hundred, 100, 100), 100U);
+	zassert_equal(Benchmark<>::percentile(one, 1, 50), 42U);
+	zassert_equal(Benchmark<>::percentile(one, 1, 99), 42U);
+}
+
+ZTEST(benchmark, test_percentiles)
+{
+	// Ten iterations of 1ms, except for a single 4ms outlier
+	Benchmark<1, 10> benchmark({ .num_iterations = 10 });
+	int iteration = 0;
+
+	auto result = benchmark.run("delay", [&iteration] {
+		k_busy_wait(iteration++ == 3 ? 4000 : 1000);
+	});
+	zassert_true(result.has_value());
+
+	// The percentiles come from the same clock as the minimum and the
+	// maximum, and p99 of ten samples is the largest one.
+	zassert_equal(result->num_samples, 10U);
+	zassert_true(result->min_time <= result->median_time);
+	zassert_true(result->median_time <= result->p99_time);
+	zassert_equal(result->p99_time, result->max_time);
+	zassert_true(result->min_cycles <= result->median_cycles);
+	zassert_equal(result->p99_cycles, result->max_cycles);
+
+	// Delays only get longer, by interrupts, so the bounds are loose.
+	zassert_true(result->median_time >= 900U);
+	zassert_true(result->median_time <= 2000U);
+	zassert_true(result->p99_time >= 3600U);
+
+	benchmark.print_results();
+}
+
+ZTEST(benchmark, test_cycle_counter)
+{
+	Benchmark benchmark({ .num_iterations = 3 });
+
+	auto short_result = benchmark.run("delay_1ms",
+					  [] { k_busy_wait(1000); });
+	auto long_result = benchmark.run("delay_4ms",
+					 [] { k_busy_wait(4000); });
+	zassert_true(short_result.has_value());
+	zassert_true(long_result.has_value());
+	zassert_not_equal(short_result->cycle_frequency, 0U);
+
+	// Interrupts and clock changes only make an iteration longer, so
+	// only check a loose lower bound and the ordering.
+	uint32_t cycles_per_ms = short_result->cycle_frequency / 1000;
+	zassert_true(short_result->min_cycles >= cycles_per_ms / 2);
+	zassert_true(long_result->min_cycles > short_result->max_cycles);
+}